@@ -0,0 +1,124 @@
+# Builds the perfect hash of the property names in fieldMap that SpaProperties::findField(name)
+# uses, and writes it to lib/SpaInterface/SpaNameIndex.h.  Run before every build, so the table
+# can't fall behind fieldMap, and the build stops if the names can't be given a slot each.
+#
+# Can also be run on its own: python3 gen_name_index.py
+
+import os
+import re
+import sys
+
+SOURCE = os.path.join("lib", "SpaInterface", "SpaProperties.cpp")
+OUTPUT = os.path.join("lib", "SpaInterface", "SpaNameIndex.h")
+
+# These and name_hash() must match the lookup in SpaProperties.cpp
+BUCKETS = 64
+SLOTS = 256
+NO_ROW = 0xff
+
+
+def name_hash(name, seed):
+    # FNV-1a from a seeded basis, then mixed so the low bits used for the slot depend on every character
+    h = ((2166136261 ^ seed) * 16777619) & 0xffffffff
+    for c in name.encode("ascii"):
+        h = ((h ^ c) * 16777619) & 0xffffffff
+    h ^= h >> 15
+    h = (h * 0x2c1b3c6d) & 0xffffffff
+    h ^= h >> 12
+    return h
+
+
+def read_names(root):
+    with open(os.path.join(root, SOURCE)) as f:
+        source = f.read()
+    table = re.search(r"fieldMap\[\] = \{(.*?)^\};", source, re.S | re.M)
+    if table is None:
+        raise ValueError("fieldMap not found in " + SOURCE)
+    return re.findall(r'^\s*\{ "(\w+)",', table.group(1), re.M)
+
+
+def build(names):
+    """Hash and displace: the first hash of a name picks a bucket, and each bucket has the seed of a
+    second hash that gives every name in it a slot of its own."""
+    if len(names) >= NO_ROW:
+        raise ValueError("%d rows in fieldMap, slotRow holds fewer than %d" % (len(names), NO_ROW))
+    if len(set(names)) != len(names):
+        raise ValueError("fieldMap has a name twice")
+
+    buckets = [[] for _ in range(BUCKETS)]
+    for row, name in enumerate(names):
+        buckets[name_hash(name, 0) % BUCKETS].append(row)
+
+    seeds = [0] * BUCKETS
+    slots = [NO_ROW] * SLOTS
+    # The fullest buckets are placed first, while there is most room
+    for b in sorted(range(BUCKETS), key=lambda b: -len(buckets[b])):
+        if not buckets[b]:
+            continue
+        for seed in range(1, 256):
+            wanted = [name_hash(names[row], seed) % SLOTS for row in buckets[b]]
+            if len(set(wanted)) == len(wanted) and all(slots[s] == NO_ROW for s in wanted):
+                for row, s in zip(buckets[b], wanted):
+                    slots[s] = row
+                seeds[b] = seed
+                break
+        else:
+            raise ValueError("no seed places the names " + ", ".join(names[row] for row in buckets[b]))
+    return seeds, slots
+
+
+def table(values):
+    return ",\n".join("    " + ", ".join("%3d" % v for v in values[i:i + 16]) for i in range(0, len(values), 16))
+
+
+def write(root, names, seeds, slots):
+    text = (
+        "// Generated by gen_name_index.py from the names in fieldMap, don't edit.\n"
+        "#pragma once\n"
+        "\n"
+        "#include <stdint.h>\n"
+        "\n"
+        "namespace SpaNameIndex {\n"
+        "    const int rows = %d;\n"
+        "    const int buckets = %d;\n"
+        "    const int slots = %d;\n"
+        "    const uint8_t noRow = 0x%x;\n"
+        "\n"
+        "    /// @brief Seed of the second hash for each bucket.\n"
+        "    const uint8_t bucketSeed[buckets] = {\n%s\n    };\n"
+        "\n"
+        "    /// @brief Row of fieldMap in each slot, noRow if there is none.\n"
+        "    const uint8_t slotRow[slots] = {\n%s\n    };\n"
+        "}\n"
+    ) % (len(names), BUCKETS, SLOTS, NO_ROW, table(seeds), table(slots))
+
+    # Left alone when unchanged, so it doesn't rebuild everything that includes it
+    output = os.path.join(root, OUTPUT)
+    if os.path.exists(output):
+        with open(output) as f:
+            if f.read() == text:
+                return
+    with open(output, "w") as f:
+        f.write(text)
+
+
+def generate(root):
+    names = read_names(root)
+    seeds, slots = build(names)
+    write(root, names, seeds, slots)
+
+
+try:
+    Import("env")
+    root = env.subst("$PROJECT_DIR")
+except NameError:
+    env = None
+    root = os.path.dirname(os.path.abspath(sys.argv[0]))
+
+try:
+    generate(root)
+except ValueError as e:
+    print("gen_name_index.py: " + str(e), file=sys.stderr)
+    if env is not None:
+        env.Exit(1)
+    sys.exit(1)
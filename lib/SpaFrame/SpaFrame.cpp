@@ -0,0 +1,74 @@
+#include "SpaFrame.h"
+#include <limits.h>
+
+size_t SpaField::copyTo(char *buffer, size_t size) const {
+    if (size == 0) return 0;
+    size_t l = length < size - 1 ? length : size - 1;
+    memcpy(buffer, data, l);
+    buffer[l] = '\0';
+    return l;
+}
+
+bool SpaField::parseNumber(long &value, int scale) const {
+    size_t i = 0;
+    bool negative = i < length && data[i] == '-';
+    if (negative) i++;
+
+    long whole = 0;
+    bool digits = false;
+    for (; i < length && data[i] >= '0' && data[i] <= '9'; i++) {
+        if (whole > (LONG_MAX - 9) / 10) {
+            return false; // Too big for a long, no field of the spa's is anywhere near
+        }
+        whole = whole * 10 + (data[i] - '0');
+        digits = true;
+    }
+    if (i < length && data[i] == '.') {
+        for (i++; i < length && data[i] >= '0' && data[i] <= '9'; i++) {
+            digits = true;
+        }
+    }
+    if (!digits || i != length) {
+        return false;
+    }
+
+    value = (negative ? -whole : whole) / scale;
+    return true;
+}
+
+void SpaFrame::clear() {
+    _length = 0;
+    _fieldCount = 0;
+    _buffer[0] = '\0';
+}
+
+bool SpaFrame::addField(size_t length) {
+    if (_fieldCount >= maxFields || length > space()) {
+        return false;
+    }
+
+    _fieldOffset[_fieldCount] = _length;
+    _fieldLength[_fieldCount] = length;
+    _fieldCount++;
+
+    _length += length;
+    _buffer[_length++] = ',';
+    _buffer[_length] = '\0';
+    return true;
+}
+
+bool SpaFrame::append(char c) {
+    if (_length >= maxLength) {
+        return false;
+    }
+    _buffer[_length++] = c;
+    _buffer[_length] = '\0';
+    return true;
+}
+
+SpaField SpaFrame::field(int index) const {
+    if (index < 0 || index >= _fieldCount) {
+        return SpaField();
+    }
+    return SpaField(&_buffer[_fieldOffset[index]], _fieldLength[index]);
+}
@@ -0,0 +1,98 @@
+#ifndef SPAFRAME_H
+#define SPAFRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// @brief A single field of the RF response, referenced in place within the frame buffer.
+///
+/// A field is always followed by a ',' or '\0' in memory, so the numeric conversions
+/// can safely run off the end of the span without a copy.
+struct SpaField {
+    const char *data = "";
+    uint16_t length = 0;
+
+    SpaField() {}
+    SpaField(const char *d, uint16_t l) : data(d), length(l) {}
+    /// @brief Wrap a null terminated string (eg for the optimistic updates in the set methods).
+    SpaField(const char *s) : data(s), length(strlen(s)) {}
+
+    bool isEmpty() const { return length == 0; }
+    char operator[](size_t i) const { return i < length ? data[i] : '\0'; }
+
+    bool equals(const char *s) const { return strncmp(data, s, length) == 0 && s[length] == '\0'; }
+    bool startsWith(const char *s) const {
+        size_t l = strlen(s);
+        return l <= length && strncmp(data, s, l) == 0;
+    }
+
+    long toInt() const { return atol(data); }
+    float toFloat() const { return atof(data); }
+
+    /// @brief Check the field is a decimal number (eg "-12.5") and convert it, in a single pass over the span.
+    /// Any digits after the decimal point are checked but dropped, as toInt() does.
+    ///
+    /// Dividing by scale truncates towards zero.  That is what the properties have always held: the
+    /// scaled fields were converted with toFloat() / scale into an int, which truncates the same way, and
+    /// for a whole number w and fraction f < 1, (w + f) / scale and w / scale truncate to the same value.
+    /// @param value set to the whole part of the number divided by scale, only if the field is a number
+    /// @param scale fixed point scale of the field, eg 10 for a field in tenths
+    /// @return false if the field is empty, not a number, or too big for a long
+    bool parseNumber(long &value, int scale = 1) const;
+
+    /// @brief Copy the field into a null terminated buffer, truncating if required.
+    /// @return number of characters copied
+    size_t copyTo(char *buffer, size_t size) const;
+};
+
+/// @brief Fixed size store for a complete RF response.
+///
+/// The raw response text is held in a single byte buffer and each comma separated
+/// field is indexed by an (offset, length) span into that buffer, so reading and
+/// decoding a frame does not touch the heap.
+class SpaFrame {
+    public:
+        /// @brief Maximum number of fields we will index in a single response.
+        static const int maxFields = 300;
+        /// @brief Size of the raw response buffer. A full RF response is around 1.5KB.
+        static const size_t maxLength = 2048;
+
+        SpaFrame() { clear(); }
+
+        /// @brief Discard the current contents.
+        void clear();
+
+        /// @brief Pointer to the next free byte in the buffer, used to read a field straight into the frame.
+        char *tail() { return &_buffer[_length]; }
+
+        /// @brief Number of bytes that can be written at tail() and still be committed as a field.
+        size_t space() const { return _length + 1 < maxLength ? maxLength - _length - 1 : 0; }
+
+        /// @brief Commit length bytes written at tail() as the next field.  A ',' separator is appended.
+        /// @return false if the field table or buffer is full.
+        bool addField(size_t length);
+
+        /// @brief Append a byte to the raw response that is not part of an indexed field (eg trailing data).
+        /// @return false if the buffer is full and the byte was discarded.
+        bool append(char c);
+
+        int fieldCount() const { return _fieldCount; }
+
+        /// @brief Get a field by index. Returns an empty field if the index is out of range.
+        SpaField field(int index) const;
+
+        /// @brief Complete raw response as a null terminated string.
+        const char *c_str() const { return _buffer; }
+        size_t length() const { return _length; }
+
+    private:
+        char _buffer[maxLength + 1];
+        uint16_t _fieldOffset[maxFields];
+        uint16_t _fieldLength[maxFields];
+        size_t _length = 0;
+        int _fieldCount = 0;
+};
+
+#endif // SPAFRAME_H
@@ -0,0 +1,77 @@
+#include "CommandTiming.h"
+#include <algorithm>
+
+int CommandTiming::wakeGap() const {
+    return _fallback ? conservativeWakeGap : _wakeGap;
+}
+
+int CommandTiming::timeout() const {
+    if (_fallback || _count < minSamples) {
+        return conservativeTimeout;
+    }
+
+    uint16_t slowest = 0;
+    for (int i = 0; i < _count; i++) {
+        slowest = std::max(slowest, _latency[i]);
+    }
+
+    // Twice the slowest recent reply, with a little margin for the bus task being woken: the UART driver
+    // only passes the reply on once the line has been quiet, through its event task, and the wait is in
+    // whole RTOS ticks.
+    return constrain(slowest * 2 + 20, minTimeout, conservativeTimeout);
+}
+
+void CommandTiming::success(unsigned long latency) {
+    _latency[_next] = std::min(latency, (unsigned long)UINT16_MAX);
+    _next = (_next + 1) % maxSamples;
+    if (_count < maxSamples) _count++;
+
+    // A long run without a failure may mean whatever caused the last one has gone, so let the gap
+    // come down a step further.
+    if (++_successRun >= successesToRetryGap) {
+        _successRun = 0;
+        _unsafeWakeGap = std::max(_unsafeWakeGap - wakeGapStep, -1);
+    }
+
+    if (_fallback) {
+        // Back to where we were before the failure, but no lower than the last gap that failed.
+        _fallback = false;
+        _successes = 0;
+        return;
+    }
+
+    if (++_successes >= successesPerStep) {
+        _successes = 0;
+        int gap = _wakeGap - wakeGapStep;
+        if (gap >= 0 && gap > _unsafeWakeGap) {
+            _wakeGap = gap;
+        }
+    }
+}
+
+void CommandTiming::failure() {
+    _failures++;
+    _successes = 0;
+    _successRun = 0;
+
+    if (!_fallback) {
+        // The learnt timings were in use, so don't trust this wake up gap again.
+        _unsafeWakeGap = std::max(_unsafeWakeGap, _wakeGap);
+        _wakeGap = std::min(_unsafeWakeGap + wakeGapStep, (int)conservativeWakeGap);
+    }
+    _fallback = true;
+}
+
+int CommandTiming::percentile(int p) const {
+    if (_count == 0) {
+        return -1;
+    }
+
+    uint16_t sorted[maxSamples];
+    memcpy(sorted, _latency, _count * sizeof(uint16_t));
+    std::sort(sorted, sorted + _count);
+
+    // Nearest rank
+    int rank = (p * _count + 99) / 100;
+    return sorted[constrain(rank, 1, _count) - 1];
+}
@@ -0,0 +1,77 @@
+#ifndef COMMANDTIMING_H
+#define COMMANDTIMING_H
+
+#include <Arduino.h>
+
+/// @brief Learns the timing the SpaNet controller needs for one class of command (RF, Sxx or Wxx).
+///
+/// Every command starts with a wake up ('\n') and a pause before the command is sent, then waits
+/// for the first byte of the reply.  Both were fixed at 50ms and 1 sec.  This keeps the latency of
+/// recent replies and uses it to bring the wake up gap down to the smallest value that has not
+/// failed, and the timeout down to a safe multiple of the slowest recent reply.  After a failure the
+/// next command goes back to the conservative values.
+///
+/// Only a missing reply is a failure here.  A reply that arrived but was wrong says nothing about the
+/// timing, so it isn't recorded.
+class CommandTiming {
+    public:
+        /// @brief Conservative timings (ms), used until we have learnt better and after any failure.
+        static const int conservativeWakeGap = 50;
+        static const int conservativeTimeout = 1000;
+
+        /// @brief The wake up gap is reduced by wakeGapStep after this many successes in a row.
+        static const int wakeGapStep = 5;
+        static const int successesPerStep = 4;
+
+        /// @brief After this many successes in a row, a wake up gap that failed is tried again, one step at a time.
+        static const int successesToRetryGap = 64;
+
+        /// @brief The timeout is never less than this (ms), nor learnt from fewer samples than minSamples.
+        static const int minTimeout = 100;
+        static const int minSamples = 16;
+
+        /// @brief Number of recent replies kept for the latency percentiles.
+        static const int maxSamples = 64;
+
+        CommandTiming(const char *name) : _name(name) {}
+
+        const char *name() const { return _name; }
+
+        /// @brief Time (ms) to wait between the wake up and the command.
+        int wakeGap() const;
+
+        /// @brief Time (ms) to wait for the first byte of the reply.
+        int timeout() const;
+
+        /// @brief Record a good reply.
+        /// @param latency time (ms) from sending the command to the first byte of the reply
+        void success(unsigned long latency);
+
+        /// @brief Record a missing reply.
+        void failure();
+
+        /// @brief Latency (ms) of recent replies at percentile p, or -1 if there have been none.
+        int percentile(int p) const;
+
+        int samples() const { return _count; }
+        int failures() const { return _failures; }
+
+    private:
+        const char *_name;
+
+        uint16_t _latency[maxSamples];
+        int _next = 0;
+        int _count = 0;
+
+        int _wakeGap = conservativeWakeGap;
+        /// @brief Largest wake up gap that has failed, we won't go back down to it until successesToRetryGap.
+        int _unsafeWakeGap = -1;
+        int _successes = 0;
+        /// @brief Successes since the last failure, or since _unsafeWakeGap was last lowered.
+        int _successRun = 0;
+        int _failures = 0;
+        /// @brief Use the conservative timings for the next command.
+        bool _fallback = true;
+};
+
+#endif // COMMANDTIMING_H
@@ -0,0 +1,152 @@
+#include "EnergyMeter.h"
+#include <Preferences.h>
+#include <RemoteDebug.h>
+#include <TimeLib.h>
+
+extern RemoteDebug Debug;
+
+namespace {
+    const char *nvsNamespace = "spa-energy";
+    const char *totalsKey = "totals";
+
+    /// @brief Energy units (W * 10 * ms) in a Wh.
+    const uint64_t unitsPerWh = 10ULL * 3600 * 1000;
+
+    const uint32_t secondsPerDay = 86400;
+}
+
+uint32_t EnergyMeter::Rollup::total() const {
+    uint32_t sum = 0;
+    for (int l = 0; l < numLoads; l++) sum += wh[l];
+    return sum;
+}
+
+const char *EnergyMeter::loadName(Load load) {
+    switch (load) {
+        case HEAT_PUMP: return "heatPump";
+        case HEATER: return "heater";
+        case PUMPS: return "pumps";
+        default: return "other";
+    }
+}
+
+bool EnergyMeter::load() {
+    Preferences preferences;
+    if (!preferences.begin(nvsNamespace, true)) return false;
+
+    Stored stored;
+    bool loaded = preferences.getBytes(totalsKey, &stored, sizeof(stored)) == sizeof(stored) &&
+                  stored.version == storedVersion;
+    preferences.end();
+
+    if (!loaded) return false;
+    _stored = stored;
+    debugI("Loaded energy totals, %u Wh today", _stored.days[0].total());
+    return true;
+}
+
+void EnergyMeter::save(unsigned long ms) {
+    _lastSave = ms;
+
+    Preferences preferences;
+    if (!preferences.begin(nvsNamespace, false)) {
+        debugW("Couldn't open NVS to save the energy totals");
+        return;
+    }
+    _stored.version = storedVersion;
+    if (preferences.putBytes(totalsKey, &_stored, sizeof(_stored)) != sizeof(_stored)) {
+        debugW("Couldn't save the energy totals");
+    } else {
+        _dirty = false;
+        _saves++;
+    }
+    preferences.end();
+}
+
+void EnergyMeter::add(unsigned long ms, time_t spaTime, int power, Load load) {
+    // Until the spa has been read there is no day to count it in
+    if (spaTime == 0) return;
+
+    for (int p = 0; p < numPeriods; p++) roll((Period)p, spaTime);
+
+    if (_started && ms - _lastFrame <= maxGap && _lastPower > 0) {
+        _pending[_lastLoad] += (uint64_t)_lastPower * (ms - _lastFrame);
+        uint32_t wh = _pending[_lastLoad] / unitsPerWh;
+        if (wh > 0) {
+            _pending[_lastLoad] -= wh * unitsPerWh;
+            _stored.lifetime[_lastLoad] += wh;
+            _stored.days[0].wh[_lastLoad] += wh;
+            _stored.weeks[0].wh[_lastLoad] += wh;
+            _stored.months[0].wh[_lastLoad] += wh;
+            _dirty = true;
+        }
+    }
+    _started = true;
+    _lastFrame = ms;
+    _lastPower = power;
+    _lastLoad = load;
+}
+
+void EnergyMeter::saveIfDue(unsigned long ms) {
+    if (_dirty && ms - _lastSave >= ENERGY_SAVE_MINUTES * 60000UL) save(ms);
+}
+
+EnergyMeter::Rollup *EnergyMeter::rollups(Period period) {
+    switch (period) {
+        case DAY: return _stored.days;
+        case WEEK: return _stored.weeks;
+        default: return _stored.months;
+    }
+}
+
+int EnergyMeter::periodCount(Period period) {
+    switch (period) {
+        case DAY: return dayCount;
+        case WEEK: return weekCount;
+        default: return monthCount;
+    }
+}
+
+const EnergyMeter::Rollup *EnergyMeter::rollup(Period period, int age) const {
+    if (age < 0 || age >= rollupCount(period)) return nullptr;
+    return &const_cast<EnergyMeter *>(this)->rollups(period)[age];
+}
+
+int EnergyMeter::rollupCount(Period period) const {
+    const Rollup *r = const_cast<EnergyMeter *>(this)->rollups(period);
+    int count = 0;
+    while (count < periodCount(period) && r[count].start != 0) count++;
+    return count;
+}
+
+uint32_t EnergyMeter::periodStart(Period period, time_t time) {
+    switch (period) {
+        case DAY:
+            return time - time % secondsPerDay;
+        case WEEK: {
+            // 1 Jan 1970 was a Thursday
+            uint32_t days = time / secondsPerDay;
+            return (days - (days + 3) % 7) * secondsPerDay;
+        }
+        default: {
+            tmElements_t tm = {};
+            tm.Year = CalendarYrToTm(year(time));
+            tm.Month = month(time);
+            tm.Day = 1;
+            return makeTime(tm);
+        }
+    }
+}
+
+void EnergyMeter::roll(Period period, time_t time) {
+    Rollup *r = rollups(period);
+    uint32_t start = periodStart(period, time);
+
+    // If the spa's clock is put back, keep counting in the current period rather than reorder them
+    if (r[0].start != 0 && start <= r[0].start) return;
+
+    memmove(&r[1], &r[0], (periodCount(period) - 1) * sizeof(Rollup));
+    r[0] = {};
+    r[0].start = start;
+    _dirty = true;
+}
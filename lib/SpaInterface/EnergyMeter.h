@@ -0,0 +1,116 @@
+#ifndef ENERGYMETER_H
+#define ENERGYMETER_H
+
+#include <Arduino.h>
+
+// Longest time (minutes) energy is held before it is saved to NVS.  Each save writes one blob, so this
+// bounds the flash wear to 24 * 60 / ENERGY_SAVE_MINUTES writes a day.
+#ifndef ENERGY_SAVE_MINUTES
+#define ENERGY_SAVE_MINUTES 15
+#endif
+
+/// @brief Energy used by the spa, integrated from Power between frames, by day, week and month.
+///
+/// Each interval between two frames is charged to the load that was running at the start of it, see
+/// Load, at the power read then.  The spa only reports the total power, so when more than one load is
+/// running all of it goes to the first of them, eg the circulation pump's share of a heating interval
+/// is counted as heater.  An interval longer than maxGap (the spa wasn't being read) is left out rather
+/// than guessed at.
+///
+/// The totals are kept as they go, so reading them never looks back through anything.  They are saved
+/// in NVS every ENERGY_SAVE_MINUTES, and loaded again at boot, so at most that much is lost on a reset.
+/// Periods are by the spa's clock, weeks start on Monday.
+class EnergyMeter {
+    public:
+        /// @brief What the energy of an interval is charged to, the first of these that is running.
+        enum Load : uint8_t { HEAT_PUMP, HEATER, PUMPS, OTHER, numLoads };
+
+        /// @brief Energy over one day, week or month.
+        struct Rollup {
+            /// @brief Spa time of the start of the period, 0 if there is none
+            uint32_t start;
+            /// @brief Wh by Load
+            uint32_t wh[numLoads];
+
+            uint32_t total() const;
+        };
+
+        enum Period : uint8_t { DAY, WEEK, MONTH, numPeriods };
+
+        /// @brief Periods kept, including the current one.
+        static const int dayCount = 8;
+        static const int weekCount = 5;
+        static const int monthCount = 13;
+
+        /// @brief Longest interval (ms) between frames that is counted.
+        static const unsigned long maxGap = 600000;
+
+        /// @brief Load the totals saved in NVS.
+        /// @return false if there were none
+        bool load();
+
+        /// @brief Count the energy since the last frame.
+        /// @param ms millis() now
+        /// @param spaTime the spa's clock
+        /// @param power now (W * 10), which is used until the next frame
+        /// @param load running now
+        void add(unsigned long ms, time_t spaTime, int power, Load load);
+
+        /// @brief Save the totals in NVS if they have changed and ENERGY_SAVE_MINUTES is up.  Kept apart
+        /// from add(), so the flash write can be done outside SpaInterface's update of the properties.
+        /// @param ms millis() now
+        void saveIfDue(unsigned long ms);
+
+        /// @brief A period, 0 for the current one.
+        /// @return nullptr if there is no such period
+        const Rollup *rollup(Period period, int age) const;
+
+        /// @brief Number of periods held, up to dayCount, weekCount or monthCount.
+        int rollupCount(Period period) const;
+
+        /// @brief Wh since the totals were started, by Load.
+        uint32_t lifetime(Load load) const { return _stored.lifetime[load]; }
+
+        /// @brief Times the totals have been saved since boot.
+        unsigned long saves() const { return _saves; }
+
+        static const char *loadName(Load load);
+
+    private:
+        /// @brief Totals as saved in NVS.  The version is changed if this changes.
+        struct Stored {
+            uint8_t version;
+            uint32_t lifetime[numLoads];
+            Rollup days[dayCount];
+            Rollup weeks[weekCount];
+            Rollup months[monthCount];
+        };
+        static const uint8_t storedVersion = 1;
+
+        Stored _stored = {};
+
+        bool _started = false;
+        unsigned long _lastFrame = 0;
+        int _lastPower = 0;
+        Load _lastLoad = OTHER;
+
+        /// @brief Energy (W * 10 * ms) not yet a whole Wh, by Load.
+        uint64_t _pending[numLoads] = {};
+
+        bool _dirty = false;
+        unsigned long _lastSave = 0;
+        unsigned long _saves = 0;
+
+        Rollup *rollups(Period period);
+        static int periodCount(Period period);
+
+        /// @brief Start of the day, week or month a time is in.
+        static uint32_t periodStart(Period period, time_t time);
+
+        /// @brief Start a new period if time is past the current one.
+        void roll(Period period, time_t time);
+
+        void save(unsigned long ms);
+};
+
+#endif // ENERGYMETER_H
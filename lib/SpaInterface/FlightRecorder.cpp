@@ -0,0 +1,84 @@
+#include "FlightRecorder.h"
+
+void FlightRecorder::recordFrame(const SpaFrame &frame, FrameResult result) {
+    size_t length = frame.length();
+
+    portENTER_CRITICAL(&_lock);
+    Frame &slot = _frames[_nextFrame];
+    slot.time = millis();
+    slot.result = result;
+    slot.length = length;
+    memcpy(slot.data, frame.c_str(), length);
+    slot.data[length] = '\0';
+    _nextFrame = (_nextFrame + 1) % maxFrames;
+    if (_frameCount < maxFrames) _frameCount++;
+    portEXIT_CRITICAL(&_lock);
+}
+
+void FlightRecorder::recordCommand(const char *cmd, const char *reply, bool success) {
+    portENTER_CRITICAL(&_lock);
+    Command &slot = _commands[_nextCommand];
+    slot.time = millis();
+    slot.success = success;
+    strlcpy(slot.cmd, cmd, sizeof(slot.cmd));
+    strlcpy(slot.reply, reply, sizeof(slot.reply));
+    _nextCommand = (_nextCommand + 1) % maxCommands;
+    if (_commandCount < maxCommands) _commandCount++;
+    portEXIT_CRITICAL(&_lock);
+}
+
+int FlightRecorder::frameCount() {
+    portENTER_CRITICAL(&_lock);
+    int count = _frameCount;
+    portEXIT_CRITICAL(&_lock);
+    return count;
+}
+
+bool FlightRecorder::getFrame(int age, String &data, unsigned long &time, FrameResult &result) {
+    // Reserve before taking the lock, so nothing is allocated inside the critical section.
+    data = "";
+    data.reserve(SpaFrame::maxLength);
+
+    portENTER_CRITICAL(&_lock);
+    if (age < 0 || age >= _frameCount) {
+        portEXIT_CRITICAL(&_lock);
+        return false;
+    }
+    const Frame &slot = _frames[(_nextFrame - 1 - age + maxFrames) % maxFrames];
+    time = slot.time;
+    result = slot.result;
+    data.concat(slot.data, slot.length);
+    portEXIT_CRITICAL(&_lock);
+    return true;
+}
+
+int FlightRecorder::commandCount() {
+    portENTER_CRITICAL(&_lock);
+    int count = _commandCount;
+    portEXIT_CRITICAL(&_lock);
+    return count;
+}
+
+bool FlightRecorder::getCommand(int age, String &line) {
+    Command command;
+
+    portENTER_CRITICAL(&_lock);
+    if (age < 0 || age >= _commandCount) {
+        portEXIT_CRITICAL(&_lock);
+        return false;
+    }
+    command = _commands[(_nextCommand - 1 - age + maxCommands) % maxCommands];
+    portEXIT_CRITICAL(&_lock);
+
+    line = String(command.time) + " " + command.cmd + " -> " + command.reply + (command.success ? " OK" : " FAILED");
+    return true;
+}
+
+const char *FlightRecorder::resultName(FrameResult result) {
+    switch (result) {
+        case FRAME_VALID: return "valid";
+        case FRAME_INVALID: return "invalid";
+        case FRAME_REPAIRED: return "repaired";
+        default: return "failed";
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef FLIGHTRECORDER_H
+#define FLIGHTRECORDER_H
+
+#include <Arduino.h>
+#include "SpaFrame.h"
+
+#ifndef FLIGHT_RECORDER_FRAMES
+#define FLIGHT_RECORDER_FRAMES 4
+#endif
+
+#ifndef FLIGHT_RECORDER_COMMANDS
+#define FLIGHT_RECORDER_COMMANDS 32
+#endif
+
+/// @brief Keeps the last few raw RF responses, good or bad, and the last commands sent to the
+/// spa with their replies, so an intermittent bad read can be looked at after the fact.
+///
+/// Written by the bus task, read by the web server.  All storage is fixed, recording a frame is
+/// a copy into the oldest slot under a short critical section.
+class FlightRecorder {
+    public:
+        static const int maxFrames = FLIGHT_RECORDER_FRAMES;
+        static const int maxCommands = FLIGHT_RECORDER_COMMANDS;
+
+        /// @brief Outcome of a recorded RF read.
+        enum FrameResult : uint8_t { FRAME_VALID, FRAME_INVALID, FRAME_FAILED, FRAME_REPAIRED };
+
+        /// @brief Record a raw RF response.
+        /// @param result FRAME_FAILED if the read was given up before the end of the response,
+        /// FRAME_REPAIRED if it was used with some registers left out
+        void recordFrame(const SpaFrame &frame, FrameResult result);
+
+        /// @brief Record a command and the reply to it.
+        void recordCommand(const char *cmd, const char *reply, bool success);
+
+        /// @brief Number of frames held, up to maxFrames.
+        int frameCount();
+
+        /// @brief Copy out a recorded frame.
+        /// @param age 0 for the latest frame, up to frameCount() - 1
+        /// @param data set to the raw response
+        /// @param time millis() when the frame was recorded
+        /// @return false if there is no such frame
+        bool getFrame(int age, String &data, unsigned long &time, FrameResult &result);
+
+        /// @brief Number of commands held, up to maxCommands.
+        int commandCount();
+
+        /// @brief A recorded command as a single line of text, eg "12345 W40:380 -> 380 OK".
+        /// @param age 0 for the latest command, up to commandCount() - 1
+        /// @return false if there is no such command
+        bool getCommand(int age, String &line);
+
+        static const char *resultName(FrameResult result);
+
+    private:
+        struct Frame {
+            unsigned long time;
+            FrameResult result;
+            uint16_t length;
+            char data[SpaFrame::maxLength + 1];
+        };
+
+        struct Command {
+            unsigned long time;
+            bool success;
+            char cmd[16];
+            char reply[24];
+        };
+
+        Frame _frames[maxFrames];
+        int _nextFrame = 0;
+        int _frameCount = 0;
+
+        Command _commands[maxCommands];
+        int _nextCommand = 0;
+        int _commandCount = 0;
+
+        portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+};
+
+#endif // FLIGHTRECORDER_H
@@ -0,0 +1,36 @@
+#ifndef INLINESTRING_H
+#define INLINESTRING_H
+
+#include <stddef.h>
+#include <string.h>
+
+/// @brief Fixed capacity string held in place, for the short text values of the RF response.
+///
+/// Copying and comparing one never touches the heap, unlike String.  A value longer than the capacity
+/// is truncated.
+template <size_t Capacity>
+class InlineString {
+    public:
+        InlineString() { _data[0] = '\0'; }
+        InlineString(const char *s) { assign(s, strlen(s)); }
+
+        void assign(const char *s, size_t length) {
+            if (length > Capacity) length = Capacity;
+            memcpy(_data, s, length);
+            _data[length] = '\0';
+        }
+
+        const char *c_str() const { return _data; }
+        size_t length() const { return strlen(_data); }
+        bool isEmpty() const { return _data[0] == '\0'; }
+
+        bool operator==(const InlineString &s) const { return strcmp(_data, s._data) == 0; }
+        bool operator!=(const InlineString &s) const { return !(*this == s); }
+        bool operator==(const char *s) const { return strcmp(_data, s) == 0; }
+        bool operator!=(const char *s) const { return !(*this == s); }
+
+    private:
+        char _data[Capacity + 1];
+};
+
+#endif // INLINESTRING_H
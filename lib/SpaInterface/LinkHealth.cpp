@@ -0,0 +1,36 @@
+#include "LinkHealth.h"
+
+void LinkHealth::flushed(size_t bytes) {
+    _bytesFlushed += bytes;
+
+    int bucket = 0;
+    while (bytes > 0 && bucket < flushBuckets - 1) {
+        bytes >>= 1;
+        bucket++;
+    }
+    _flushHistogram[bucket]++;
+}
+
+void LinkHealth::recovered(unsigned long time) {
+    _lastRecoveryTime = time;
+    if (time > _maxRecoveryTime) _maxRecoveryTime = time;
+}
+
+const char *LinkHealth::failureName(FrameFailure reason) {
+    switch (reason) {
+        case FRAME_NO_RESPONSE: return "noResponse";
+        case FRAME_FIELD_TIMEOUT: return "fieldTimeout";
+        case FRAME_EMPTY_FIELD: return "emptyField";
+        case FRAME_NO_HEADER: return "noHeader";
+        case FRAME_TOO_LONG: return "tooLong";
+        case FRAME_SHORT_REGISTER: return "shortRegister";
+        case FRAME_MISSING_REGISTER: return "missingRegister";
+        case FRAME_TOO_FEW_FIELDS: return "tooFewFields";
+        default: return "unknown";
+    }
+}
+
+long LinkHealth::flushBucketLimit(int bucket) {
+    if (bucket >= flushBuckets - 1) return -1;
+    return (1L << bucket) - 1;
+}
@@ -0,0 +1,96 @@
+#ifndef LINKHEALTH_H
+#define LINKHEALTH_H
+
+#include <Arduino.h>
+
+/// @brief Counts what happens on the serial link to the SpaNet controller: how many RF reads
+/// succeed, why the others fail, how much is thrown away when the read buffer is flushed, and how
+/// many commands go unanswered or get the wrong reply.
+///
+/// Each count is a single 32 bit word with a single writer (the bus task, or for RX overflows the
+/// UART driver's event task), so the web server and MQTT can read them at any time without a lock,
+/// at the cost of one count being a step behind another.
+class LinkHealth {
+    public:
+        /// @brief Why an RF read was given up or rejected.
+        enum FrameFailure : uint8_t {
+            FRAME_NO_RESPONSE,      // Nothing came back to the RF command
+            FRAME_FIELD_TIMEOUT,    // The response stopped part way through
+            FRAME_EMPTY_FIELD,      // Too many registers with two commas in a row
+            FRAME_NO_HEADER,        // The first field wasn't RF:
+            FRAME_TOO_LONG,         // More data than fits in a frame
+            FRAME_SHORT_REGISTER,   // Too many registers with fewer fields than expected
+            FRAME_MISSING_REGISTER, // Fewer than 12 registers
+            FRAME_TOO_FEW_FIELDS,   // Fewer fields in total than expected
+            numFrameFailures
+        };
+
+        /// @brief Buckets of the flushed bytes histogram.  Bucket 0 counts flushes of nothing,
+        /// bucket n flushes of 2^(n-1) to 2^n - 1 bytes, and the last bucket everything bigger.
+        static const int flushBuckets = 12;
+
+        void frameAttempted() { _framesAttempted++; }
+        void frameSucceeded() { _framesSucceeded++; }
+        void frameFailed(FrameFailure reason) { _frameFailures[reason]++; }
+        /// @brief A read given up to send a command, before anything was read.
+        void frameAbandoned() { _framesAbandoned++; }
+        /// @brief A frame used with its corrupted registers left out.
+        void frameRepaired() { _framesRepaired++; }
+        /// @brief Bytes skipped to find the RF: at the start of a response.
+        void resynced(size_t bytes) { _resyncBytes += bytes; }
+        /// @brief A good frame after a run of failed reads.
+        /// @param time time (ms) from the start of the first failed read to the end of the good one
+        void recovered(unsigned long time);
+
+        /// @brief Record a flush of the read buffer.
+        /// @param bytes number of bytes read and thrown away, or added to the end of the frame
+        void flushed(size_t bytes);
+
+        void commandSent() { _commandsSent++; }
+        /// @brief No reply at all before the command timeout.
+        void commandTimeout() { _commandTimeouts++; }
+        /// @brief A reply that wasn't the one expected.
+        void echoMismatch() { _echoMismatches++; }
+        /// @brief The UART's receive FIFO or buffer filled up before it was read, so data was lost.
+        void rxOverflow() { _rxOverflows++; }
+
+        uint32_t framesAttempted() const { return _framesAttempted; }
+        uint32_t framesSucceeded() const { return _framesSucceeded; }
+        uint32_t framesAbandoned() const { return _framesAbandoned; }
+        uint32_t framesRepaired() const { return _framesRepaired; }
+        uint32_t frameFailures(FrameFailure reason) const { return _frameFailures[reason]; }
+        uint32_t resyncBytes() const { return _resyncBytes; }
+        /// @brief Time (ms) to get a good frame after the last run of failed reads, and the longest.
+        uint32_t lastRecoveryTime() const { return _lastRecoveryTime; }
+        uint32_t maxRecoveryTime() const { return _maxRecoveryTime; }
+        uint32_t bytesFlushed() const { return _bytesFlushed; }
+        uint32_t flushCount(int bucket) const { return _flushHistogram[bucket]; }
+        uint32_t commandsSent() const { return _commandsSent; }
+        uint32_t commandTimeouts() const { return _commandTimeouts; }
+        uint32_t echoMismatches() const { return _echoMismatches; }
+        uint32_t rxOverflows() const { return _rxOverflows; }
+
+        /// @brief Name of a failure reason, eg "noResponse".
+        static const char *failureName(FrameFailure reason);
+
+        /// @brief Largest number of bytes counted in a bucket of the flush histogram, or -1 for the last bucket.
+        static long flushBucketLimit(int bucket);
+
+    private:
+        volatile uint32_t _framesAttempted = 0;
+        volatile uint32_t _framesSucceeded = 0;
+        volatile uint32_t _framesAbandoned = 0;
+        volatile uint32_t _framesRepaired = 0;
+        volatile uint32_t _frameFailures[numFrameFailures] = {};
+        volatile uint32_t _resyncBytes = 0;
+        volatile uint32_t _lastRecoveryTime = 0;
+        volatile uint32_t _maxRecoveryTime = 0;
+        volatile uint32_t _bytesFlushed = 0;
+        volatile uint32_t _flushHistogram[flushBuckets] = {};
+        volatile uint32_t _commandsSent = 0;
+        volatile uint32_t _commandTimeouts = 0;
+        volatile uint32_t _echoMismatches = 0;
+        volatile uint32_t _rxOverflows = 0;
+};
+
+#endif // LINKHEALTH_H
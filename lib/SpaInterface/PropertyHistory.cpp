@@ -0,0 +1,172 @@
+#include "PropertyHistory.h"
+#include <new>
+
+const PropertyHistory::Series PropertyHistory::series[numSeries] = {
+    { "WTMP", 1, 10, "C" },
+    { "HeaterTemperature", 1, 10, "C" },
+    { "Power", 10, 1, "W" },            // Held * 10, which wouldn't fit
+    { "MainsVoltage", 1, 1, "V" },
+    { "MainsCurrent", 1, 10, "A" },
+};
+
+const uint32_t PropertyHistory::tierIntervals[numTiers] = { 60, 900, 3600 };
+const int PropertyHistory::tierPoints[numTiers] = { 1440, 1344, 2160 };   // 24 hours, 14 days, 90 days
+
+PropertyHistory::PropertyHistory() {
+    static_assert(pointsPerSeries >= numTiers, "SPA_HISTORY_BYTES is too small for a point in every tier");
+
+    int wanted = 0;
+    for (int t = 0; t < numTiers; t++) wanted += tierPoints[t];
+
+    int start = 0;
+    for (int t = 0; t < numTiers; t++) {
+        _capacity[t] = pointsPerSeries >= wanted ? tierPoints[t] : (int)((long)tierPoints[t] * pointsPerSeries / wanted);
+        if (_capacity[t] == 0) _capacity[t] = 1;
+        _start[t] = start;
+        start += _capacity[t];
+        _head[t] = _capacity[t] - 1;
+        _count[t] = 0;
+        _newest[t] = 0;
+        _pending[t] = 0;
+        _pendingStart[t] = 0;
+    }
+    memset(_sum, 0, sizeof(_sum));
+    memset(_summed, 0, sizeof(_summed));
+}
+
+bool PropertyHistory::begin() {
+    if (!_points) _points.reset(new (std::nothrow) int16_t[numSeries * pointsPerSeries]);
+    return (bool)_points;
+}
+
+void PropertyHistory::record(unsigned long ms, time_t spaTime, const int *values) {
+    // Until the spa has been read there is nothing to time a point by
+    if (spaTime == 0 || !_points) return;
+
+    if (spaTime != _lastSpaTime) {
+        _lastSpaTime = spaTime;
+        _clockBase = spaTime - (time_t)(ms / 1000);
+    }
+
+    // Stay on a one minute grid, unless samples have been missed
+    unsigned long interval = sampleInterval * 1000UL;
+    _lastSample = _sampled && ms - _lastSample < 2 * interval ? _lastSample + interval : ms;
+    _sampled = true;
+
+    int16_t point[numSeries];
+    for (int s = 0; s < numSeries; s++) {
+        if (values == nullptr) {
+            point[s] = noValue;
+            continue;
+        }
+        long value = values[s] / series[s].divisor;
+        point[s] = value > INT16_MAX ? INT16_MAX : value <= noValue ? noValue + 1 : value;
+    }
+    add(0, _clockBase + (time_t)(ms / 1000), point);
+}
+
+void PropertyHistory::add(int tier, time_t time, const int16_t *values) {
+    long interval = tierIntervals[tier];
+    int next = tier + 1;
+
+    if (_count[tier] > 0) {
+        // Whole intervals since the newest point, to the nearest
+        long offset = (long)(time - _newest[tier]) + interval / 2;
+        long steps = offset >= 0 ? offset / interval : -((-offset + interval - 1) / interval);
+
+        if (steps > 1) {
+            skip(tier, steps - 1);
+        } else if (steps < 1) {
+            // The clock went back, the points from this time on are replaced
+            long dropped = std::min(1 - steps, (long)_count[tier]);
+            _count[tier] -= dropped;
+            _head[tier] = (int)((_head[tier] - dropped % _capacity[tier] + _capacity[tier]) % _capacity[tier]);
+            if (next < numTiers) {
+                _pending[next] = 0;
+                memset(_sum[next], 0, sizeof(_sum[next]));
+                memset(_summed[next], 0, sizeof(_summed[next]));
+            }
+        }
+    }
+
+    write(tier, values);
+    _newest[tier] = time;
+
+    if (next == numTiers) return;
+
+    if (_pending[next] == 0) _pendingStart[next] = time;
+    for (int s = 0; s < numSeries; s++) {
+        if (values[s] == noValue) continue;
+        _sum[next][s] += values[s];
+        _summed[next][s]++;
+    }
+    if (++_pending[next] == (int)(tierIntervals[next] / interval)) closePending(next);
+}
+
+void PropertyHistory::skip(int tier, long missing) {
+    long interval = tierIntervals[tier];
+    int16_t none[numSeries];
+    for (int s = 0; s < numSeries; s++) none[s] = noValue;
+
+    // Only the last capacity() of them can still be held
+    for (long i = std::max(0L, missing - _capacity[tier]); i < missing; i++) write(tier, none);
+    time_t first = _newest[tier] + interval;
+    _newest[tier] += (time_t)missing * interval;
+
+    int next = tier + 1;
+    if (next == numTiers) return;
+
+    // Finish the point being averaged, then whole points of the next tier are skipped too
+    long perPoint = tierIntervals[next] / interval;
+    if (_pending[next] == 0) _pendingStart[next] = first;
+    long toClose = perPoint - _pending[next];
+    if (missing < toClose) {
+        _pending[next] += missing;
+        return;
+    }
+    closePending(next);
+    missing -= toClose;
+    if (missing >= perPoint) skip(next, missing / perPoint);
+    _pending[next] = missing % perPoint;
+    _pendingStart[next] = first + (time_t)(toClose + missing / perPoint * perPoint) * interval;
+}
+
+void PropertyHistory::closePending(int tier) {
+    int16_t average[numSeries];
+    for (int s = 0; s < numSeries; s++) {
+        int32_t sum = _sum[tier][s], n = _summed[tier][s];
+        average[s] = n == 0 ? noValue : (int16_t)((sum + (sum < 0 ? -n : n) / 2) / n);
+        _sum[tier][s] = 0;
+        _summed[tier][s] = 0;
+    }
+    _pending[tier] = 0;
+    add(tier, _pendingStart[tier], average);
+}
+
+void PropertyHistory::write(int tier, const int16_t *values) {
+    _head[tier] = (_head[tier] + 1) % _capacity[tier];
+    if (_count[tier] < _capacity[tier]) _count[tier]++;
+    for (int s = 0; s < numSeries; s++) {
+        _points[s * pointsPerSeries + _start[tier] + _head[tier]] = values[s];
+    }
+}
+
+int PropertyHistory::tierFor(time_t from) const {
+    for (int t = 0; t < numTiers - 1; t++) {
+        if (_count[t] > 0 && time(t, _count[t] - 1) <= from) return t;
+    }
+    return numTiers - 1;
+}
+
+int16_t PropertyHistory::value(int seriesId, int tier, int age) const {
+    if (age < 0 || age >= _count[tier]) return noValue;
+    int slot = (_head[tier] - age + _capacity[tier]) % _capacity[tier];
+    return _points[seriesId * pointsPerSeries + _start[tier] + slot];
+}
+
+int PropertyHistory::findSeries(const char *name) {
+    for (int s = 0; s < numSeries; s++) {
+        if (strcmp(series[s].name, name) == 0) return s;
+    }
+    return -1;
+}
@@ -0,0 +1,126 @@
+#ifndef PROPERTYHISTORY_H
+#define PROPERTYHISTORY_H
+
+#include <Arduino.h>
+#include <memory>
+
+// Memory for the history, shared by every series and tier, taken from the heap by begin().  The
+// default holds the full 24 hours, 14 days and 90 days of all five series, with less each tier covers
+// proportionally less time.
+#ifndef SPA_HISTORY_BYTES
+#define SPA_HISTORY_BYTES 49440
+#endif
+
+/// @brief History of the temperatures and electrical readings in fixed memory, at three resolutions.
+///
+/// Every series is sampled once a minute into the first tier.  Each point of the next tier is the
+/// average of 15 of those, and each point of the last the average of 4 of the second, so the tiers
+/// hold 1 minute, 15 minute and hourly points.  Each tier is a ring, the oldest point is overwritten.
+///
+/// Values are int16_t fixed point, in steps of 1 / Series::resolution of the unit.  Times are from the
+/// spa's clock, as it has no other.  The points of a tier are always one interval apart, so only the
+/// newest time is kept: intervals skipped, by missed samples or the clock going forward, are filled
+/// with noValue, and if the clock goes back the points after the new time are dropped.
+class PropertyHistory {
+    public:
+        enum SeriesId { WTMP, HEATER_TEMPERATURE, POWER, MAINS_VOLTAGE, MAINS_CURRENT, numSeries };
+        static const int numTiers = 3;
+
+        struct Series {
+            const char *name;
+            /// @brief The property is divided by this to be stored, so it fits in an int16_t
+            uint8_t divisor;
+            /// @brief Stored steps per unit, eg 10 for 0.1 'C
+            uint8_t resolution;
+            const char *unit;
+        };
+        static const Series series[numSeries];
+
+        /// @brief Value of a minute without a reading, or a point averaged from none.
+        static const int16_t noValue = INT16_MIN;
+
+        PropertyHistory();
+
+        /// @brief Take the memory for the points.  Until then, and if there isn't enough, nothing is
+        /// recorded.
+        /// @return false if the memory couldn't be had
+        bool begin();
+
+        /// @brief A minute has passed since the last sample.
+        bool due(unsigned long ms) const { return !_sampled || ms - _lastSample >= sampleInterval * 1000UL; }
+
+        /// @brief Add the minute's point to every series, and to the coarser tiers when their interval is up.
+        /// @param ms millis() now
+        /// @param spaTime the spa's clock, 0 until it has been read
+        /// @param values value of each property as it holds it, by SeriesId, or nullptr if there is
+        /// no reading
+        void record(unsigned long ms, time_t spaTime, const int *values);
+
+        /// @brief Finest tier whose oldest point is no later than from, or the coarsest.
+        int tierFor(time_t from) const;
+
+        /// @brief Seconds between the points of a tier.
+        static uint32_t interval(int tier) { return tierIntervals[tier]; }
+
+        /// @brief Most points a tier holds, set by SPA_HISTORY_BYTES.
+        int capacity(int tier) const { return _capacity[tier]; }
+
+        /// @brief Points held in a tier, up to capacity().
+        int count(int tier) const { return _count[tier]; }
+
+        /// @brief Time of a point.
+        /// @param age 0 for the newest, up to count() - 1
+        time_t time(int tier, int age) const { return _newest[tier] - (time_t)age * tierIntervals[tier]; }
+
+        /// @brief Stored value of a point, see Series::resolution.
+        int16_t value(int seriesId, int tier, int age) const;
+
+        /// @brief SeriesId of a series by name, eg "WTMP", or -1.
+        static int findSeries(const char *name);
+
+        /// @brief Memory used by the points, 0 before begin().
+        size_t bytes() const { return _points ? numSeries * pointsPerSeries * sizeof(int16_t) : 0; }
+
+    private:
+        static const uint32_t sampleInterval = 60;
+        static const uint32_t tierIntervals[numTiers];
+        /// @brief Points each tier would hold with enough memory.
+        static const int tierPoints[numTiers];
+
+        static const int pointsPerSeries = SPA_HISTORY_BYTES / sizeof(int16_t) / numSeries;
+
+        std::unique_ptr<int16_t[]> _points;
+
+        int _capacity[numTiers];
+        /// @brief Start of each tier in a series' share of _points.
+        int _start[numTiers];
+        /// @brief Slot of the newest point of each tier.
+        int _head[numTiers];
+        int _count[numTiers];
+        time_t _newest[numTiers];
+
+        /// @brief Sum and number of the values waiting to be averaged into each tier but the first.
+        int32_t _sum[numTiers][numSeries];
+        uint8_t _summed[numTiers][numSeries];
+        /// @brief Points of the tier below added to the current point of each tier.
+        int _pending[numTiers];
+        time_t _pendingStart[numTiers];
+
+        bool _sampled = false;
+        unsigned long _lastSample = 0;
+        /// @brief Spa time at millis() 0, from the last time the spa's clock changed.
+        time_t _clockBase = 0;
+        time_t _lastSpaTime = 0;
+
+        /// @brief Add a point to a tier, and average it into the next.
+        void add(int tier, time_t time, const int16_t *values);
+        /// @brief Add intervals with no value to a tier after its newest point, and count them
+        /// towards the points of the next.
+        void skip(int tier, long missing);
+        /// @brief Add the point being averaged for a tier to it.
+        void closePending(int tier);
+        /// @brief Write the newest point of a tier, in the slot after the last.
+        void write(int tier, const int16_t *values);
+};
+
+#endif // PROPERTYHISTORY_H
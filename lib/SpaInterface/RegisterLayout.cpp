@@ -0,0 +1,129 @@
+#include "RegisterLayout.h"
+#include <Preferences.h>
+#include <RemoteDebug.h>
+
+extern RemoteDebug Debug;
+
+namespace {
+    const char *nvsNamespace = "spa-layout";
+    const char *currentKey = "current";
+}
+
+RegisterLayout::RegisterLayout(const char *const *names, const SpaProperties::FieldDescriptor *sver,
+                               const SpaProperties::FieldDescriptor *model)
+    : _names(names), _sverField(sver), _modelField(model) {
+    for (int r = 0; r < SpaProperties::numRegisters; r++) _start[r] = -1;
+}
+
+void RegisterLayout::find(const SpaFrame &frame, const char *const *names, int *start) {
+    for (int r = 0; r < SpaProperties::numRegisters; r++) start[r] = -1;
+    for (int field = 0; field < frame.fieldCount(); field++) {
+        SpaField value = frame.field(field);
+        for (int r = 0; r < SpaProperties::numRegisters; r++) {
+            if (value.equals(names[r])) start[r] = field;
+        }
+    }
+}
+
+SpaField RegisterLayout::field(const SpaFrame &frame, const SpaProperties::FieldDescriptor *descriptor) const {
+    return frame.field(_start[descriptor->reg] + descriptor->offset);
+}
+
+bool RegisterLayout::matches(const SpaFrame &frame) const {
+    if (!_valid) return false;
+    for (int r = 0; r < SpaProperties::numRegisters; r++) {
+        if (!frame.field(_start[r]).equals(_names[r])) return false;
+    }
+    return field(frame, _sverField).equals(_sver) && field(frame, _modelField).equals(_model);
+}
+
+bool RegisterLayout::learn(const SpaFrame &frame, const int *start) {
+    for (int r = 0; r < SpaProperties::numRegisters; r++) {
+        if (start[r] < 0) return false;
+    }
+
+    bool changed = !_valid;
+    for (int r = 0; r < SpaProperties::numRegisters; r++) {
+        if (_start[r] != start[r]) changed = true;
+        _start[r] = start[r];
+    }
+    _valid = true;
+
+    char sver[sizeof(_sver)], model[sizeof(_model)];
+    field(frame, _sverField).copyTo(sver, sizeof(sver));
+    field(frame, _modelField).copyTo(model, sizeof(model));
+    if (strcmp(sver, _sver) != 0 || strcmp(model, _model) != 0) changed = true;
+    strcpy(_sver, sver);
+    strcpy(_model, model);
+
+    if (changed) {
+        debugI("New register layout for %s %s", _model, _sver);
+        _stored = false;
+        save();
+    }
+    return true;
+}
+
+String RegisterLayout::key(const char *sver, const char *model) {
+    // NVS keys are limited to 15 characters, so the firmware is hashed (FNV-1a) to make one
+    uint32_t hash = 2166136261u;
+    auto add = [&hash](const char *s) {
+        for (; *s; s++) {
+            hash ^= (uint8_t)*s;
+            hash *= 16777619u;
+        }
+    };
+    add(sver);
+    add("/");
+    add(model);
+
+    char buffer[10];
+    snprintf(buffer, sizeof(buffer), "l%08lx", (unsigned long)hash);
+    return String(buffer);
+}
+
+bool RegisterLayout::load() {
+    Preferences preferences;
+    if (!preferences.begin(nvsNamespace, true)) return false;
+
+    Stored stored;
+    String layoutKey = preferences.getString(currentKey, "");
+    bool loaded = layoutKey.length() > 0 &&
+                  preferences.getBytes(layoutKey.c_str(), &stored, sizeof(stored)) == sizeof(stored) &&
+                  stored.version == storedVersion;
+    preferences.end();
+
+    if (!loaded) return false;
+
+    for (int r = 0; r < SpaProperties::numRegisters; r++) _start[r] = stored.start[r];
+    stored.sver[sizeof(stored.sver) - 1] = '\0';
+    stored.model[sizeof(stored.model) - 1] = '\0';
+    strcpy(_sver, stored.sver);
+    strcpy(_model, stored.model);
+    _valid = true;
+    _stored = true;
+    debugI("Loaded register layout for %s %s", _model, _sver);
+    return true;
+}
+
+void RegisterLayout::save() {
+    Preferences preferences;
+    if (!preferences.begin(nvsNamespace, false)) {
+        debugW("Couldn't open NVS to save the register layout");
+        return;
+    }
+
+    Stored stored = {};
+    stored.version = storedVersion;
+    for (int r = 0; r < SpaProperties::numRegisters; r++) stored.start[r] = _start[r];
+    strcpy(stored.sver, _sver);
+    strcpy(stored.model, _model);
+
+    // Keyed by firmware, so a controller update adds a layout rather than overwriting the old one.
+    String layoutKey = key(_sver, _model);
+    if (preferences.putBytes(layoutKey.c_str(), &stored, sizeof(stored)) != sizeof(stored) ||
+        preferences.putString(currentKey, layoutKey) == 0) {
+        debugW("Couldn't save the register layout");
+    }
+    preferences.end();
+}
@@ -0,0 +1,83 @@
+#ifndef REGISTERLAYOUT_H
+#define REGISTERLAYOUT_H
+
+#include <Arduino.h>
+#include "SpaProperties.h"
+#include "SpaFrame.h"
+
+/// @brief Where each register starts in the RF response, for one controller firmware.
+///
+/// The layout only changes when the controller's firmware does, so once it has been found it is
+/// saved in NVS under the firmware version and model (SVER and Model).  After a reboot the saved
+/// layout is loaded, and the first frame can be checked and decoded without searching it.
+///
+/// Checking a frame against the layout looks at the register names at the saved field numbers and
+/// the SVER and Model fields, so it takes the same time however long the frame is.
+class RegisterLayout {
+    public:
+        /// @param names name of each register, by Register
+        /// @param sver field the firmware version is read from
+        /// @param model field the spa model is read from
+        RegisterLayout(const char *const *names, const SpaProperties::FieldDescriptor *sver,
+                       const SpaProperties::FieldDescriptor *model);
+
+        /// @brief Load the layout last used from NVS.
+        /// @return true if there was one
+        bool load();
+
+        /// @brief There is a layout, loaded or learnt.
+        bool isValid() const { return _valid; }
+
+        /// @brief The layout was loaded from NVS rather than learnt from a frame since boot.
+        bool isStored() const { return _stored; }
+
+        /// @brief Every register name, and the firmware version and model, are where the layout says.
+        bool matches(const SpaFrame &frame) const;
+
+        /// @brief Take the layout from the register starts found in a frame, and save it if it is new.
+        /// @param frame frame the starts were found in, for the firmware version and model
+        /// @param start field number of each register, by Register, -1 if it wasn't found
+        /// @return false if a register is missing, so there is no layout
+        bool learn(const SpaFrame &frame, const int *start);
+
+        /// @brief Field number of each register, by Register.
+        const int *starts() const { return _start; }
+
+        const char *firmware() const { return _sver; }
+        const char *model() const { return _model; }
+
+        /// @brief Search a frame for each register name.
+        /// @param start set to the field number of each register, by Register, -1 if it wasn't found
+        static void find(const SpaFrame &frame, const char *const *names, int *start);
+
+    private:
+        /// @brief Layout as saved in NVS.  The version is changed if this changes, so an old layout
+        /// is ignored instead of misread.
+        struct Stored {
+            uint8_t version;
+            uint16_t start[SpaProperties::numRegisters];
+            char sver[24];
+            char model[16];
+        };
+        static const uint8_t storedVersion = 1;
+
+        const char *const *_names;
+        const SpaProperties::FieldDescriptor *_sverField;
+        const SpaProperties::FieldDescriptor *_modelField;
+
+        int _start[SpaProperties::numRegisters];
+        char _sver[sizeof(Stored::sver)] = "";
+        char _model[sizeof(Stored::model)] = "";
+        bool _valid = false;
+        bool _stored = false;
+
+        /// @brief Field holding a descriptor's value, in a frame with this layout.
+        SpaField field(const SpaFrame &frame, const SpaProperties::FieldDescriptor *descriptor) const;
+
+        /// @brief NVS key of the layout for a firmware version and model.
+        static String key(const char *sver, const char *model);
+
+        void save();
+};
+
+#endif // REGISTERLAYOUT_H
@@ -1,9 +1,19 @@
 #include "SpaInterface.h"
+#include <algorithm>
+#include <stdarg.h>
+#include <strings.h>
 
 #define BAUD_RATE 38400
 
+// Debug output of the bus task, queued for loop() to print, see busLog().
+#define busLogV(fmt, ...) busLog(RemoteDebug::VERBOSE, "(%s) " fmt, __func__, ##__VA_ARGS__)
+#define busLogD(fmt, ...) busLog(RemoteDebug::DEBUG, "(%s) " fmt, __func__, ##__VA_ARGS__)
+#define busLogI(fmt, ...) busLog(RemoteDebug::INFO, "(%s) " fmt, __func__, ##__VA_ARGS__)
+#define busLogW(fmt, ...) busLog(RemoteDebug::WARNING, "(%s) " fmt, __func__, ##__VA_ARGS__)
+#define busLogE(fmt, ...) busLog(RemoteDebug::ERROR, "(%s) " fmt, __func__, ##__VA_ARGS__)
+
 SpaInterface::SpaInterface() : port(SPA_SERIAL) {
-    SPA_SERIAL.setRxBufferSize(1024);  //required for unit testing
+    SPA_SERIAL.setRxBufferSize(SpaFrame::maxLength);  // Room for a whole RF response if the bus task is held up
     SPA_SERIAL.setTxBufferSize(1024);  //required for unit testing
     SPA_SERIAL.begin(BAUD_RATE, SERIAL_8N1, RX_PIN, TX_PIN);
     SPA_SERIAL.setTimeout(250);
@@ -12,138 +22,427 @@ SpaInterface::SpaInterface() : port(SPA_SERIAL) {
 SpaInterface::~SpaInterface() {}
 
 
+void SpaInterface::begin() {
+    if (_busTaskHandle != NULL) {
+        return;
+    }
+
+    // Done here rather than in the constructor, as NVS isn't ready until setup()
+    _layout.load();
+    _energy.load();
+    if (!_history.begin()) {
+        debugE("No room for %u bytes of history", (unsigned)(SPA_HISTORY_BYTES));
+    }
+
+    // Room for every command plus a status frame, and some debug output on top
+    _eventQueue = xQueueCreate(commandQueueSize + 1 + busLogQueueLines, sizeof(BusEvent));
+    _busFrameFree = xSemaphoreCreateBinary();
+    xSemaphoreGive(_busFrameFree);
+
+    xTaskCreatePinnedToCore(runBusTask, "SpaBusTask", 4096, this, 1, &_busTaskHandle, SPA_BUS_TASK_CORE);
+
+    // The UART driver's event task calls these, so the bus task can sleep until data arrives instead
+    // of polling the port.  It is only woken when the line goes quiet, which is the end of a reply, so
+    // a whole frame is taken in one read from the RX buffer, which holds one.  A pause part way through
+    // a frame, or statusFieldTimeout, just means it is read in more than one go.
+    //
+    // Pattern detection on the frame terminator isn't used: HardwareSerial owns the driver's event
+    // queue, and every register ends with the same ":\r\n", so it wouldn't mark the end of a frame.
+    SPA_SERIAL.setRxTimeout(serialIdleSymbols);
+    SPA_SERIAL.onReceive([this]() { xTaskNotifyGive(_busTaskHandle); }, true);
+    SPA_SERIAL.onReceiveError([this](hardwareSerial_error_t error) {
+        if (error == UART_BUFFER_FULL_ERROR || error == UART_FIFO_OVF_ERROR) _linkHealth.rxOverflow();
+    });
+}
+
+
 void SpaInterface::setUpdateFrequency(int updateFrequency) {
     _updateFrequency = updateFrequency;
+    updatePollTier();
+}
+
+const char *SpaInterface::pollTierName(PollTier tier) {
+    switch (tier) {
+        case POLL_ACTIVE: return "active";
+        case POLL_HEATING: return "heating";
+        case POLL_IDLE: return "idle";
+        case POLL_SLEEPING: return "sleeping";
+    }
+    return "unknown";
 }
 
-String SpaInterface::flushSerialReadBuffer(bool returnData) {
+void SpaInterface::updatePollTier() {
+    PollTier tier = POLL_IDLE;
+    if (_lastCommandTime != 0 && millis() - _lastCommandTime < commandActiveTime) {
+        tier = POLL_ACTIVE;
+    } else if (validStatusResponse) {
+        if (getRB_TP_Pump1() == 1 || getRB_TP_Pump2() == 1 || getRB_TP_Pump3() == 1 ||
+            getRB_TP_Pump4() == 1 || getRB_TP_Pump5() == 1 || getRB_TP_Light() == 1) {
+            tier = POLL_ACTIVE;
+        } else if (getRB_TP_Heater()) {
+            tier = POLL_HEATING;
+        } else if (getRB_TP_Sleep()) {
+            tier = POLL_SLEEPING;
+        }
+    }
+
+    int interval;
+    switch (tier) {
+        case POLL_ACTIVE: interval = activePollInterval; break;
+        case POLL_HEATING: interval = std::min(_updateFrequency, (int)heatingPollInterval); break;
+        case POLL_SLEEPING: interval = std::max(_updateFrequency, (int)sleepingPollInterval); break;
+        default: interval = _updateFrequency; break;
+    }
+
+    if (tier != _pollTier) debugI("Poll tier %s, polling every %i s", pollTierName(tier), interval);
+    _pollTier = tier;
+    _pollInterval = (unsigned long)interval * 1000;
+}
+
+void SpaInterface::flushSerialReadBuffer(SpaFrame *frame) {
     int x = 0;
-    String flushedData;
+    size_t flushed = 0;
 
-    debugD("Flushing serial stream - %i bytes in the buffer", port.available());
-    while (port.available() > 0 && x++ < 5120) {
+    busLogD("Flushing serial stream - %i bytes in the buffer", port.available());
+    while (port.available() > 0 && x < 5120) {
+        x++;
         int byte = port.read();
-        if (returnData) {
-            flushedData += (char)byte; // Append to buffer
+        if (frame != nullptr && frame->append((char)byte)) {
+            flushed++;
         }
-        debugV("%02X,", byte); // Log each byte
+        busLogV("%02X,", byte); // Log each byte
     }
 
-    debugD("Flushed serial stream - %i bytes remaining in the buffer", port.available());
+    busLogD("Flushed serial stream - %i bytes remaining in the buffer", port.available());
+    _linkHealth.flushed(x);
 
-    if (returnData && !flushedData.isEmpty()) {
-        debugD("Flushed data (%i bytes): %s", flushedData.length(), flushedData.c_str());
+    if (frame != nullptr && flushed > 0) {
+        busLogD("Flushed data (%i bytes): %s", (int)flushed, frame->c_str() + frame->length() - flushed);
     }
-
-    return flushedData;
 }
 
 
-void SpaInterface::sendCommand(String cmd) {
+CommandTiming &SpaInterface::commandTiming(const String &cmd) {
+    if (cmd.startsWith("S")) return _timing[CLASS_S];
+    if (cmd.startsWith("W")) return _timing[CLASS_W];
+    return _timing[CLASS_RF];
+}
 
-    flushSerialReadBuffer();
+void SpaInterface::sendCommand(String cmd, bool wake) {
+    CommandTiming &timing = commandTiming(cmd);
 
-    debugD("Sending - %s",cmd.c_str());
-    port.print('\n');
-    port.flush();
-    delay(50); // **TODO** is this needed?
+    if (wake) {
+        flushSerialReadBuffer();
+    }
+
+    busLogD("Sending - %s",cmd.c_str());
+    if (wake) {
+        port.print('\n');
+        port.flush();
+        delay(timing.wakeGap());
+    }
     port.printf("%s\n", cmd.c_str());
     port.flush();
 
-    ulong timeout = millis() + 1000; // wait up to 1 sec for a response
+    ulong sent = millis();
+    ulong timeout = timing.timeout();
 
-    debugD("Start waiting for a response");
-    while (port.available()==0 and millis()<timeout) {}
-    debugD("Finish waiting");
+    busLogD("Start waiting for a response");
+    // Woken by onReceive once the reply is in, or by a command being queued.
+    while (port.available()==0 and millis()-sent<timeout) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout - (millis() - sent)) + 1);
+    }
+    _lastCommandLatency = millis() - sent;
+    busLogD("Finish waiting");
 
     _resultRegistersDirty = true; // we're trying to write to the registers so we can assume that they will now be dirty
 }
 
-String SpaInterface::sendCommandReturnResult(String cmd) {
-    sendCommand(cmd);
+String SpaInterface::sendCommandReturnResult(String cmd, bool wake) {
+    sendCommand(cmd, wake);
     String result = port.readStringUntil('\r');
     port.read(); // get rid of the trailing LF char
-    debugV("Read - %s",result.c_str());
+    busLogV("Read - %s",result.c_str());
     return result;
 }
 
-bool SpaInterface::sendCommandCheckResult(String cmd, String expected){
-    String result = sendCommandReturnResult(cmd);
+bool SpaInterface::sendCommandCheckResult(String cmd, String expected, bool wake){
+    String result = sendCommandReturnResult(cmd, wake);
     bool outcome = result == expected;
-    if (!outcome) debugW("Sent comment %s, expected %s, got %s",cmd.c_str(),expected.c_str(),result.c_str());
+    if (!outcome) busLogW("Sent comment %s, expected %s, got %s",cmd.c_str(),expected.c_str(),result.c_str());
+    _linkHealth.commandSent();
+    if (result.isEmpty()) {
+        _linkHealth.commandTimeout();
+    } else if (!outcome) {
+        _linkHealth.echoMismatch();
+    }
+    _recorder.recordCommand(cmd.c_str(), result.c_str(), outcome);
+
+    // A reply that doesn't match arrived in time, so only a missing one counts against the timing.
+    CommandTiming &timing = commandTiming(cmd);
+    if (outcome) {
+        timing.success(_lastCommandLatency);
+    } else if (result.isEmpty()) {
+        timing.failure();
+    }
     return outcome;
 }
 
+SpaInterface::Command SpaInterface::makeCommand(const String &cmd, const String &expected, const String &value, const FieldDescriptor *field) {
+    Command command;
+    strlcpy(command.cmd, cmd.c_str(), sizeof(command.cmd));
+    strlcpy(command.expected, expected.c_str(), sizeof(command.expected));
+    strlcpy(command.value, value.c_str(), sizeof(command.value));
+    command.field = field;
+    command.transactionSize = 0;
+    return command;
+}
+
+bool SpaInterface::queueCommand(const String &cmd, const String &expected, const String &value, const FieldDescriptor *field) {
+    Command command = makeCommand(cmd, expected, value, field);
+    return queueTransaction(&command, 1);
+}
+
+bool SpaInterface::queueTransaction(Command *commands, int count) {
+    if (_busTaskHandle == NULL) {
+        debugW("Bus task not started, dropping command %s", commands[0].cmd);
+        return false;
+    }
+    if (count < 1 || count > maxTransactionSize) {
+        debugE("Invalid transaction size %i", count);
+        return false;
+    }
+
+    commands[0].transactionSize = count;
+    for (int i = 1; i < count; i++) commands[i].transactionSize = 0;
+
+    // A slider being dragged in HA sends a stream of values, only the last one matters.
+    bool replaced = false;
+    bool queued = true;
+    portENTER_CRITICAL(&_pendingLock);
+    int index = findPendingTransaction(commands, count);
+    if (index >= 0) {
+        for (int i = 0; i < count; i++) _pendingCommands[index + i] = commands[i];
+        _coalescedCommands += count;
+        replaced = true;
+    } else if (_pendingCount + count <= commandQueueSize) {
+        for (int i = 0; i < count; i++) _pendingCommands[_pendingCount++] = commands[i];
+    } else {
+        queued = false;
+    }
+    portEXIT_CRITICAL(&_pendingLock);
+
+    if (!queued) {
+        debugW("Command queue full, dropping command %s", commands[0].cmd);
+        return false;
+    }
+
+    debugD("Queueing - %s%s%s", commands[0].cmd, count > 1 ? " (+ more)" : "", replaced ? " (replaced waiting command)" : "");
+    _lastCommandTime = millis();
+    updatePollTier();
+    xTaskNotifyGive(_busTaskHandle);
+
+    // Show the new values straight away rather than after the round trip to the spa.
+    bool applied = false;
+    for (int i = 0; i < count; i++) {
+        if (commands[i].field != nullptr && commands[i].field->type != FieldDescriptor::TIME) {
+            applyOptimistic(commands[i]);
+            applied = true;
+        }
+    }
+    if (applied && updateCallback != nullptr) { updateCallback(); }
+    return true;
+}
+
+bool SpaInterface::removePendingCommand(const char *cmd) {
+    Command command = makeCommand(cmd, "", "", nullptr);
+    bool removed = false;
+
+    portENTER_CRITICAL(&_pendingLock);
+    int index = findPendingTransaction(&command, 1);
+    if (index >= 0 && strcmp(_pendingCommands[index].cmd, cmd) == 0) {
+        command = _pendingCommands[index];
+        removePendingAt(index);
+        _coalescedCommands++;
+        removed = true;
+    }
+    portEXIT_CRITICAL(&_pendingLock);
+
+    if (!removed) return false;
+    debugD("Removed waiting command %s", cmd);
+
+    // The command will never be sent, so the property goes back to the value the spa has.
+    int optimistic = findOptimistic(command.field);
+    if (optimistic >= 0 && strcmp(_optimistic[optimistic].value, command.value) == 0) {
+        rollbackOptimistic(optimistic);
+        if (updateCallback != nullptr) { updateCallback(); }
+    }
+    return true;
+}
+
+int SpaInterface::findPendingTransaction(const Command *commands, int count) {
+    for (int i = 0; i < _pendingCount; i += _pendingCommands[i].transactionSize) {
+        if (_pendingCommands[i].transactionSize != count) continue;
+
+        bool match = true;
+        for (int j = 0; j < count && match; j++) {
+            // Commands with a value are for the same register if they match up to the ':' (eg W40:380 and W40:375).
+            // Commands without one (eg W14) have to match exactly.
+            const char *cmd = commands[j].cmd;
+            const char *colon = strchr(cmd, ':');
+            size_t length = colon == nullptr ? strlen(cmd) + 1 : colon - cmd + 1;
+            match = strncmp(_pendingCommands[i + j].cmd, cmd, length) == 0;
+        }
+        if (match) return i;
+    }
+    return -1;
+}
+
+void SpaInterface::removePendingAt(int index) {
+    int count = _pendingCommands[index].transactionSize;
+    for (int i = index; i < _pendingCount - count; i++) {
+        _pendingCommands[i] = _pendingCommands[i + count];
+    }
+    _pendingCount -= count;
+}
+
+int SpaInterface::takePendingTransaction(Command *commands) {
+    int count = 0;
+    portENTER_CRITICAL(&_pendingLock);
+    if (_pendingCount > 0) {
+        count = _pendingCommands[0].transactionSize;
+        for (int i = 0; i < count; i++) commands[i] = _pendingCommands[i];
+        removePendingAt(0);
+    }
+    portEXIT_CRITICAL(&_pendingLock);
+    return count;
+}
+
+int SpaInterface::getQueuedCommands() {
+    portENTER_CRITICAL(&_pendingLock);
+    int count = _pendingCount;
+    portEXIT_CRITICAL(&_pendingLock);
+    return count;
+}
+
+void SpaInterface::completeCommand(const Command &command, bool success) {
+    debugD("Completed - %s, %s", command.cmd, success ? "OK" : "failed");
+
+    if (command.field != nullptr) {
+        // Whatever happened, the property may no longer reflect the last frame, so the next frame is
+        // decoded in full even if the controller didn't change.
+        _registerHashValid = false;
+
+        int index = findOptimistic(command.field);
+        if (index >= 0 && strcmp(_optimistic[index].value, command.value) != 0) {
+            // A newer command for the same property is on its way, and that one settles the value.
+        } else if (success) {
+            beginUpdate();
+            updateField(*command.field, SpaField(command.value));
+            endUpdate();
+            if (index >= 0) _optimistic[index].acknowledged = true;
+        } else if (index >= 0) {
+            debugW("Spa rejected %s, putting %s back to %s", command.cmd, command.field->name, _optimistic[index].previous);
+            rollbackOptimistic(index);
+            _optimisticRollbacks++;
+            if (updateCallback != nullptr) { updateCallback(); }
+        }
+    }
+
+    if (commandCallback != nullptr) { commandCallback(command.cmd, success); }
+}
+
+int SpaInterface::findOptimistic(const FieldDescriptor *field) {
+    for (int i = 0; i < _optimisticCount; i++) {
+        if (_optimistic[i].field == field) return i;
+    }
+    return -1;
+}
+
+void SpaInterface::applyOptimistic(const Command &command) {
+    int index = findOptimistic(command.field);
+    if (index < 0) {
+        // Every entry is for a different command in the queue, so this can only fill up if commands
+        // are lost.  The property is then just updated once the command succeeds.
+        if (_optimisticCount == commandQueueSize) return;
+        index = _optimisticCount++;
+        _optimistic[index].field = command.field;
+        strlcpy(_optimistic[index].previous, fieldText(*command.field).c_str(), sizeof(_optimistic[index].previous));
+    }
+    strlcpy(_optimistic[index].value, command.value, sizeof(_optimistic[index].value));
+    _optimistic[index].time = millis();
+    _optimistic[index].acknowledged = false;
+
+    beginUpdate();
+    updateField(*command.field, SpaField(command.value));
+    endUpdate();
+}
+
+void SpaInterface::rollbackOptimistic(int index) {
+    beginUpdate();
+    updateField(*_optimistic[index].field, SpaField(_optimistic[index].previous));
+    endUpdate();
+    _registerHashValid = false;
+    removeOptimistic(index);
+}
+
+void SpaInterface::removeOptimistic(int index) {
+    _optimistic[index] = _optimistic[--_optimisticCount];
+}
+
 bool SpaInterface::setRB_TP_Pump1(int mode){
     debugD("setRB_TP_Pump1 - %i",mode);
 
-    if (sendCommandCheckResult("S22:"+String(mode),"S22-OK")) {
-        update_RB_TP_Pump1(String(mode));
-        return true;
-    }
-    return false;
+    return queueCommand("S22:"+String(mode), "S22-OK", String(mode), findField(&SpaInterface::RB_TP_Pump1));
 }
 
 bool SpaInterface::setRB_TP_Pump2(int mode){
     debugD("setRB_TP_Pump2 - %i",mode);
 
-    if (sendCommandCheckResult("S23:"+String(mode),"S23-OK")) {
-        update_RB_TP_Pump2(String(mode));
-        return true;
-    }
-    return false;
+    return queueCommand("S23:"+String(mode), "S23-OK", String(mode), findField(&SpaInterface::RB_TP_Pump2));
 }
 
 bool SpaInterface::setRB_TP_Pump3(int mode){
     debugD("setRB_TP_Pump3 - %i",mode);
 
-    if (sendCommandCheckResult("S24:"+String(mode),"S24-OK")) {
-        update_RB_TP_Pump3(String(mode));
-        return true;
-    }
-    return false;
+    return queueCommand("S24:"+String(mode), "S24-OK", String(mode), findField(&SpaInterface::RB_TP_Pump3));
 }
 
 bool SpaInterface::setRB_TP_Pump4(int mode){
     debugD("setRB_TP_Pump4 - %i",mode);
 
-    if (sendCommandCheckResult("S25:"+String(mode),"S25-OK")) {
-        update_RB_TP_Pump4(String(mode));
-        return true;
-    }
-    return false;
+    return queueCommand("S25:"+String(mode), "S25-OK", String(mode), findField(&SpaInterface::RB_TP_Pump4));
 }
 
 bool SpaInterface::setRB_TP_Pump5(int mode){
     debugD("setRB_TP_Pump5 - %i",mode);
 
-    if (sendCommandCheckResult("S26:"+String(mode),"S26-OK")) {
-        update_RB_TP_Pump5(String(mode));
-        return true;
-    }
-    return false;
+    return queueCommand("S26:"+String(mode), "S26-OK", String(mode), findField(&SpaInterface::RB_TP_Pump5));
 }
 
 bool SpaInterface::setRB_TP_Light(int mode){
     debugD("setRB_TP_Light - %i",mode);
-    if (mode != getRB_TP_Light()) {
-        if (sendCommandCheckResult("W14","W14")) {
-            update_RB_TP_Light(String(mode));
-            return true;
-        }
+    if (mode != 0 && mode != 1) {
+        debugW("Invalid light state %i", mode);
         return false;
     }
+    // W14 toggles the lights.  Any toggle still waiting is cancelled first, which puts the
+    // optimistic value back, so the request is compared with the state the spa is heading for.
+    removePendingCommand("W14");
+    if (mode != getRB_TP_Light()) {
+        return queueCommand("W14", "W14", String(mode), findField(&SpaInterface::RB_TP_Light));
+    }
     return true;
 }
 
 bool SpaInterface::setHELE(int mode){
     debugD("setHELE - %i", mode);
-
-    if (sendCommandCheckResult("W98:"+String(mode),String(mode))) {
-        update_HELE(String(mode));
-        return true;
+    if (mode != 0 && mode != 1) {
+        debugW("Invalid HELE %i", mode);
+        return false;
     }
-    return false;
+
+    return queueCommand("W98:"+String(mode), String(mode), String(mode), findField(&SpaInterface::HELE));
 }
 
 
@@ -154,84 +453,85 @@ bool SpaInterface::setSTMP(int temp){
     debugD("setSTMP - %i", temp);
     String stemp = String(temp);
 
-    if (sendCommandCheckResult("W40:" + stemp,stemp)) {
-        update_STMP(stemp);
-        return true;
-    }
-    return false;
+    return queueCommand("W40:" + stemp, stemp, stemp, findField(&SpaInterface::STMP));
 }
 
 bool SpaInterface::setL_1SNZ_DAY(int mode){
     debugD("setL_1SNZ_DAY - %i",mode);
-    if (sendCommandCheckResult(String("W67:")+mode,String(mode))) {
-        update_L_1SNZ_DAY(String(mode));
-        return true;
-    }
-    return false;
+    return queueCommand(String("W67:")+mode, String(mode), String(mode), findField(&SpaInterface::L_1SNZ_DAY));
 }
 
 bool SpaInterface::setL_1SNZ_BGN(int mode){
     debugD("setL_1SNZ_BGN - %i",mode);
-    if (sendCommandCheckResult(String("W68:")+mode,String(mode))) {
-        update_L_1SNZ_BGN(String(mode));
-        return true;
-    }
-    return false;
+    return queueCommand(String("W68:")+mode, String(mode), String(mode), findField(&SpaInterface::L_1SNZ_BGN));
 }
 
 bool SpaInterface::setL_1SNZ_END(int mode){
     debugD("setL_1SNZ_END - %i",mode);
-    if (sendCommandCheckResult(String("W69:")+mode,String(mode))) {
-        update_L_1SNZ_END(String(mode));
-        return true;
-    }
-    return false;
+    return queueCommand(String("W69:")+mode, String(mode), String(mode), findField(&SpaInterface::L_1SNZ_END));
 }
 
 bool SpaInterface::setL_2SNZ_DAY(int mode){
     debugD("setL_2SNZ_DAY - %i",mode);
-    if (sendCommandCheckResult(String("W70:")+mode,String(mode))) {
-        update_L_2SNZ_DAY(String(mode));
-        return true;
-    }
-    return false;
+    return queueCommand(String("W70:")+mode, String(mode), String(mode), findField(&SpaInterface::L_2SNZ_DAY));
 }
 
 bool SpaInterface::setL_2SNZ_BGN(int mode){
-    debugD("setL_1SNZ_BGN - %i",mode);
-    if (sendCommandCheckResult(String("W71:")+mode,String(mode))) {
-        update_L_1SNZ_BGN(String(mode));
-        return true;
-    }
-    return false;
+    debugD("setL_2SNZ_BGN - %i",mode);
+    return queueCommand(String("W71:")+mode, String(mode), String(mode), findField(&SpaInterface::L_2SNZ_BGN));
 }
 
 bool SpaInterface::setL_2SNZ_END(int mode){
-    debugD("setL_1SNZ_END - %i",mode);
-    if (sendCommandCheckResult(String("W72:")+mode,String(mode))) {
-        update_L_1SNZ_END(String(mode));
-        return true;
-    }
-    return false;
+    debugD("setL_2SNZ_END - %i",mode);
+    return queueCommand(String("W72:")+mode, String(mode), String(mode), findField(&SpaInterface::L_2SNZ_END));
+}
+
+bool SpaInterface::setL_1SNZ(int day, int begin, int end){
+    debugD("setL_1SNZ - %i, %i, %i", day, begin, end);
+    String sday = String(day);
+    String sbegin = String(begin);
+    String send = String(end);
+
+    Command commands[] = {
+        makeCommand("W67:"+sday, sday, sday, findField(&SpaInterface::L_1SNZ_DAY)),
+        makeCommand("W68:"+sbegin, sbegin, sbegin, findField(&SpaInterface::L_1SNZ_BGN)),
+        makeCommand("W69:"+send, send, send, findField(&SpaInterface::L_1SNZ_END))
+    };
+    return queueTransaction(commands, 3);
+}
+
+bool SpaInterface::setL_2SNZ(int day, int begin, int end){
+    debugD("setL_2SNZ - %i, %i, %i", day, begin, end);
+    String sday = String(day);
+    String sbegin = String(begin);
+    String send = String(end);
+
+    Command commands[] = {
+        makeCommand("W70:"+sday, sday, sday, findField(&SpaInterface::L_2SNZ_DAY)),
+        makeCommand("W71:"+sbegin, sbegin, sbegin, findField(&SpaInterface::L_2SNZ_BGN)),
+        makeCommand("W72:"+send, send, send, findField(&SpaInterface::L_2SNZ_END))
+    };
+    return queueTransaction(commands, 3);
 }
 
 bool SpaInterface::setHPMP(int mode){
     debugD("setHPMP - %i", mode);
 
+    if (mode < 0 || mode >= (int)HPMPStrings.size()) {
+        debugW("Invalid heatpump mode %i", mode);
+        return false;
+    }
+
     String smode = String(mode);
 
-    if (sendCommandCheckResult("W99:"+smode,smode)) {
-        update_HPMP(smode);
-        return true;
-    }
-    return false;
+    return queueCommand("W99:"+smode, smode, HPMPStrings[mode], findField(&SpaInterface::HPMP));
 }
 
 bool SpaInterface::setHPMP(String mode){
     debugD("setHPMP - %s", mode.c_str());
 
     for (uint x=0; x<HPMPStrings.size(); x++) {
-        if (HPMPStrings[x] == mode) {
+        if (mode == HPMPStrings[x]) {
             return setHPMP(x);
         }
     }
@@ -243,17 +543,13 @@ bool SpaInterface::setColorMode(int mode){
 
     String smode = String(mode);
 
-    if (sendCommandCheckResult("S07:"+smode,smode)) {
-        update_ColorMode(smode);
-        return true;
-    }
-    return false;
+    return queueCommand("S07:"+smode, smode, smode, findField(&SpaInterface::ColorMode));
 }
 
 bool SpaInterface::setColorMode(String mode){
     debugD("setColorMode - %s", mode.c_str());
     for (uint x=0; x<colorModeStrings.size(); x++) {
-        if (colorModeStrings[x] == mode) {
+        if (mode == colorModeStrings[x]) {
             return setColorMode(x);
         }
     }
@@ -265,11 +561,7 @@ bool SpaInterface::setLBRTValue(int mode){
 
     String smode = String(mode);
 
-    if (sendCommandCheckResult("S08:"+smode,smode)) {
-        update_LBRTValue(smode);
-        return true;
-    }
-    return false;
+    return queueCommand("S08:"+smode, smode, smode, findField(&SpaInterface::LBRTValue));
 }
 
 bool SpaInterface::setLSPDValue(int mode){
@@ -277,11 +569,7 @@ bool SpaInterface::setLSPDValue(int mode){
 
     String smode = String(mode);
 
-    if (sendCommandCheckResult("S09:"+smode,smode)) {
-        update_LSPDValue(smode);
-        return true;
-    }
-    return false;
+    return queueCommand("S09:"+smode, smode, smode, findField(&SpaInterface::LSPDValue));
 }
 
 bool SpaInterface::setLSPDValue(String mode){
@@ -298,39 +586,28 @@ bool SpaInterface::setCurrClr(int mode){
 
     String smode = String(mode);
 
-    if (sendCommandCheckResult("S10:"+smode,smode)) {
-        update_CurrClr(smode);
-        return true;
-    }
-    return false;
+    return queueCommand("S10:"+smode, smode, smode, findField(&SpaInterface::CurrClr));
 }
 
 bool SpaInterface::setSpaTime(time_t t){
     debugD("setSpaTime");
 
-    String tmp;
-    bool outcome;
-
-    tmp = String(year(t));
-    outcome = sendCommandCheckResult("S01:"+tmp, tmp);
-
-    tmp = String(month(t));
-    outcome = outcome && sendCommandCheckResult("S02:"+tmp,tmp);
-
-    tmp = String(day(t));
-    outcome = outcome && sendCommandCheckResult("S03:"+tmp,tmp);
-    
-    tmp = String(hour(t));
-    outcome = outcome && sendCommandCheckResult("S04:"+tmp,tmp);
-    
-    tmp = String(minute(t));
-    outcome = outcome && sendCommandCheckResult("S05:"+tmp,tmp);
-    
-    tmp = String(second(t));
-    outcome = outcome && sendCommandCheckResult("S06:"+tmp,tmp);
-    
-    return outcome;
-
+    String y = String(year(t));
+    String mo = String(month(t));
+    String d = String(day(t));
+    String h = String(hour(t));
+    String mi = String(minute(t));
+    String se = String(second(t));
+
+    Command commands[] = {
+        makeCommand("S01:"+y, y, "", nullptr),
+        makeCommand("S02:"+mo, mo, "", nullptr),
+        makeCommand("S03:"+d, d, "", nullptr),
+        makeCommand("S04:"+h, h, "", nullptr),
+        makeCommand("S05:"+mi, mi, "", nullptr),
+        makeCommand("S06:"+se, se, "", nullptr)
+    };
+    return queueTransaction(commands, 6);
 }
 
 bool SpaInterface::setOutlet_Blower(int mode){
@@ -338,11 +615,7 @@ bool SpaInterface::setOutlet_Blower(int mode){
 
     String smode = String(mode);
 
-    if (sendCommandCheckResult("S28:"+smode,"S28-OK")) {
-        update_Outlet_Blower(smode);
-        return true;
-    }
-    return false;
+    return queueCommand("S28:"+smode, "S28-OK", smode, findField(&SpaInterface::Outlet_Blower));
 }
 
 bool SpaInterface::setVARIValue(int mode){
@@ -350,10 +623,7 @@ bool SpaInterface::setVARIValue(int mode){
     if (mode > 0 && mode < 6) {
         String smode = String(mode);
 
-        if (sendCommandCheckResult("S13:"+smode,smode+"  S13")) {
-            update_VARIValue(smode);
-            return true;
-        }
+        return queueCommand("S13:"+smode, smode+"  S13", smode, findField(&SpaInterface::VARIValue));
     }
     return false;
 }
@@ -361,19 +631,20 @@ bool SpaInterface::setVARIValue(int mode){
 bool SpaInterface::setMode(int mode){
     debugD("setMode - %i", mode);
 
+    if (mode < 0 || mode >= (int)spaModeStrings.size()) {
+        debugW("Invalid mode %i", mode);
+        return false;
+    }
+
     String smode = String(mode);
 
-    if (sendCommandCheckResult("W66:"+smode,smode)) {
-        update_Mode(spaModeStrings[mode]);
-        return true;
-    }
-    return false;
+    return queueCommand("W66:"+smode, smode, spaModeStrings[mode], findField(&SpaInterface::Mode));
 }
 
 bool SpaInterface::setMode(String mode){
     debugD("setMode - %s", mode.c_str());
     for (uint x=0; x<spaModeStrings.size(); x++) {
-        if (spaModeStrings[x] == mode) {
+        if (mode == spaModeStrings[x]) {
             return setMode(x);
         }
     }
@@ -381,136 +652,624 @@ bool SpaInterface::setMode(String mode){
 }
 
 
-bool SpaInterface::readStatus() {
+const SpaInterface::FieldSetter SpaInterface::fieldSetters[] = {
+    { findField(&SpaInterface::RB_TP_Pump1), &SpaInterface::setRB_TP_Pump1 },
+    { findField(&SpaInterface::RB_TP_Pump2), &SpaInterface::setRB_TP_Pump2 },
+    { findField(&SpaInterface::RB_TP_Pump3), &SpaInterface::setRB_TP_Pump3 },
+    { findField(&SpaInterface::RB_TP_Pump4), &SpaInterface::setRB_TP_Pump4 },
+    { findField(&SpaInterface::RB_TP_Pump5), &SpaInterface::setRB_TP_Pump5 },
+    { findField(&SpaInterface::RB_TP_Light), &SpaInterface::setRB_TP_Light, true },
+    { findField(&SpaInterface::HELE), &SpaInterface::setHELE },
+    { findField(&SpaInterface::STMP), &SpaInterface::setSTMP },
+    { findField(&SpaInterface::L_1SNZ_DAY), &SpaInterface::setL_1SNZ_DAY },
+    { findField(&SpaInterface::L_1SNZ_BGN), &SpaInterface::setL_1SNZ_BGN },
+    { findField(&SpaInterface::L_1SNZ_END), &SpaInterface::setL_1SNZ_END },
+    { findField(&SpaInterface::L_2SNZ_DAY), &SpaInterface::setL_2SNZ_DAY },
+    { findField(&SpaInterface::L_2SNZ_BGN), &SpaInterface::setL_2SNZ_BGN },
+    { findField(&SpaInterface::L_2SNZ_END), &SpaInterface::setL_2SNZ_END },
+    { findField(&SpaInterface::HPMP), &SpaInterface::setHPMP },
+    { findField(&SpaInterface::ColorMode), &SpaInterface::setColorMode },
+    { findField(&SpaInterface::LBRTValue), &SpaInterface::setLBRTValue },
+    { findField(&SpaInterface::LSPDValue), &SpaInterface::setLSPDValue },
+    { findField(&SpaInterface::CurrClr), &SpaInterface::setCurrClr },
+    { findField(&SpaInterface::Outlet_Blower), &SpaInterface::setOutlet_Blower },
+    { findField(&SpaInterface::VARIValue), &SpaInterface::setVARIValue },
+    { findField(&SpaInterface::Mode), &SpaInterface::setMode },
+};
+
+const int SpaInterface::fieldSetterCount = sizeof(fieldSetters) / sizeof(fieldSetters[0]);
+
+const SpaInterface::FieldSetter *SpaInterface::findSetter(const FieldDescriptor *field) {
+    for (int i = 0; i < fieldSetterCount && field != nullptr; i++) {
+        if (fieldSetters[i].field == field) return &fieldSetters[i];
+    }
+    return nullptr;
+}
 
-    // We could just do a port.readString but this will always impose a
-    // 250ms (or whatever the timeout is) delay penality.  This in turn,
-    // along with the other unavoidable delays can cause the status of
-    // properties to bounce in certain UI's (apple devices, home assistant, etc)
+bool SpaInterface::setField(const char *name, const char *value) {
+    const FieldDescriptor *field = findField(name);
+    const FieldSetter *setter = findSetter(field);
+    if (setter == nullptr) {
+        debugW("Can't set %s", name);
+        return false;
+    }
 
-    debugD("Reading registers -");
+    SpaField text(value);
+    long number;
+    bool valid = false;
+    switch (field->type) {
+        case FieldDescriptor::INT:
+            if (!setter->onOff) {
+                valid = text.parseNumber(number, field->scale);
+                break;
+            }
+            // fall through, a switch
+
+        case FieldDescriptor::BOOL:
+        case FieldDescriptor::NUMBER_BOOL:
+            // Only off or on, anything else would be sent to the spa as it is
+            if (text.equals("1") || strcasecmp(value, "true") == 0 || strcasecmp(value, "on") == 0) {
+                number = 1;
+                valid = true;
+            } else if (text.equals("0") || strcasecmp(value, "false") == 0 || strcasecmp(value, "off") == 0) {
+                number = 0;
+                valid = true;
+            }
+            break;
 
-    int field = 0;
-    int registerCounter = 0;
-    int currentRegisterSize = 0;
-    int registerError = 0;
-    validStatusResponse = false;
-    String statusResponseTmp = "";
+        case FieldDescriptor::ENUM:
+        case FieldDescriptor::NUMBER_ENUM:
+            for (int i = 0; field->enumName(i) != nullptr && !valid; i++) {
+                valid = text.equals(field->enumName(i));
+                number = i;
+            }
+            if (!valid && text.parseNumber(number)) valid = number >= 0 && field->enumName(number) != nullptr;
+            break;
 
-    while (field < statusResponseMaxFields)
-    {
-        statusResponseRaw[field] = port.readStringUntil(',');
-        debugV("(%i,%s)",field,statusResponseRaw[field].c_str());
+        default:
+            break;
+    }
+
+    if (!valid) {
+        debugW("%s isn't a valid value for %s", value, name);
+        return false;
+    }
+    return (this->*setter->set)(number);
+}
 
-        statusResponseTmp = statusResponseTmp + statusResponseRaw[field]+",";
+void SpaInterface::busLog(uint8_t level, const char *format, ...) {
+    if (level < _busLogLevel) return;
+
+    // Debug output mustn't take the room kept for command results and the status frame.
+    if (uxQueueSpacesAvailable(_eventQueue) <= commandQueueSize + 1) {
+        _busLogDropped++;
+        return;
+    }
+
+    BusEvent event = BusEvent();
+    event.type = BusEvent::LOG_LINE;
+    event.log.level = level;
+    va_list args;
+    va_start(args, format);
+    vsnprintf(event.log.text, sizeof(event.log.text), format, args);
+    va_end(args);
+
+    if (xQueueSend(_eventQueue, &event, 0) != pdTRUE) _busLogDropped++;
+}
 
-        if (statusResponseRaw[field].isEmpty()) { // If we get a empty field then we've had a bad read.
-            debugE("Throwing exception - null string");
-            return false;
+void SpaInterface::runBusTask(void *pvParameters) {
+    SpaInterface *si = static_cast<SpaInterface *>(pvParameters);
+    si->runBus();
+}
+
+void SpaInterface::runBus() {
+    while (true) {
+        busStep();
+    }
+}
+
+void SpaInterface::busStep() {
+    Command commands[maxTransactionSize];
+
+    // Once RF has gone out the response is on its way, so finish reading it (or time out) before
+    // sending anything else, or its bytes would be taken for the reply to the command.
+    if (_statusReadState == STATUS_WAITING || _statusReadState == STATUS_READING) {
+        readStatus();
+        waitForSerial();
+        return;
+    }
+
+    int count = takePendingTransaction(commands);
+    if (count > 0) {
+        if (_statusReadState == STATUS_WAKING) {
+            // Only the wake up has gone out, so it costs little to start again after the commands.
+            busLogD("Abandoning status read to send %s", commands[0].cmd);
+            _linkHealth.frameAbandoned();
+            finishStatusRead(false);
         }
-        if (field == 0 && !statusResponseRaw[field].startsWith("RF:")) { // If the first field is not "RF:" stop we don't have the start of the register
-            debugE("Throwing exception - field: %i, value: %s", field, statusResponseRaw[field].c_str());
-            return false;
+        executeTransaction(commands, count);
+        return;
+    }
+
+    if (_statusReadState != STATUS_IDLE) {
+        readStatus();
+        waitForSerial();
+        return;
+    }
+
+    if (_resultRegistersDirty) {
+        _nextUpdateDue = millis() + 200;  // if we need to read the registers, pause a bit to see if there are more commands coming.
+        _resultRegistersDirty = false;
+    }
+
+    // Only start a read once loop() has taken a copy of the last frame.
+    if (millis()>_nextUpdateDue && xSemaphoreTake(_busFrameFree, 0) == pdTRUE) {
+        updateStatus();
+        return;
+    }
+
+    // Nothing to do, wait a little for a command to arrive.
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+}
+
+void SpaInterface::waitForSerial() {
+    unsigned long limit;
+    switch (_statusReadState) {
+        case STATUS_WAKING: limit = _timing[CLASS_RF].wakeGap(); break;
+        case STATUS_WAITING: limit = _timing[CLASS_RF].timeout(); break;
+        case STATUS_READING: limit = statusFieldTimeout; break;
+        default: return;
+    }
+
+    unsigned long elapsed = millis() - _statusReadTime;
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(elapsed < limit ? limit - elapsed : 0) + 1);
+}
+
+void SpaInterface::executeTransaction(const Command *commands, int count) {
+    unsigned long start = millis();
+    bool wake = true;
+
+    // The controller only needs waking (and the read buffer flushing) once.  After that each
+    // command goes out as soon as the reply to the one before it has been read.
+    for (int i = 0; i < count; i++) {
+        if (!wake) delay(transactionCommandGap);
+
+        BusEvent event = BusEvent();
+        event.type = BusEvent::COMMAND_COMPLETE;
+        event.command = commands[i];
+        event.success = sendCommandCheckResult(commands[i].cmd, commands[i].expected, wake);
+
+        if (xQueueSend(_eventQueue, &event, 0) != pdTRUE) {
+            busLogW("Event queue full, dropping the result of %s", commands[i].cmd);
+        }
+
+        // If we didn't get the reply we expected, start afresh so that a late reply isn't taken for the next one.
+        wake = !event.success;
+    }
+
+    _lastTransactionDuration = millis() - start;
+    _lastTransactionSize = count;
+    busLogD("Transaction of %i commands took %lu ms", count, _lastTransactionDuration);
+    recordBusUse(_lastTransactionDuration, false);
+}
+
+void SpaInterface::recordBusUse(unsigned long busyTime, bool poll) {
+    unsigned long now = millis();
+    if (_pollStatsStart == 0) _pollStatsStart = now;
+
+    // Publish the window once it is complete, scaled by its actual length as it only closes on the next use of the bus.
+    unsigned long elapsed = now - _pollStatsStart;
+    if (elapsed >= pollStatsWindow) {
+        _pollsPerHour = (unsigned long)((uint64_t)_windowPolls * 3600000 / elapsed);
+        _busUtilisation = std::min(100.0f, _windowBusyTime * 100.0f / elapsed);
+        _pollStatsStart = now;
+        _windowPolls = 0;
+        _windowBusyTime = 0;
+    }
+
+    _windowBusyTime += busyTime;
+    if (poll) _windowPolls++;
+}
+
+void SpaInterface::readStatus() {
+
+    // The RF response is around 1.5KB which takes the best part of half a second to
+    // arrive at 38400 baud.  Rather than blocking until it is all here, each step takes
+    // whatever is waiting in the serial buffer and picks up where the last step left
+    // off, so that the bus task can get on with other work in between.
+    //
+    // Each field is read straight into _busFrame so that a poll does not
+    // allocate anything on the heap.
+
+    _statusReadSteps++;
+
+    switch (_statusReadState) {
+        case STATUS_WAKING:
+            if (millis() - _statusReadTime < (unsigned long)_timing[CLASS_RF].wakeGap()) return;
+
+            busLogD("Sending - RF");
+            port.printf("RF\n");
+            port.flush();
+            busLogD("Start waiting for a response");
+            _statusReadState = STATUS_WAITING;
+            _statusReadTime = millis();
+            return;
+
+        case STATUS_WAITING:
+            if (port.available() == 0) {
+                if (millis() - _statusReadTime > (unsigned long)_timing[CLASS_RF].timeout()) {
+                    busLogE("Throwing exception - no response to RF command");
+                    failStatusRead(LinkHealth::FRAME_NO_RESPONSE);
+                }
+                return;
+            }
+            _statusLatency = millis() - _statusReadTime;
+            busLogD("Finish waiting");
+            busLogD("Reading registers -");
+            _statusReadState = STATUS_READING;
+            break;
+
+        case STATUS_READING:
+            if (port.available() == 0) {
+                if (millis() - _statusReadTime > statusFieldTimeout) {
+                    busLogE("Throwing exception - timed out reading field: %i", _busFrame.fieldCount());
+                    failStatusRead(LinkHealth::FRAME_FIELD_TIMEOUT);
+                }
+                return;
+            }
+            break;
+
+        default:
+            return;
+    }
+
+    // Take everything that has arrived in as few reads as possible, rather than a byte at a time.
+    char chunk[128];
+    size_t count = 0;
+    size_t next = 0;
+    while (next < count || port.available() > 0) {
+        if (next == count) {
+            count = port.readBytes(chunk, std::min((size_t)port.available(), sizeof(chunk)));
+            next = 0;
+            if (count == 0) break;
         }
-        // if we have reached a colon we are at the end of the current register
-        // OR
-        // if we are in register 11 (the last register) and have reached the minimum size we should stop
-        if (statusResponseRaw[field][0] == ':' || (registerCounter == 11 && currentRegisterSize >= registerMinSize[registerCounter])) {
-            debugV("Completed reading register: %s, number: %i, total fields counted: %i, minimum fields: %i", statusResponseRaw[field-currentRegisterSize+1], registerCounter, currentRegisterSize, registerMinSize[registerCounter]);
-            if (registerMinSize[registerCounter] > currentRegisterSize) {
-                debugE("Throwing exception - not enough fields in register: %s number: %i, total fields counted: %i, minimum fields: %i", statusResponseRaw[field-currentRegisterSize+1], registerCounter, currentRegisterSize, registerMinSize[registerCounter]);
-                registerError++; // Instead of returning false, I want to read the complete response so it is available in the webinterface for debugging
+        char c = chunk[next++];
+
+        if (c != ',') {
+            if (_statusFieldLength >= _busFrame.space()) {
+                busLogE("Throwing exception - response too long, %i bytes", (int)_busFrame.length());
+                failStatusRead(LinkHealth::FRAME_TOO_LONG);
+                return;
+            }
+            _busFrame.tail()[_statusFieldLength++] = c;
+
+            // Anything before the RF: at the start of the response is noise, or left over from an
+            // earlier reply, so drop it rather than the whole read.
+            if (_busFrame.fieldCount() == 0 && _statusFieldLength > 3 && memcmp(_busFrame.tail() + _statusFieldLength - 3, "RF:", 3) == 0) {
+                busLogW("Skipped %i bytes before the start of the response", (int)_statusFieldLength - 3);
+                _statusResyncBytes += _statusFieldLength - 3;
+                _linkHealth.resynced(_statusFieldLength - 3);
+                memmove(_busFrame.tail(), _busFrame.tail() + _statusFieldLength - 3, 3);
+                _statusFieldLength = 3;
             }
-            registerCounter++;
-            currentRegisterSize = 0;
+            continue;
         }
-        // If we reach the last register we have finished reading...
-        if (registerCounter >= 12) break;
-
-        if (!_initialised) { // We only have to set these on the first read, they never change after that.
-            if (statusResponseRaw[field] == "R2") R2 = field;
-            else if (statusResponseRaw[field] == "R3") R3 = field;
-            else if (statusResponseRaw[field] == "R4") R4 = field;
-            else if (statusResponseRaw[field] == "R5") R5 = field;
-            else if (statusResponseRaw[field] == "R6") R6 = field;
-            else if (statusResponseRaw[field] == "R7") R7 = field;
-            else if (statusResponseRaw[field] == "R9") R9 = field;
-            else if (statusResponseRaw[field] == "RA") RA = field;
-            else if (statusResponseRaw[field] == "RB") RB = field;
-            else if (statusResponseRaw[field] == "RC") RC = field;
-            else if (statusResponseRaw[field] == "RE") RE = field;
-            else if (statusResponseRaw[field] == "RG") RG = field;
+
+        StatusFieldResult result = addStatusField();
+        if (result == FIELD_ERROR) {
+            failStatusRead(_statusFieldFailure);
+            return;
+        }
+        if (result == FIELD_END) {
+            // Whatever is left of this chunk goes the same way as the rest of the buffer, see finishStatusRead().
+            while (next < count) _busFrame.append(chunk[next++]);
+            finishStatusRead(true);
+            return;
         }
+    }
+
+    _statusReadTime = millis();
+}
 
+SpaInterface::StatusFieldResult SpaInterface::addStatusField() {
 
-        field++;
-        currentRegisterSize++;
+    if (!_busFrame.addField(_statusFieldLength)) {
+        busLogE("Too many fields, stopped reading at: %i", _busFrame.fieldCount());
+        return FIELD_END;
+    }
+    _statusFieldLength = 0;
+
+    int field = _busFrame.fieldCount() - 1;
+    SpaField value = _busFrame.field(field);
+    busLogV("(%i,%.*s)", field, value.length, value.data);
+
+    if (field == 0 && !value.startsWith("RF:")) { // Not the start of the response, skip it and keep looking for RF:
+        _statusResyncBytes += value.length + 1;
+        _linkHealth.resynced(value.length + 1);
+        if (_statusResyncBytes > maxResyncBytes) {
+            busLogE("Throwing exception - field: %i, value: %.*s", field, value.length, value.data);
+            _statusFieldFailure = LinkHealth::FRAME_NO_HEADER;
+            return FIELD_ERROR;
+        }
+        busLogW("Skipped field before the start of the response: %.*s", value.length, value.data);
+        _busFrame.clear();
+        return FIELD_CONTINUE;
+    }
+    if (value.isEmpty()) { // If we get a empty field then part of this register has been lost.
+        busLogE("Empty field %i in register number: %i", field, _statusRegisterCounter);
+        damageStatusRegister(LinkHealth::FRAME_EMPTY_FIELD);
+    }
+    // if we have reached a colon we are at the end of the current register
+    // OR
+    // if we are in register 11 (the last register) and have reached the minimum size we should stop
+    if (value[0] == ':' || (_statusRegisterCounter == 11 && _statusRegisterSize >= registerMinSize[_statusRegisterCounter])) {
+        SpaField registerName = _busFrame.field(field-_statusRegisterSize+1);
+        busLogV("Completed reading register: %.*s, number: %i, total fields counted: %i, minimum fields: %i", registerName.length, registerName.data, _statusRegisterCounter, _statusRegisterSize, registerMinSize[_statusRegisterCounter]);
+        if (registerMinSize[_statusRegisterCounter] > _statusRegisterSize) {
+            busLogE("Not enough fields in register: %.*s number: %i, total fields counted: %i, minimum fields: %i", registerName.length, registerName.data, _statusRegisterCounter, _statusRegisterSize, registerMinSize[_statusRegisterCounter]);
+            damageStatusRegister(LinkHealth::FRAME_SHORT_REGISTER); // The rest of the response is still read, and can still be used
+        }
+        _statusRegisterCounter++;
+        _statusRegisterSize = 0;
+    }
+    // If we reach the last register we have finished reading...
+    if (_statusRegisterCounter >= 12) return FIELD_END;
+
+    _statusRegisterSize++;
+    return FIELD_CONTINUE;
+}
+
+void SpaInterface::damageStatusRegister(LinkHealth::FrameFailure reason) {
+    // Only the first damage is reported if the frame ends up being rejected.
+    if (_statusDamagedRegisters == 0) _statusFieldFailure = reason;
+    _statusDamagedRegisters |= 1 << _statusRegisterCounter;
+}
+
+void SpaInterface::recordReadOutcome(bool success) {
+    if (success) {
+        if (_failedReads > 0) {
+            _linkHealth.recovered(millis() - _firstFailedRead);
+            busLogI("Good read after %i failed, %lu ms after the first", _failedReads, millis() - _firstFailedRead);
+        }
+        _failedReads = 0;
+    } else {
+        if (_failedReads == 0) _firstFailedRead = _statusReadStart;
+        _failedReads++;
+    }
+}
+
+void SpaInterface::failStatusRead(LinkHealth::FrameFailure reason) {
+    // Once the response has started the wake up gap and timeout worked, whatever went wrong after.
+    if (reason == LinkHealth::FRAME_NO_RESPONSE) _timing[CLASS_RF].failure();
+    _linkHealth.frameFailed(reason);
+    recordReadOutcome(false);
+    _recorder.recordFrame(_busFrame, FlightRecorder::FRAME_FAILED);
+    finishStatusRead(false);
+}
+
+void SpaInterface::finishStatusRead(bool complete) {
+    _statusReadState = STATUS_IDLE;
+    _lastStatusReadDuration = millis() - _statusReadStart;
+    _lastStatusReadSteps = _statusReadSteps;
+    busLogD("Status read took %lu ms over %i steps", _lastStatusReadDuration, _lastStatusReadSteps);
+    recordBusUse(_lastStatusReadDuration, true);
+
+    if (!complete) {
+        xSemaphoreGive(_busFrameFree);
+        return;
     }
 
     //Flush the remaining data from the buffer as the last field is meaningless
-    statusResponseTmp = statusResponseTmp + flushSerialReadBuffer(true);
+    flushSerialReadBuffer(&_busFrame);
+
+    BusEvent event = BusEvent();
+    event.type = BusEvent::STATUS_FRAME;
+    event.success = false;
+
+    int field = _busFrame.fieldCount() - 1;
+    int damaged = __builtin_popcount(_statusDamagedRegisters);
+    if (_statusRegisterCounter < 12) {
+        busLogE("Throwing exception - not enough registers, we only read: %i", _statusRegisterCounter);
+        _linkHealth.frameFailed(LinkHealth::FRAME_MISSING_REGISTER);
+    } else if (damaged > 0 && (!_statusGoodFrameRead || damaged > maxDamagedRegisters)) {
+        busLogE("Throwing exception - %i registers damaged", damaged);
+        _linkHealth.frameFailed(_statusFieldFailure);
+    } else if (damaged == 0 && field < statusResponseMinFields) {
+        busLogE("Throwing exception - %i fields read expecting at least %i",field, statusResponseMinFields);
+        _linkHealth.frameFailed(LinkHealth::FRAME_TOO_FEW_FIELDS);
+    } else {
+        event.success = true;
+        event.damagedRegisters = _statusDamagedRegisters;
+        _linkHealth.frameSucceeded();
+        if (damaged > 0) {
+            busLogW("Using frame without %i damaged registers", damaged);
+            _linkHealth.frameRepaired();
+        }
+        _statusGoodFrameRead = true;
+        _timing[CLASS_RF].success(_statusLatency);
+        _resultRegistersDirty = false;
+        _nextUpdateDue = millis() + _pollInterval;
+        busLogD("Reading registers - finish");
+    }
 
-    statusResponse.update_Value(statusResponseTmp);
+    recordReadOutcome(event.success);
+    _recorder.recordFrame(_busFrame, !event.success ? FlightRecorder::FRAME_INVALID :
+        event.damagedRegisters != 0 ? FlightRecorder::FRAME_REPAIRED : FlightRecorder::FRAME_VALID);
 
-    if (registerCounter < 12) {
-        debugE("Throwing exception - not enough registers, we only read: %i", registerCounter);
-        return false;
+    // Even a bad frame is passed on so the raw response is available for debugging.
+    if (xQueueSend(_eventQueue, &event, 0) != pdTRUE) {
+        busLogW("Event queue full, dropping status frame");
+        xSemaphoreGive(_busFrameFree);
     }
+}
 
-    if (registerError > 0) {
-        debugE("Throwing exception - not enough fields in %i registers", registerError);
-        return false;
+void SpaInterface::updateStatus() {
+
+    flushSerialReadBuffer();
+
+    busLogD("Update status called");
+
+    _busFrame.clear();
+    _statusFieldLength = 0;
+    _statusRegisterCounter = 0;
+    _statusRegisterSize = 0;
+    _statusDamagedRegisters = 0;
+    _statusResyncBytes = 0;
+    _statusReadSteps = 0;
+    _linkHealth.frameAttempted();
+
+    port.print('\n');
+    port.flush();
+    _statusReadState = STATUS_WAKING;
+    _statusReadStart = _statusReadTime = millis();
+
+    // If the read fails we try again after FAILEDREADFREQUENCY, doubling with each failure in a row up to
+    // FAILEDREADMAXBACKOFF.  A good read pushes this out to the poll interval.
+    unsigned long backoff = (unsigned long)FAILEDREADFREQUENCY << std::min(_failedReads, 5);
+    _nextUpdateDue = millis() + std::min(backoff, (unsigned long)FAILEDREADMAXBACKOFF);
+}
+
+void SpaInterface::processStatusFrame(bool valid, uint16_t damaged) {
+    statusFrame = _busFrame;
+    xSemaphoreGive(_busFrameFree);
+
+    if (statusResponseCallback != nullptr) { statusResponseCallback(statusFrame.c_str()); }
+
+    if (!valid) {
+        validStatusResponse = false;
+        return;
     }
 
-    if (field < statusResponseMinFields) {
-        debugE("Throwing exception - %i fields read expecting at least %i",field, statusResponseMinFields);
-        return false;
+    if (damaged != 0) {
+        // A damaged register may be short, which moves every register after it, so this frame has to
+        // be searched.  It says nothing about the layout, which is left alone.
+        indexRegisters();
+    } else if (!checkLayout()) {
+        validStatusResponse = false;
+        return;
+    }
+
+    // A register whose name was lost can't be found, so it is left out too, even in the first frame.
+    for (int r = 0; r < numRegisters; r++) {
+        if (_registerStart[r] < 0) damaged |= 1 << r;
     }
 
+    // If a command has gone missing, stop waiting for it and let this frame settle the value.
+    for (int i = 0; i < _optimisticCount; i++) {
+        if (!_optimistic[i].acknowledged && millis() - _optimistic[i].time > optimisticTimeout) {
+            debugW("No reply to the command for %s, taking the value from the spa", _optimistic[i].field->name);
+            _optimistic[i].acknowledged = true;
+            _registerHashValid = false;
+        }
+    }
+
+    hashRegisters(damaged);
+    beginUpdate();
     updateMeasures();
-    _resultRegistersDirty = false;
     validStatusResponse = true;
+    _initialised = true;
+    _energy.add(millis(), getSpaTime(), getPower(), energyLoad());
+    endUpdate();
+    // A flash write can take tens of ms, which readers would spin through if it were inside the update
+    _energy.saveIfDue(millis());
+    notifySubscribers();
+    updatePollTier();
+    if (updateCallback != nullptr) { updateCallback(); }
+}
 
-    debugD("Reading registers - finish");
-    return true;
+EnergyMeter::Load SpaInterface::energyLoad() {
+    if (getHP_Compressor_State()) return EnergyMeter::HEAT_PUMP;
+    if (getRB_TP_Heater() || getHP_Heater_State()) return EnergyMeter::HEATER;
+
+    // Pumps are 1 when running, 4 when on auto and not necessarily running
+    int pumps[] = { getRB_TP_Pump1(), getRB_TP_Pump2(), getRB_TP_Pump3(), getRB_TP_Pump4(), getRB_TP_Pump5() };
+    for (int pump : pumps) {
+        if (pump == 1) return EnergyMeter::PUMPS;
+    }
+    if (getOutlet_Blower() != 2) return EnergyMeter::PUMPS; // 2 is off
+
+    return EnergyMeter::OTHER;
 }
 
-bool SpaInterface::isInitialised() { 
-    return _initialised; 
+void SpaInterface::beginUpdate() {
+    if (_updateDepth++ > 0) return;
+    _writerTask = xTaskGetCurrentTaskHandle();
+    _sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
 }
 
+void SpaInterface::endUpdate() {
+    if (--_updateDepth > 0) return;
+    _sequence.fetch_add(1, std::memory_order_release);
+}
 
-void SpaInterface::updateStatus() {
+void SpaInterface::indexRegisters() {
+    RegisterLayout::find(statusFrame, registerNames.data(), _registerStart);
+}
 
-    flushSerialReadBuffer();
+bool SpaInterface::checkLayout() {
+    if (_layout.matches(statusFrame)) {
+        _layoutConfirmed = true;
+        _layoutDrift = 0;
+        memcpy(_registerStart, _layout.starts(), sizeof(_registerStart));
+        return true;
+    }
 
-    debugD("Update status called");
-    sendCommand("RF");
+    // Once a frame has matched the layout, one that doesn't is more likely to be corrupted than a sign
+    // the controller has changed, so it isn't decoded.  If it keeps happening, learn the layout again.
+    if (_layoutConfirmed && ++_layoutDrift < layoutRelearnFrames) {
+        debugW("Registers are not where they were, frame rejected");
+        _layoutMismatches++;
+        return false;
+    }
 
-    _nextUpdateDue = millis() + FAILEDREADFREQUENCY;    
-    if (readStatus()) {
-        debugD("readStatus returned true");
-        _nextUpdateDue = millis() + (_updateFrequency * 1000);
-        _initialised = true;
-        if (updateCallback != nullptr) { updateCallback(); }
+    // There is no layout, it was saved for other firmware, or the layout really has changed.
+    indexRegisters();
+    _layoutDrift = 0;
+    if (_layout.learn(statusFrame, _registerStart)) {
+        _layoutConfirmed = true;
+    } else {
+        debugW("Registers missing from the frame, register layout not learnt");
     }
+    return true;
+}
+
+bool SpaInterface::isInitialised() { 
+    return _initialised; 
 }
 
 
 void SpaInterface::loop(){
+    unsigned long loopStart = micros();
+
     if ( _lastWaitMessage + 1000 < millis()) {
         debugD("Waiting...");
         _lastWaitMessage = millis();
     }
 
-    if (_resultRegistersDirty) {
-        _nextUpdateDue = millis() + 200;  // if we need to read the registers, pause a bit to see if there are more commands coming.
-        _resultRegistersDirty = false;
+    // Tell the bus task which of its debug output will be printed.
+    uint8_t level = RemoteDebug::VERBOSE;
+    while (level < RemoteDebug::ANY && !Debug.isActive(level)) level++;
+    _busLogLevel = level;
+
+    BusEvent event;
+    while (_eventQueue != NULL && xQueueReceive(_eventQueue, &event, 0) == pdTRUE) {
+        if (event.type == BusEvent::STATUS_FRAME) {
+            processStatusFrame(event.success, event.damagedRegisters);
+        } else if (event.type == BusEvent::LOG_LINE) {
+            if (Debug.isActive(event.log.level)) Debug.println(event.log.text);
+        } else {
+            completeCommand(event.command, event.success);
+        }
     }
 
-    if (millis()>_nextUpdateDue) {
-        updateStatus();    
+    if (_history.due(millis())) {
+        int values[PropertyHistory::numSeries] = { getWTMP(), getHeaterTemperature(), getPower(), getMainsVoltage(), getMainsCurrent() };
+        _history.record(millis(), getSpaTime(), validStatusResponse ? values : nullptr);
     }
+
+    unsigned long loopTime = micros() - loopStart;
+    if (loopTime > _loopTimeMax) _loopTimeMax = loopTime;
 }
 
 
@@ -524,263 +1283,65 @@ void SpaInterface::clearUpdateCallback() {
 }
 
 
+void SpaInterface::setStatusResponseCallback(void (*f)(const char *)) {
+    statusResponseCallback = f;
+}
+
+
+void SpaInterface::setCommandCallback(void (*f)(const char *, bool)) {
+    commandCallback = f;
+}
+
+
+void SpaInterface::hashRegisters(uint16_t damaged) {
+    const char *frame = statusFrame.c_str();
+
+    for (int r = 0; r < numRegisters; r++) {
+        // Corrupted or missing, so keep the properties (and the hash) from the last frame decoded
+        if ((damaged & (1 << r)) || _registerStart[r] < 0) {
+            _registerChanged[r] = false;
+            continue;
+        }
+
+        size_t begin = statusFrame.field(_registerStart[r]).data - frame;
+        size_t end = statusFrame.length();
+        if (r + 1 < numRegisters && _registerStart[r + 1] >= 0) end = statusFrame.field(_registerStart[r + 1]).data - frame;
+
+        if (begin >= end) { // Out of order, so it can't be hashed, always decode so it's no worse than before
+            _registerChanged[r] = true;
+            continue;
+        }
+
+        // FNV-1a over the raw text of the register, from its name up to the next register
+        uint32_t hash = 2166136261u;
+        for (size_t i = begin; i < end; i++) {
+            hash = (hash ^ (uint8_t)frame[i]) * 16777619u;
+        }
+
+        _registerChanged[r] = !_registerHashValid || hash != _registerHash[r];
+        if (!_registerChanged[r]) _registerSkips[r]++;
+        _registerHash[r] = hash;
+    }
+    _registerHashValid = true;
+}
+
 void SpaInterface::updateMeasures() {
-    #pragma region R2
-    update_MainsCurrent(statusResponseRaw[R2+1]);
-    update_MainsVoltage(statusResponseRaw[R2+2]);
-    update_CaseTemperature(statusResponseRaw[R2+3]);
-    update_PortCurrent(statusResponseRaw[R2+4]);
-    update_SpaTime(statusResponseRaw[R2+11], statusResponseRaw[R2+10], statusResponseRaw[R2+9], statusResponseRaw[R2+6], statusResponseRaw[R2+7], statusResponseRaw[R2+8]);
-    update_HeaterTemperature(statusResponseRaw[R2+12]);
-    update_PoolTemperature(statusResponseRaw[R2+13]);
-    update_WaterPresent(statusResponseRaw[R2+14]);
-    update_AwakeMinutesRemaining(statusResponseRaw[R2+16]);
-    update_FiltPumpRunTimeTotal(statusResponseRaw[R2+17]);
-    update_FiltPumpReqMins(statusResponseRaw[R2+18]);
-    update_LoadTimeOut(statusResponseRaw[R2+19]);
-    update_HourMeter(statusResponseRaw[R2+20]);
-    update_Relay1(statusResponseRaw[R2+21]);
-    update_Relay2(statusResponseRaw[R2+22]);
-    update_Relay3(statusResponseRaw[R2+23]);
-    update_Relay4(statusResponseRaw[R2+24]);
-    update_Relay5(statusResponseRaw[R2+25]);
-    update_Relay6(statusResponseRaw[R2+26]);
-    update_Relay7(statusResponseRaw[R2+27]);
-    update_Relay8(statusResponseRaw[R2+28]);
-    update_Relay9(statusResponseRaw[R2+29]); 
-    #pragma endregion
-    #pragma region R3
-    update_CLMT(statusResponseRaw[R3+1]);
-    update_PHSE(statusResponseRaw[R3+2]);
-    update_LLM1(statusResponseRaw[R3+3]);
-    update_LLM2(statusResponseRaw[R3+4]);
-    update_LLM3(statusResponseRaw[R3+5]);
-    update_SVER(statusResponseRaw[R3+6]);
-    update_Model(statusResponseRaw[R3+7]); 
-    update_SerialNo1(statusResponseRaw[R3+8]);
-    update_SerialNo2(statusResponseRaw[R3+9]); 
-    update_D1(statusResponseRaw[R3+10]);
-    update_D2(statusResponseRaw[R3+11]);
-    update_D3(statusResponseRaw[R3+12]);
-    update_D4(statusResponseRaw[R3+13]);
-    update_D5(statusResponseRaw[R3+14]);
-    update_D6(statusResponseRaw[R3+15]);
-    update_Pump(statusResponseRaw[R3+16]);
-    update_LS(statusResponseRaw[R3+17]);
-    update_HV(statusResponseRaw[R3+18]);
-    update_SnpMR(statusResponseRaw[R3+19]);
-    update_Status(statusResponseRaw[R3+20]);
-    update_PrimeCount(statusResponseRaw[R3+21]);
-    update_EC(statusResponseRaw[R3+22]);
-    update_HAMB(statusResponseRaw[R3+23]);
-    update_HCON(statusResponseRaw[R3+24]);
-    // update_HV_2(statusResponseRaw[R3+25]);
-    #pragma endregion
-    #pragma region R4
-    update_Mode(statusResponseRaw[R4+1]);
-    update_Ser1_Timer(statusResponseRaw[R4+2]);
-    update_Ser2_Timer(statusResponseRaw[R4+3]);
-    update_Ser3_Timer(statusResponseRaw[R4+4]);
-    update_HeatMode(statusResponseRaw[R4+5]);
-    update_PumpIdleTimer(statusResponseRaw[R4+6]);
-    update_PumpRunTimer(statusResponseRaw[R4+7]);
-    update_AdtPoolHys(statusResponseRaw[R4+8]);
-    update_AdtHeaterHys(statusResponseRaw[R4+9]);
-    update_Power(statusResponseRaw[R4+10]);
-    update_Power_kWh(statusResponseRaw[R4+11]);
-    update_Power_Today(statusResponseRaw[R4+12]);
-    update_Power_Yesterday(statusResponseRaw[R4+13]);
-    update_ThermalCutOut(statusResponseRaw[R4+14]);
-    update_Test_D1(statusResponseRaw[R4+15]);
-    update_Test_D2(statusResponseRaw[R4+16]);
-    update_Test_D3(statusResponseRaw[R4+17]);
-    update_ElementHeatSourceOffset(statusResponseRaw[R4+18]);
-    update_Frequency(statusResponseRaw[R4+19]);
-    update_HPHeatSourceOffset_Heat(statusResponseRaw[R4+20]);
-    update_HPHeatSourceOffset_Cool(statusResponseRaw[R4+21]);
-    update_HeatSourceOffTime(statusResponseRaw[R4+22]);
-    update_Vari_Speed(statusResponseRaw[R4+24]);
-    update_Vari_Percent(statusResponseRaw[R4+25]);
-    update_Vari_Mode(statusResponseRaw[R4+23]);
-    #pragma endregion
-    #pragma region R5
-    //R5
-    // Unknown encoding - TouchPad2.updateValue();
-    // Unknown encoding - TouchPad1.updateValue();
-    //RB_TP_Blower.updateValue(statusResponseRaw[R5 + 5]);
-    update_RB_TP_Sleep(statusResponseRaw[R5 + 10]);
-    update_RB_TP_Ozone(statusResponseRaw[R5 + 11]);
-    update_RB_TP_Heater(statusResponseRaw[R5 + 12]);
-    update_RB_TP_Auto(statusResponseRaw[R5 + 13]);
-    update_RB_TP_Light(statusResponseRaw[R5 + 14]);
-    update_WTMP(statusResponseRaw[R5 + 15]);
-    update_CleanCycle(statusResponseRaw[R5 + 16]);
-    update_RB_TP_Pump1(statusResponseRaw[R5 + 18]);
-    update_RB_TP_Pump2(statusResponseRaw[R5 + 19]);
-    update_RB_TP_Pump3(statusResponseRaw[R5 + 20]);
-    update_RB_TP_Pump4(statusResponseRaw[R5 + 21]);
-    update_RB_TP_Pump5(statusResponseRaw[R5 + 22]);
-    #pragma endregion
-    #pragma region R6
-    update_VARIValue(statusResponseRaw[R6 + 1]);
-    update_LBRTValue(statusResponseRaw[R6 + 2]);
-    update_CurrClr(statusResponseRaw[R6 + 3]);
-    update_ColorMode(statusResponseRaw[R6 + 4]);
-    update_LSPDValue(statusResponseRaw[R6 + 5]);
-    update_FiltSetHrs(statusResponseRaw[R6 + 6]);
-    update_FiltBlockHrs(statusResponseRaw[R6 + 7]);
-    update_STMP(statusResponseRaw[R6 + 8]);
-    update_L_24HOURS(statusResponseRaw[R6 + 9]);
-    update_PSAV_LVL(statusResponseRaw[R6 + 10]);
-    update_PSAV_BGN(statusResponseRaw[R6 + 11]);
-    update_PSAV_END(statusResponseRaw[R6 + 12]);
-    update_L_1SNZ_DAY(statusResponseRaw[R6 + 13]);
-    update_L_2SNZ_DAY(statusResponseRaw[R6 + 14]);
-    update_L_1SNZ_BGN(statusResponseRaw[R6 + 15]);
-    update_L_2SNZ_BGN(statusResponseRaw[R6 + 16]);
-    update_L_1SNZ_END(statusResponseRaw[R6 + 17]);
-    update_L_2SNZ_END(statusResponseRaw[R6 + 18]);
-    update_DefaultScrn(statusResponseRaw[R6 + 19]);
-    update_TOUT(statusResponseRaw[R6 + 20]);
-    update_VPMP(statusResponseRaw[R6 + 21]);
-    update_HIFI(statusResponseRaw[R6 + 22]);
-    update_BRND(statusResponseRaw[R6 + 23]);
-    update_PRME(statusResponseRaw[R6 + 24]);
-    update_ELMT(statusResponseRaw[R6 + 25]);
-    update_TYPE(statusResponseRaw[R6 + 26]);
-    update_GAS(statusResponseRaw[R6 + 27]);
-    #pragma endregion
-    #pragma region R7
-    update_WCLNTime(statusResponseRaw[R7 + 1]);
-    // The following 2 may be reversed
-    update_TemperatureUnits(statusResponseRaw[R7 + 3]);
-    update_OzoneOff(statusResponseRaw[R7 + 2]);
-    update_Ozone24(statusResponseRaw[R7 + 4]);
-    update_Circ24(statusResponseRaw[R7 + 6]);
-    update_CJET(statusResponseRaw[R7 + 5]);
-    // 0 = off, 1 = step, 2 = variable
-    update_VELE(statusResponseRaw[R7 + 7]);
-    //update_StartDD(statusResponseRaw[R7 + 8]);
-    //update_StartMM(statusResponseRaw[R7 + 9]);
-    //update_StartYY(statusResponseRaw[R7 + 10]);
-    update_V_Max(statusResponseRaw[R7 + 11]);
-    update_V_Min(statusResponseRaw[R7 + 12]);
-    update_V_Max_24(statusResponseRaw[R7 + 13]);
-    update_V_Min_24(statusResponseRaw[R7 + 14]);
-    update_CurrentZero(statusResponseRaw[R7 + 15]);
-    update_CurrentAdjust(statusResponseRaw[R7 + 16]);
-    update_VoltageAdjust(statusResponseRaw[R7 + 17]);
-    // 168 is unknown
-    update_Ser1(statusResponseRaw[R7 + 19]);
-    update_Ser2(statusResponseRaw[R7 + 20]);
-    update_Ser3(statusResponseRaw[R7 + 21]);
-    update_VMAX(statusResponseRaw[R7 + 22]);
-    update_AHYS(statusResponseRaw[R7 + 23]);
-    update_HUSE(statusResponseRaw[R7 + 24]);
-    update_HELE(statusResponseRaw[R7 + 25]);
-    update_HPMP(statusResponseRaw[R7 + 26]);
-    update_PMIN(statusResponseRaw[R7 + 27]);
-    update_PFLT(statusResponseRaw[R7 + 28]);
-    update_PHTR(statusResponseRaw[R7 + 29]);
-    update_PMAX(statusResponseRaw[R7 + 30]);
-    #pragma endregion
-    #pragma region R9
-    update_F1_HR(statusResponseRaw[R9 + 2]);
-    update_F1_Time(statusResponseRaw[R9 + 3]);
-    update_F1_ER(statusResponseRaw[R9 + 4]);
-    update_F1_I(statusResponseRaw[R9 + 5]);
-    update_F1_V(statusResponseRaw[R9 + 6]);
-    update_F1_PT(statusResponseRaw[R9 + 7]);
-    update_F1_HT(statusResponseRaw[R9 + 8]);
-    update_F1_CT(statusResponseRaw[R9 + 9]);
-    update_F1_PU(statusResponseRaw[R9 + 10]);
-    update_F1_VE(statusResponseRaw[R9 + 11]);
-    update_F1_ST(statusResponseRaw[R9 + 12]);
-    #pragma endregion
-    #pragma region RA
-    update_F2_HR(statusResponseRaw[RA + 2]);
-    update_F2_Time(statusResponseRaw[RA + 3]);
-    update_F2_ER(statusResponseRaw[RA + 4]);
-    update_F2_I(statusResponseRaw[RA + 5]);
-    update_F2_V(statusResponseRaw[RA + 6]);
-    update_F2_PT(statusResponseRaw[RA + 7]);
-    update_F2_HT(statusResponseRaw[RA + 8]);
-    update_F2_CT(statusResponseRaw[RA + 9]);
-    update_F2_PU(statusResponseRaw[RA + 10]);
-    update_F2_VE(statusResponseRaw[RA + 11]);
-    update_F2_ST(statusResponseRaw[RA + 12]);
-    #pragma endregion
-    #pragma region RB
-    update_F3_HR(statusResponseRaw[RB + 2]);
-    update_F3_Time(statusResponseRaw[RB + 3]);
-    update_F3_ER(statusResponseRaw[RB + 4]);
-    update_F3_I(statusResponseRaw[RB + 5]);
-    update_F3_V(statusResponseRaw[RB + 6]);
-    update_F3_PT(statusResponseRaw[RB + 7]);
-    update_F3_HT(statusResponseRaw[RB + 8]);
-    update_F3_CT(statusResponseRaw[RB + 9]);
-    update_F3_PU(statusResponseRaw[RB + 10]);
-    update_F3_VE(statusResponseRaw[RB + 11]);
-    update_F3_ST(statusResponseRaw[RB + 12]);
-    #pragma endregion
-    #pragma region RC
-    //Outlet_Heater.updateValue(statusResponseRaw[]);
-    //Outlet_Circ.updateValue(statusResponseRaw[]);
-    //Outlet_Sanitise.updateValue(statusResponseRaw[]);
-    //Outlet_Pump1.updateValue(statusResponseRaw[]);
-    //Outlet_Pump2.updateValue(statusResponseRaw[]);
-    //Outlet_Pump4.updateValue(statusResponseRaw[]);
-    //Outlet_Pump5.updateValue(statusResponseRaw[]);
-    update_Outlet_Blower(statusResponseRaw[RC + 10]);
-    #pragma endregion
-    #pragma region RE
-    update_HP_Present(statusResponseRaw[RE + 1]);
-    //HP_FlowSwitch.updateValue(statusResponseRaw[]);
-    //HP_HighSwitch.updateValue(statusResponseRaw[]);
-    //HP_LowSwitch.updateValue(statusResponseRaw[]);
-    //HP_CompCutOut.updateValue(statusResponseRaw[]);
-    //HP_ExCutOut.updateValue(statusResponseRaw[]);
-    //HP_D1.updateValue(statusResponseRaw[]);
-    //HP_D2.updateValue(statusResponseRaw[]);
-    //HP_D3.updateValue(statusResponseRaw[]);
-    update_HP_Ambient(statusResponseRaw[RE + 10]);
-    update_HP_Condensor(statusResponseRaw[RE + 11]);
-    update_HP_Compressor_State(statusResponseRaw[RE + 12]);
-    update_HP_Fan_State(statusResponseRaw[RE + 13]);
-    update_HP_4W_Valve(statusResponseRaw[RE + 14]);
-    update_HP_Heater_State(statusResponseRaw[RE + 15]);
-    update_HP_State(statusResponseRaw[RE + 16]);
-    update_HP_Mode(statusResponseRaw[RE + 17]);
-    update_HP_Defrost_Timer(statusResponseRaw[RE + 18]);
-    update_HP_Comp_Run_Timer(statusResponseRaw[RE + 19]);
-    update_HP_Low_Temp_Timer(statusResponseRaw[RE + 20]);
-    update_HP_Heat_Accum_Timer(statusResponseRaw[RE + 21]);
-    update_HP_Sequence_Timer(statusResponseRaw[RE + 22]);
-    update_HP_Warning(statusResponseRaw[RE + 23]);
-    update_FrezTmr(statusResponseRaw[RE + 24]);
-    update_DBGN(statusResponseRaw[RE + 25]);
-    update_DEND(statusResponseRaw[RE + 26]);
-    update_DCMP(statusResponseRaw[RE + 27]);
-    update_DMAX(statusResponseRaw[RE + 28]);
-    update_DELE(statusResponseRaw[RE + 29]);
-    update_DPMP(statusResponseRaw[RE + 30]);
-    //CMAX.updateValue(statusResponseRaw[]);
-    //HP_Compressor.updateValue(statusResponseRaw[]);
-    //HP_Pump_State.updateValue(statusResponseRaw[]);
-    //HP_Status.updateValue(statusResponseRaw[]);
-    #pragma endregion
-    #pragma region RG
-    update_Pump1InstallState(statusResponseRaw[RG + 7]);
-    update_Pump2InstallState(statusResponseRaw[RG + 8]);
-    update_Pump3InstallState(statusResponseRaw[RG + 9]);
-    update_Pump4InstallState(statusResponseRaw[RG + 10]);
-    update_Pump5InstallState(statusResponseRaw[RG + 11]);
-    update_Pump1OkToRun(statusResponseRaw[RG + 1]);
-    update_Pump2OkToRun(statusResponseRaw[RG + 2]);
-    update_Pump3OkToRun(statusResponseRaw[RG + 3]);
-    update_Pump4OkToRun(statusResponseRaw[RG + 4]);
-    update_Pump5OkToRun(statusResponseRaw[RG + 5]);
-    update_LockMode(statusResponseRaw[RG + 12]);
-    #pragma endregion
-
-};
\ No newline at end of file
+    for (int i = 0; i < fieldMapSize; i++) {
+        const FieldDescriptor &field = fieldMap[i];
+        if (!_registerChanged[field.reg]) continue;
+
+        int index = _optimisticCount > 0 ? findOptimistic(&field) : -1;
+        if (index < 0) {
+            updateField(field, statusFrame, _registerStart[field.reg] + field.offset);
+        } else if (_optimistic[index].acknowledged) {
+            // The first frame after the spa accepted the command has the final say.
+            updateField(field, statusFrame, _registerStart[field.reg] + field.offset);
+            if (fieldText(field) != _optimistic[index].value) {
+                debugW("Spa disagrees with %s, now %s", field.name, fieldText(field).c_str());
+                _optimisticRollbacks++;
+            }
+            removeOptimistic(index);
+        }
+        // Otherwise the frame was read before the command went out, so keep the optimistic value.
+    }
+}
\ No newline at end of file
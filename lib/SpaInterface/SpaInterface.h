@@ -2,39 +2,315 @@
 #define SPAINTERFACE_H
 
 #include <Arduino.h>
+#include <atomic>
 #include <functional>
 #include <stdexcept>
 #include <RemoteDebug.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
 #include "SpaProperties.h"
+#include "SpaFrame.h"
+#include "CommandTiming.h"
+#include "FlightRecorder.h"
+#include "PropertyHistory.h"
+#include "EnergyMeter.h"
+#include "LinkHealth.h"
+#include "RegisterLayout.h"
 
 extern RemoteDebug Debug;
-#define FAILEDREADFREQUENCY 1000 //(ms) Frequency to retry on a failed read of the status registers.
+#define FAILEDREADFREQUENCY 1000 //(ms) First retry after a failed read of the status registers, doubling with each failure in a row.
+#define FAILEDREADMAXBACKOFF 30000 //(ms) Longest wait between retries of failed reads.
+
+// The bus task runs on the other core to the Arduino loop (and so the web server, MQTT, etc).
+#ifndef SPA_BUS_TASK_CORE
+#define SPA_BUS_TASK_CORE (ARDUINO_RUNNING_CORE == 0 ? 1 : 0)
+#endif
 
 class SpaInterface : public SpaProperties {
+    public:
+        /// @brief Classes of command, each with their own learnt timing.
+        enum CommandClass { CLASS_RF, CLASS_S, CLASS_W, numCommandClasses };
+
+        /// @brief How busy the spa is, which sets how often it is polled.
+        enum PollTier { POLL_ACTIVE, POLL_HEATING, POLL_IDLE, POLL_SLEEPING };
+
     private:
 
         /// @brief How often to pole the spa for updates in seconds.
         int _updateFrequency = 60;
 
+        /// @brief Time (ms) between polls for the current PollTier, set by loop() and used by the bus task.
+        volatile unsigned long _pollInterval = 60000;
+
+        /// @brief Poll interval (s) while pumps or lights are on, or just after a command.
+        static const int activePollInterval = 5;
+        /// @brief Longest poll interval (s) while heating.
+        static const int heatingPollInterval = 30;
+        /// @brief Shortest poll interval (s) while the spa is sleeping.
+        static const int sleepingPollInterval = 300;
+        /// @brief Time (ms) after a command during which the spa is treated as active.
+        static const unsigned long commandActiveTime = 120000;
+        /// @brief Length (ms) of the window pollsPerHour and busUtilisation are measured over.
+        static const unsigned long pollStatsWindow = 600000;
+
         /// @brief Number of fields that we can expect to read.
         static const int statusResponseMinFields = 275;
-        static const int statusResponseMaxFields = 300;
-
-        /// @brief Each field of the RF cmd response as seperate elements.
-        String statusResponseRaw[statusResponseMaxFields];
-
-        int R2=-1;
-        int R3=-1;
-        int R4=-1;
-        int R5=-1;
-        int R6=-1;
-        int R7=-1;
-        int R9=-1;
-        int RA=-1;
-        int RB=-1;
-        int RC=-1;
-        int RE=-1;
-        int RG=-1;
+        static const int statusResponseMaxFields = SpaFrame::maxFields;
+
+        /// @brief A property that can be set by name, and the setX() method that sends it to the spa.
+        struct FieldSetter {
+            const FieldDescriptor *field;
+            bool (SpaInterface::*set)(int);
+            /// @brief Only off (0) or on (1), for a switch held as a number, eg the lights.
+            bool onOff;
+        };
+        static const FieldSetter fieldSetters[];
+        static const int fieldSetterCount;
+
+        /// @brief Setter of a row of fieldMap, or nullptr if it can't be set.
+        static const FieldSetter *findSetter(const FieldDescriptor *field);
+
+        /// @brief Maximum number of commands waiting for the bus task.
+        static const int commandQueueSize = 20;
+
+        /// @brief Maximum number of commands sent together in a transaction.
+        static const int maxTransactionSize = 6;
+
+        /// @brief Longest line of debug output from the bus task, longer lines are truncated.
+        static const int busLogLength = 96;
+
+        /// @brief Lines of debug output from the bus task that can wait for loop(), beyond which they are dropped.
+        static const int busLogQueueLines = 8;
+
+        /// @brief A command waiting to be sent to the spa by the bus task.
+        struct Command {
+            char cmd[16];
+            char expected[16];
+            /// @brief Value decoded into field once the command succeeds.
+            char value[16];
+            /// @brief Property to update locally once the command succeeds, can be null.
+            const FieldDescriptor *field;
+            /// @brief Number of commands in the transaction this command starts, 0 for the rest of a transaction.
+            uint8_t transactionSize;
+        };
+
+        /// @brief A property set locally ahead of the command that sets it on the spa.
+        struct OptimisticValue {
+            const FieldDescriptor *field;
+            /// @brief Value before the first command, restored if the spa rejects the change.
+            char previous[16];
+            /// @brief Value sent by the latest command.
+            char value[16];
+            /// @brief millis time the latest command was queued.
+            unsigned long time;
+            /// @brief The latest command has been accepted, the next frame confirms or corrects the value.
+            bool acknowledged;
+        };
+
+        /// @brief Time (ms) an optimistic value waits for its command before the next frame is trusted instead.
+        static const unsigned long optimisticTimeout = 30000;
+
+        /// @brief Clean frames in a row that don't match the register layout before it is learnt again,
+        /// in case the controller's firmware has changed while we were running.
+        static const int layoutRelearnFrames = 3;
+
+        /// @brief Passed from the bus task back to loop().
+        struct BusEvent {
+            enum { COMMAND_COMPLETE, STATUS_FRAME, LOG_LINE } type;
+            union {
+                Command command;
+                /// @brief Debug output of the bus task, printed by loop().
+                struct {
+                    uint8_t level;
+                    char text[busLogLength];
+                } log;
+            };
+            /// @brief The command succeeded, or the status frame passed validation.
+            bool success;
+            /// @brief Registers of the status frame to leave out, by bit (1 << Register).
+            uint16_t damagedRegisters;
+        };
+
+#pragma region Network task
+        // Everything in this region is only touched by loop() and the public methods,
+        // which are called from the Arduino loop.
+
+        /// @brief Raw RF cmd response, with each field indexed in place.
+        SpaFrame statusFrame;
+
+        /// @brief Field index in statusFrame of each register name, by Register.
+        int _registerStart[numRegisters] = { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 };
+
+        const std::array <const char *, numRegisters> registerNames = {
+          "R2", "R3", "R4", "R5", "R6", "R7", "R9", "RA", "RB", "RC", "RE", "RG"
+        };
+
+        /// @brief Register starts for the controller's firmware, saved in NVS so a frame can be checked
+        /// against them instead of searched.
+        RegisterLayout _layout{registerNames.data(), findField(&SpaInterface::SVER), findField(&SpaInterface::Model)};
+
+        /// @brief A frame has matched _layout since boot, so a frame that doesn't is rejected.
+        bool _layoutConfirmed = false;
+
+        /// @brief Clean frames in a row that didn't match _layout.
+        int _layoutDrift = 0;
+
+        /// @brief Clean frames rejected because their registers weren't where _layout says.
+        unsigned long _layoutMismatches = 0;
+
+        /// @brief Hash of each register in the last frame decoded, so unchanged registers can be skipped.
+        uint32_t _registerHash[numRegisters];
+
+        /// @brief _registerHash matches the current property values.
+        bool _registerHashValid = false;
+
+        /// @brief Register has changed since the last frame decoded, set by hashRegisters().
+        bool _registerChanged[numRegisters];
+
+        /// @brief Number of frames in which each register was unchanged and not decoded.
+        unsigned long _registerSkips[numRegisters] = {};
+
+        /// @brief Does the status response array contain valid information?
+        bool validStatusResponse = false;
+
+        /// @brief False until first successful read of the registers.
+        bool _initialised = false;
+
+        void (*updateCallback)() = nullptr;
+
+        void (*statusResponseCallback)(const char *) = nullptr;
+
+        void (*commandCallback)(const char *, bool) = nullptr;
+
+        u_long _lastWaitMessage = millis();
+
+        /// @brief Longest single call to loop() (us) since boot.
+        unsigned long _loopTimeMax = 0;
+
+        /// @brief Properties set ahead of their commands, see OptimisticValue.
+        OptimisticValue _optimistic[commandQueueSize];
+        int _optimisticCount = 0;
+
+        /// @brief Number of optimistic values that were put back, because the spa rejected the command
+        /// or the next frame disagreed.
+        unsigned long _optimisticRollbacks = 0;
+
+        PollTier _pollTier = POLL_IDLE;
+
+        /// @brief millis time the last command was queued, 0 if there hasn't been one.
+        unsigned long _lastCommandTime = 0;
+
+        /// @brief Choose the PollTier from the properties and recent commands, and set _pollInterval to match.
+        void updatePollTier();
+
+        /// @brief What the power of this frame is charged to: the heat pump's compressor, then the heater, then
+        /// any pump or the blower running.
+        EnergyMeter::Load energyLoad();
+
+        /// @brief Take a copy of the frame read by the bus task, and if it is valid update the properties from it.
+        /// @param valid the frame passed validation by the bus task
+        /// @param damaged registers that were corrupted, by bit (1 << Register), which are not decoded
+        void processStatusFrame(bool valid, uint16_t damaged);
+
+        /// @brief Search statusFrame for the start of each register.
+        void indexRegisters();
+
+        /// @brief Set the start of each register from _layout, or learn _layout from the frame.
+        /// @return false if the frame doesn't match a layout that has already been confirmed
+        bool checkLayout();
+
+        /// @brief Hash each register in statusFrame and flag those that changed since the last frame.
+        /// @param damaged registers to leave out, by bit (1 << Register)
+        void hashRegisters(uint16_t damaged);
+
+        /// @brief Update the properties from the registers in statusFrame that have changed, using fieldMap.
+        void updateMeasures();
+
+        /// @brief Apply the outcome of a command sent by the bus task.
+        void completeCommand(const Command &command, bool success);
+
+        /// @brief Index in _optimistic of the value for field, or -1 if there isn't one.
+        int findOptimistic(const FieldDescriptor *field);
+
+        /// @brief Set the property for a queued command straight away, remembering the value it replaces.
+        void applyOptimistic(const Command &command);
+
+        /// @brief Restore the value an optimistic value replaced and forget it.
+        void rollbackOptimistic(int index);
+
+        /// @brief Forget an optimistic value, leaving the property as it is.
+        void removeOptimistic(int index);
+
+        /// @brief Build a command for queueCommand() or queueTransaction().
+        /// @param cmd command to send
+        /// @param expected expected string response
+        /// @param value value to decode into field if the command succeeds
+        /// @param field property to update locally if the command succeeds, can be null
+        static Command makeCommand(const String &cmd, const String &expected, const String &value, const FieldDescriptor *field);
+
+        /// @brief Queue a command for the bus task.  If a command for the same register (eg W40) is
+        /// still waiting to go out it is replaced, keeping its place in the queue.
+        /// @return true if the command was queued
+        bool queueCommand(const String &cmd, const String &expected, const String &value, const FieldDescriptor *field);
+
+        /// @brief Queue commands to be sent back to back by the bus task, with a single wake up of the
+        /// controller.  Each command is still reported on its own.  A waiting transaction for the same
+        /// registers is replaced.
+        /// @param commands up to maxTransactionSize commands
+        /// @return true if the commands were queued
+        bool queueTransaction(Command *commands, int count);
+
+        /// @brief Drop a command that is still waiting to go out, restoring its optimistic value.
+        /// @param cmd the exact command text
+        /// @return true if the command was waiting
+        bool removePendingCommand(const char *cmd);
+#pragma endregion
+
+        /// @brief Recent raw frames and commands, written by the bus task and safe to read from any task.
+        FlightRecorder _recorder;
+
+        /// @brief History of the temperatures and electrical readings, sampled by loop().
+        PropertyHistory _history;
+
+        /// @brief Energy used by day, week and month, counted as each frame is processed.
+        EnergyMeter _energy;
+
+        /// @brief Counts of good and bad reads and commands, written by the bus task and safe to read from any task.
+        LinkHealth _linkHealth;
+
+#pragma region Pending commands
+        // Shared by both tasks, only accessed while holding _pendingLock.
+
+        /// @brief Commands waiting for the bus task, in the order they will be sent.
+        Command _pendingCommands[commandQueueSize];
+        int _pendingCount = 0;
+
+        /// @brief Number of commands replaced or removed before they were sent.
+        int _coalescedCommands = 0;
+
+        portMUX_TYPE _pendingLock = portMUX_INITIALIZER_UNLOCKED;
+
+        /// @brief Index of the waiting transaction for the same registers as commands, or -1 if there isn't one.
+        int findPendingTransaction(const Command *commands, int count);
+
+        /// @brief Remove the waiting transaction that starts at index.
+        void removePendingAt(int index);
+
+        /// @brief Take the next transaction to be sent.
+        /// @param commands room for maxTransactionSize commands
+        /// @return number of commands taken, 0 if there are none waiting
+        int takePendingTransaction(Command *commands);
+#pragma endregion
+
+#pragma region Bus task
+        // Everything in this region is only touched by the bus task, which owns the serial port.
+
+        /// @brief Serial stream to interface to SpanNet hardware.
+        Stream &port;
+
+        /// @brief RF cmd response as it is read, handed to loop() once it is complete.
+        SpaFrame _busFrame;
 
         // Register minimum sizes aligned with data read in updateMeasures()
         const std::array <int, 12> registerMinSize = {
@@ -52,59 +328,216 @@ class SpaInterface : public SpaProperties {
           12  //RG
           };
 
-        /// @brief Does the status response array contain valid information?
-        bool validStatusResponse = false;
+        /// @brief Progress of the read of the RF command response, which is spread over many steps of the bus task.
+        enum StatusReadState {
+            STATUS_IDLE,        // No read in progress
+            STATUS_WAKING,      // Wake up sent, waiting to send the RF command
+            STATUS_WAITING,     // RF command sent, waiting for the first byte of the response
+            STATUS_READING      // Reading fields of the response
+        };
 
-        /// @brief Serial stream to interface to SpanNet hardware.
-        Stream &port;
+        /// @brief Outcome of adding a field to the status frame.
+        enum StatusFieldResult {
+            FIELD_CONTINUE,     // Keep reading
+            FIELD_END,          // Stop reading and validate what we have
+            FIELD_ERROR         // Corrupted read, give up
+        };
 
-        /// @brief Read from serial interface, expect it to contain return from RF command
-        /// @return true if successful read, false if there was a corrupted read
-        bool readStatus();
+        /// @brief Time (ms) allowed between bytes of the RF response.  The wake up gap and the time
+        /// allowed for the first byte are learnt, see CommandTiming.
+        static const int statusFieldTimeout = 250;
 
-        void updateMeasures();
+        /// @brief Learnt timing of each class of command.
+        CommandTiming _timing[numCommandClasses] = { CommandTiming("RF"), CommandTiming("S"), CommandTiming("W") };
+
+        /// @brief Timing for cmd, by the first letter of the command.
+        CommandTiming &commandTiming(const String &cmd);
+
+        /// @brief Time (ms) from sending the last command to the first byte of the reply.
+        unsigned long _lastCommandLatency = 0;
+
+        /// @brief Time (ms) from sending the RF command to the first byte of the response, for the read in progress.
+        unsigned long _statusLatency = 0;
+
+        /// @brief Time (ms) between the reply to one command of a transaction and sending the next.
+        static const int transactionCommandGap = 10;
+
+        /// @brief Duration (ms) and number of commands of the last transaction.
+        unsigned long _lastTransactionDuration = 0;
+        int _lastTransactionSize = 0;
+
+        StatusReadState _statusReadState = STATUS_IDLE;
+
+        /// @brief millis time of the last step of the read, or the last byte received.
+        unsigned long _statusReadTime = 0;
+
+        /// @brief millis time the current read was started.
+        unsigned long _statusReadStart = 0;
+
+        /// @brief Number of bytes of the current field already written at _busFrame.tail().
+        size_t _statusFieldLength = 0;
+
+        int _statusRegisterCounter = 0;
+        int _statusRegisterSize = 0;
+
+        /// @brief Registers of the read in progress that were corrupted, by bit (1 << Register).
+        /// Reading carries on to the end of the register, and the frame is still used with those
+        /// registers left out (so their properties keep the values from the last good frame).
+        uint16_t _statusDamagedRegisters = 0;
+
+        /// @brief Most damaged registers a frame can have and still be used.
+        static const int maxDamagedRegisters = 3;
+
+        /// @brief A complete frame has been read, so there are properties to fall back on for damaged registers.
+        bool _statusGoodFrameRead = false;
+
+        /// @brief Bytes skipped looking for the RF: at the start of the response, and the most allowed.
+        size_t _statusResyncBytes = 0;
+        static const size_t maxResyncBytes = 256;
+
+        /// @brief Mark the register being read as damaged.
+        void damageStatusRegister(LinkHealth::FrameFailure reason);
+
+        /// @brief Failed reads in a row, which sets the backoff before the next retry.
+        int _failedReads = 0;
+
+        /// @brief millis time the first of the current run of failed reads started.
+        unsigned long _firstFailedRead = 0;
 
+        /// @brief Count a read towards the backoff and the time to recover.
+        void recordReadOutcome(bool success);
 
+        /// @brief Number of steps of the bus task for the read in progress.
+        int _statusReadSteps = 0;
+
+        /// @brief Duration (ms) and number of steps of the bus task for the last finished read.
+        unsigned long _lastStatusReadDuration = 0;
+        int _lastStatusReadSteps = 0;
+
+        /// @brief Polls started and time (ms) the bus was in use, in the current stats window.
+        unsigned long _pollStatsStart = 0;
+        unsigned long _windowPolls = 0;
+        unsigned long _windowBusyTime = 0;
+
+        /// @brief Polls per hour and bus utilisation (%) over the last complete stats window.
+        unsigned long _pollsPerHour = 0;
+        float _busUtilisation = 0;
+
+        /// @brief Add a status read or transaction to the stats window, rolling the window over when it is complete.
+        /// @param busyTime time (ms) the bus was in use
+        /// @param poll this was a status read
+        void recordBusUse(unsigned long busyTime, bool poll);
+
+        /// @brief Stores millis time at which next update should occur
+        unsigned long _nextUpdateDue = 0;
+
+        /// @brief If the result registers have been modified locally, need to do a fress pull from the controller
+        bool _resultRegistersDirty = true;
+
+        TaskHandle_t _busTaskHandle = NULL;
+
+        /// @brief Completed commands, frames and debug output from the bus task to loop().
+        QueueHandle_t _eventQueue = NULL;
+
+        /// @brief Lowest RemoteDebug level being shown, kept by loop() so the bus task only formats lines
+        /// that will be printed.
+        std::atomic<uint8_t> _busLogLevel{RemoteDebug::ANY};
+
+        /// @brief Held by the bus task from the start of a read until loop() has taken a copy of _busFrame.
+        SemaphoreHandle_t _busFrameFree = NULL;
+
+        /// @brief Sequence number of the properties, odd while they are being written.  See readConsistent().
+        std::atomic<uint32_t> _sequence{0};
+
+        /// @brief Task writing the properties, while _sequence is odd.
+        TaskHandle_t _writerTask = NULL;
+
+        /// @brief Nesting of beginUpdate(), only the outermost changes _sequence.
+        int _updateDepth = 0;
+
+        /// @brief Times a reader had to run again, because the properties changed under it.
+        std::atomic<unsigned long> _readRetries{0};
+
+        /// @brief Start writing properties, which readConsistent() readers then wait for.  Writes only
+        /// come from the task running loop() and queueing commands.
+        void beginUpdate();
+
+        /// @brief Publish the properties written since beginUpdate().
+        void endUpdate();
+
+        static void runBusTask(void *pvParameters);
+
+        /// @brief Main loop of the bus task.
+        void runBus();
+
+        /// @brief One step of the bus task, either part of a status read, a single command or a wait.
+        void busStep();
+
+        /// @brief Send the commands of a transaction and pass the outcome of each back to loop().
+        void executeTransaction(const Command *commands, int count);
+
+        /// @brief Time (UART symbols) the line has to be quiet before the driver passes on what it has received.
+        static const int serialIdleSymbols = 2;
+
+        /// @brief Sleep until more of the status response arrives, a command is queued, or the current
+        /// step of the read times out.
+        void waitForSerial();
+
+        /// @brief Read whatever is waiting on the serial interface and carry on parsing the
+        /// response to the RF command from where the last step left off.
+        void readStatus();
+
+        /// @brief Commit the current field to _busFrame and check it against the expected register layout.
+        /// Sets _statusFieldFailure when it returns FIELD_ERROR.
+        StatusFieldResult addStatusField();
+
+        /// @brief Why addStatusField() last returned FIELD_ERROR.
+        LinkHealth::FrameFailure _statusFieldFailure = LinkHealth::FRAME_EMPTY_FIELD;
+
+        /// @brief Give up on the read in progress because of a bad or missing response.
+        void failStatusRead(LinkHealth::FrameFailure reason);
+
+        /// @brief Finish the read in progress and, if the frame is complete, hand it to loop().
+        /// @param complete the end of the response was reached, validate it and pass it on
+        void finishStatusRead(bool complete);
 
         /// @brief Sends command to SpaNet controller.  Result must be read by some other method.
-        /// Used for the 'RF' command so that we can do a optomised read of the return array.
+        /// Sleeps the bus task until the response arrives (or 1 sec).
         /// @param cmd - cmd to be executed.
-        void sendCommand(String cmd);
+        /// @param wake - flush the read buffer and wake the controller first, not needed straight after another command.
+        void sendCommand(String cmd, bool wake = true);
 
         
         /// @brief Sends a command to the SpanNet controller and returns the result string
         /// @param cmd - cmd to be executed
+        /// @param wake - as for sendCommand()
         /// @return String - result string
-        String sendCommandReturnResult(String cmd);
+        String sendCommandReturnResult(String cmd, bool wake = true);
 
         /// @brief Sends the command and checks the result against the expected outcome
         /// @param cmd command to send
         /// @param expected expected string response
+        /// @param wake - as for sendCommand()
         /// @return result
-        bool sendCommandCheckResult(String cmd, String expected);
+        bool sendCommandCheckResult(String cmd, String expected, bool wake = true);
 
-        /// @brief Updates the attributes by sending the RF command and parsing the result.
+        /// @brief Starts an update of the attributes.  The RF command is sent and the result
+        /// parsed by readStatus() over the following steps of the bus task.
         void updateStatus();
 
-        void flushSerialReadBuffer() { flushSerialReadBuffer(false); };
-        String flushSerialReadBuffer(bool returnData);
-
-
-        /// @brief Stores millis time at which next update should occur
-        unsigned long _nextUpdateDue = 0;
-
-        /// @brief False until first successful read of the registers.
-        bool _initialised = false;
-
-        /// @brief If the result registers have been modified locally, need to do a fress pull from the controller
-        bool _resultRegistersDirty = true;
-
-   
-        void (*updateCallback)() = nullptr;
-
-        u_long _lastWaitMessage = millis();
+        void flushSerialReadBuffer() { flushSerialReadBuffer(nullptr); };
+        /// @brief Discard everything waiting in the serial read buffer.
+        /// @param frame If not null, the flushed bytes are appended to the raw text of this frame.
+        void flushSerialReadBuffer(SpaFrame *frame);
 
+        /// @brief Queue a line of debug output for loop() to print.  RemoteDebug isn't safe to use from two
+        /// tasks, so the bus task never calls it, see the busLogX macros.
+        /// @param level RemoteDebug level
+        void busLog(uint8_t level, const char *format, ...) __attribute__((format(printf, 3, 4)));
 
+        /// @brief Lines of debug output dropped because loop() hadn't caught up.
+        unsigned long _busLogDropped = 0;
+#pragma endregion
 
     public:
         /// @brief Init SpaInterface.
@@ -112,21 +545,152 @@ class SpaInterface : public SpaProperties {
 
         ~SpaInterface();
 
+        /// @brief Start the bus task, which from then on owns the serial port.
+        void begin();
+
         /// @brief configure how often the spa is polled in seconds.
         /// @param updateFrequency
         void setUpdateFrequency(int updateFrequency);
 
-        /// @brief Complete RF command response in a single string
-        Property<String> statusResponse;
+        /// @brief Complete RF command response in a single string.
+        /// @return Pointer to the internal frame buffer, only valid until the next read.
+        const char *getStatusResponse() { return statusFrame.c_str(); }
 
-        /// @brief To be called by loop function of main sketch.  Does regular updates, etc.
+        /// @brief Set the function to be called with the complete RF command response after each read.
+        /// @param f
+        void setStatusResponseCallback(void (*f)(const char *));
+
+        /// @brief Set the function to be called as each command completes.  Called from loop() with
+        /// the command sent and whether the spa accepted it.
+        /// @param f
+        void setCommandCallback(void (*f)(const char *, bool));
+
+        /// @brief To be called by loop function of main sketch.  Applies updates from the bus task and calls the callbacks.
         void loop();
 
+        /// @brief Run read, which takes properties with the getX() methods, so that everything it takes
+        /// is from the same frame.  For readers on another task than loop(), which could otherwise get
+        /// a mix of the old and new values of a frame being decoded.
+        ///
+        /// Nothing is locked or copied: if a frame was published while read ran, read is simply run
+        /// again, so it must only fill in its results.  While a frame is being decoded it waits for it,
+        /// unless it is called from the decoding itself (a property callback).
+        template <typename F>
+        void readConsistent(F read) {
+            for (;;) {
+                uint32_t start = _sequence.load(std::memory_order_acquire);
+                if (start & 1) {
+                    if (xTaskGetCurrentTaskHandle() == _writerTask) {
+                        read();
+                        return;
+                    }
+                    delay(1);
+                    continue;
+                }
+
+                read();
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (_sequence.load(std::memory_order_relaxed) == start) return;
+                _readRetries++;
+            }
+        }
+
+        /// @brief Times a readConsistent() reader had to run again since boot.
+        unsigned long getReadRetries() { return _readRetries; }
+
+        /// @brief Longest time spent in a single call to loop() since boot.
+        /// @return microseconds
+        unsigned long getLoopTimeMax() { return _loopTimeMax; }
+
+        /// @brief Least stack the bus task has had free since it started.
+        /// @return bytes
+        unsigned long getBusStackFree() { return _busTaskHandle != NULL ? uxTaskGetStackHighWaterMark(_busTaskHandle) : 0; }
+
+        /// @brief Lines of debug output from the bus task dropped because loop() was busy.
+        unsigned long getBusLogDropped() { return _busLogDropped; }
+
+        /// @brief Time taken by the last status read, from the wake up to the last byte.
+        /// @return milliseconds
+        unsigned long getStatusReadDuration() { return _lastStatusReadDuration; }
+
+        /// @brief Number of steps of the bus task the last status read was spread over.
+        int getStatusReadSteps() { return _lastStatusReadSteps; }
+
+        /// @brief Number of commands waiting for the bus task.
+        int getQueuedCommands();
+
+        /// @brief Number of commands that were replaced by a newer command for the same register, or
+        /// cancelled, before they were sent.
+        int getCoalescedCommands() { return _coalescedCommands; }
+
+        /// @brief Time taken by the last transaction with the spa, from the wake up to the last reply.
+        /// @return milliseconds
+        unsigned long getTransactionDuration() { return _lastTransactionDuration; }
+
+        /// @brief Number of commands in the last transaction.
+        int getTransactionSize() { return _lastTransactionSize; }
+
+        /// @brief Number of values set ahead of their commands that were put back, because the spa
+        /// rejected the command or the next frame disagreed.
+        unsigned long getOptimisticRollbacks() { return _optimisticRollbacks; }
+
+        /// @brief Current poll tier, one of PollTier.
+        PollTier getPollTier() { return _pollTier; }
+
+        /// @brief Name of a poll tier, eg "idle".
+        static const char *pollTierName(PollTier tier);
+
+        /// @brief Time between polls of the spa for the current tier.
+        /// @return seconds
+        int getPollInterval() { return _pollInterval / 1000; }
+
+        /// @brief Polls of the spa per hour, over the last complete 10 minute window.
+        unsigned long getPollsPerHour() { return _pollsPerHour; }
+
+        /// @brief Share of the time the bus was in use for polls and commands, over the last complete 10 minute window.
+        /// @return percent
+        float getBusUtilisation() { return _busUtilisation; }
+
+        /// @brief Number of registers in the RF response, R2 to RG.
+        int getRegisterCount() { return numRegisters; }
+
+        /// @brief Name of a register, eg "R2".
+        /// @param index 0 (R2) to getRegisterCount() - 1 (RG)
+        const char *getRegisterName(int index) { return registerNames[index]; }
+
+        /// @brief Number of frames in which a register was unchanged, so it wasn't decoded.
+        /// @param index 0 (R2) to getRegisterCount() - 1 (RG)
+        unsigned long getRegisterSkips(int index) { return _registerSkips[index]; }
+
+        /// @brief Recent raw RF responses (including bad reads) and commands sent to the spa.
+        FlightRecorder &getRecorder() { return _recorder; }
+
+        /// @brief Minute, 15 minute and hourly history of the water and heater temperatures, power and mains readings.
+        const PropertyHistory &getHistory() { return _history; }
+
+        /// @brief Energy used by day, week and month.  Read it within readConsistent() from another task.
+        const EnergyMeter &getEnergy() { return _energy; }
+
+        /// @brief Counts of reads and commands on the serial link, and why they failed.
+        const LinkHealth &getLinkHealth() { return _linkHealth; }
+
+        const RegisterLayout &getRegisterLayout() { return _layout; }
+
+        /// @brief Frames rejected because their registers weren't where the register layout says.
+        unsigned long getLayoutMismatches() { return _layoutMismatches; }
+
+        /// @brief Learnt timing and reply latency for a class of command.
+        /// @param commandClass one of CommandClass
+        const CommandTiming &getCommandTiming(int commandClass) { return _timing[commandClass]; }
+
         /// @brief Have we sucessfuly read the registers from the SpaNet controller.
         /// @return 
         bool isInitialised();
 
-        /// @brief Set the function to be called when properties have been updated.
+        /// @brief Set the function to be called when properties have been updated.  As well as after
+        /// each read this is called when a set changes a property ahead of its command, and again if
+        /// the change has to be put back.
         /// @param f 
         void setUpdateCallback(void (*f)());
 
@@ -135,116 +699,136 @@ class SpaInterface : public SpaProperties {
 
         /// @brief Set the desired water temperature
         /// @param temp Between 5 and 40 in 0.5 increments
-        /// @return Returns True if succesful
+        /// @return Returns True if the command was queued
         bool setSTMP(int temp);
 
         /// @brief Set snooze day ({128,127,96,31} -> {"Off","Everyday","Weekends","Weekdays"};)
         /// @param mode
-        /// @return Returns True if succesful
+        /// @return Returns True if the command was queued
         bool setL_1SNZ_DAY(int mode);
 
         /// @brief Set snooze time (provide an integer that uses this calculation HH:mm > HH*265+mm. e.g. 13:47 = 13*256+47 = 3375)
         /// @param mode
-        /// @return Returns True if succesful
+        /// @return Returns True if the command was queued
         bool setL_1SNZ_BGN(int mode);
         bool setL_1SNZ_END(int mode);
 
+        /// @brief Set snooze day, begin and end together, in a single transaction with the spa.
+        /// @param day as for setL_1SNZ_DAY
+        /// @param begin as for setL_1SNZ_BGN
+        /// @param end as for setL_1SNZ_END
+        /// @return Returns True if the commands were queued
+        bool setL_1SNZ(int day, int begin, int end);
+
         /// @brief Set snooze day ({128,127,96,31} -> {"Off","Everyday","Weekends","Weekdays"};)
         /// @param mode
-        /// @return Returns True if succesful
+        /// @return Returns True if the command was queued
         bool setL_2SNZ_DAY(int mode);
 
         /// @brief Set snooze time (provide an integer that uses this calculation HH:mm > HH*265+mm. e.g. 13:47 = 13*256+47 = 3375)
         /// @param mode
-        /// @return Returns True if succesful
+        /// @return Returns True if the command was queued
         bool setL_2SNZ_BGN(int mode);
         bool setL_2SNZ_END(int mode);
 
+        /// @brief Set snooze day, begin and end together, in a single transaction with the spa.
+        /// @return Returns True if the commands were queued
+        bool setL_2SNZ(int day, int begin, int end);
+
         /// @brief Set Heat pump operating mode (0 --> 3, {auto, heat, cool, off})
         /// @param mode 
-        /// @return Returns True if succesful
+        /// @return Returns True if the command was queued
         bool setHPMP(int mode);
         bool setHPMP(String mode);
 
         /// @brief Set light mode (0 = white, 1 = colour, 2 = step, 3 = fade, 4 = party)
         /// @param mode
-        /// @return Returns True if succesful
+        /// @return Returns True if the command was queued
         bool setColorMode(int mode);
         bool setColorMode(String mode);
 
         /// @brief Set light brightness (min 1, max 5)
         /// @param mode
-        /// @return Returns True if succesful
+        /// @return Returns True if the command was queued
         bool setLBRTValue(int mode);
 
         /// @brief Set light effect speed (min 1, max 5)
         /// @param mode
-        /// @return Returns True if succesful
+        /// @return Returns True if the command was queued
         bool setLSPDValue(int mode);
         bool setLSPDValue(String mode);
 
         /// @brief Set light colour (min 0, max 31)
         /// @param mode
-        /// @return Returns True if succesful
+        /// @return Returns True if the command was queued
         bool setCurrClr(int mode);
 
         /// @brief Set the operating mode for pump 1
         /// @param mode 0 = off, 1 = on, 4 = auto (if supported)
-        /// @return True if successful
+        /// @return True if the command was queued
         bool setRB_TP_Pump1(int mode);
 
         /// @brief Set the operating mode for pump 2
         /// @param mode 0 = off, 1 = on, 4 = auto (if supported)
-        /// @return True if successful
+        /// @return True if the command was queued
         bool setRB_TP_Pump2(int mode);
 
         /// @brief Set the operating mode for pump 3
         /// @param mode 0 = off, 1 = on, 4 = auto (if supported)
-        /// @return True if successful
+        /// @return True if the command was queued
         bool setRB_TP_Pump3(int mode);
 
         /// @brief Set the operating mode for pump 4
         /// @param mode 0 = off, 1 = on, 4 = auto (if supported)
-        /// @return True if successful
+        /// @return True if the command was queued
         bool setRB_TP_Pump4(int mode);
 
         /// @brief Set the operating mode for pump 5
         /// @param mode 0 = off, 1 = on, 4 = auto (if supported)
-        /// @return True if successful
+        /// @return True if the command was queued
         bool setRB_TP_Pump5(int mode);
 
         bool setRB_TP_Light(int mode);
 
         /// @brief Set aux element operating mode
         /// @param mode 0 = off, 1 = on
-        /// @return True if successful
+        /// @return True if the command was queued
         bool setHELE(int mode);
 
-        /// @brief Sets the clock on the spa
+        /// @brief Sets the clock on the spa, all six fields in a single transaction
         /// @param t Time
-        /// @return True if successful
+        /// @return True if the command was queued
         bool setSpaTime(time_t t);
 
         /// @brief Controls the air blower
         /// @param mode 0 = Varible, 1 = Ramp, 2 = Off
-        /// @return True if successful
+        /// @return True if the command was queued
         bool setOutlet_Blower(int mode);
 
         /// @brief Set the speed of the air blower
         /// @param mode 1 = low, 5 = high
-        /// @return True if successful
+        /// @return True if the command was queued
         bool setVARIValue(int mode);
 
         /// @brief Set Spa mode (0 --> 4, {"NORM","ECON","AWAY","WEEK"};)
         /// @param mode
-        /// @return Returns True if succesful
+        /// @return Returns True if the command was queued
         bool setMode(int mode);
         bool setMode(String mode);
+
+        /// @brief Set a property by its name in fieldMap with its setX() method, eg setField("STMP", "380").
+        /// @param value as the property is in the RF response, or the name of one of its values for an ENUM
+        /// @return false if there is no such property, it can't be set, the value isn't valid for it, or the
+        /// command couldn't be queued
+        bool setField(const char *name, const char *value);
+
+        /// @brief The property with this name in fieldMap can be set with setField().
+        bool isSettable(const char *name) { return findSetter(findField(name)) != nullptr; }
 };
 
 
 // Define the function pointer type for getPumpInstallState functions
-typedef String (SpaInterface::*GetPumpStateInstallFunction)();
+typedef const char *(SpaInterface::*GetPumpStateInstallFunction)();
 
 // Declare the array of function pointers for each pump's install state as static
 static GetPumpStateInstallFunction pumpInstallStateFunctions[] = {
@@ -0,0 +1,39 @@
+// Generated by gen_name_index.py from the names in fieldMap, don't edit.
+#pragma once
+
+#include <stdint.h>
+
+namespace SpaNameIndex {
+    const int rows = 203;
+    const int buckets = 64;
+    const int slots = 256;
+    const uint8_t noRow = 0xff;
+
+    /// @brief Seed of the second hash for each bucket.
+    const uint8_t bucketSeed[buckets] = {
+      5,   6,  22,   7,   0,   1,   3,   2,  11,   1,   2,   0,   2,   1,  61,   8,
+      1,   3,   5,  12,   4,   7,   6,   6,   7,   1,  16,   2,   1,   3,   3,   1,
+      5,   4,  17,   9,   3,   2,   1,   1,   8,   1,   2,  11,  10,   9,   3,  11,
+      8,   3,   1,   3,   3,  23,   5,   1,   3,  60,   1,  21,   1,   2,  10,   1
+    };
+
+    /// @brief Row of fieldMap in each slot, noRow if there is none.
+    const uint8_t slotRow[slots] = {
+     92,  53, 129,  99,  90,  81, 197,  59, 195,  74, 255,  63, 255, 163, 255,   1,
+    200,  67,  10, 153,  73, 255, 110, 116, 157, 255, 255, 164,   0,  87,  96, 128,
+    199, 155,  85, 150, 255, 187,  79,   6, 104, 201,  44,  50,  12, 255, 134,   5,
+     80,  61, 136, 255,  41, 159,  86, 255, 255, 255,  78, 154, 255, 255, 188,  71,
+    192, 186, 131,  65,  62,  60, 100, 124, 184,  70, 182, 178,  18,  66,  32,   3,
+     29, 190, 140, 255, 255,   7, 161, 108,  13,  25, 255, 255, 255,  89,  17,  77,
+    119, 255,  54, 152, 255, 177,  93, 120, 133,  91, 145, 196, 255,  30,  39,  38,
+    113, 255, 143, 255,  55, 121, 255,  22, 125, 255, 165, 255,  58, 255, 180, 114,
+    191,  37, 118,  27, 127, 255, 162, 255,   4, 103, 111,   9,  52, 255, 255, 170,
+    160,  43, 255, 255, 126,  20, 189,  97,  51, 130, 132,  47,  49, 255, 149,   8,
+    255, 193, 151,  33, 147, 101, 255, 255,  42,  35, 198, 255, 123, 255, 179,  84,
+    105,   2,  98, 255,  34,  31,  19, 255, 122, 158, 174, 102,  15,  57, 255, 255,
+    107, 255,  82, 255,  28,  76,  94, 109, 144,  14,  11, 181, 255, 171,  56, 185,
+    148, 138, 176, 194,  95, 141, 255, 115, 135,  23,  83, 183, 255,  64, 142, 255,
+     21, 167,  68,  88, 166, 173,  36, 255,  26, 146, 106, 202,  40,  24,  48, 172,
+    156, 255,  69, 137, 139, 112, 168, 117,  72,  45, 175,  16,  46, 169, 255,  75
+    };
+}
@@ -1,1810 +1,611 @@
 #include "SpaProperties.h"
-
-
-inline boolean isNumber(String s) {
-    if (s.isEmpty()) {
-        return false;
-    }
-    for (u_int i = 0; i < s.length(); i++) {
-        if ((!isDigit(s[i])) && !(s[i] == '-') && !(s[i]=='.')) {
-            return false;
+#include "SpaNameIndex.h"
+
+extern RemoteDebug Debug;
+
+
+// Names of the values of the enumerated properties, the index is the value.  Kept out of the
+// object, so they stay in flash.
+const std::array <const char *, 4> SpaProperties::spaModeStrings = {{"NORM", "ECON", "AWAY", "WEEK"}};
+const std::array <const char *, 2> SpaProperties::autoPumpOptions = {{"Manual", "Auto"}};
+const std::array <const char *, 2> SpaProperties::blowerStrings = {{"Variable", "Ramp"}};
+const std::array <const char *, 5> SpaProperties::colorModeStrings = {{"White", "Color", "Fade", "Step", "Party"}};
+const std::array <const char *, 5> SpaProperties::lightSpeedMap = {{"1", "2", "3", "4", "5"}};
+const std::array <const char *, 11> SpaProperties::sleepSelection = {{"Off", "Everyday", "Weekends", "Weekdays", "Monday", "Tuesday", "Wednesday", "Thuesday", "Friday", "Saturday", "Sunday"}};
+const std::array <const char *, 4> SpaProperties::HPMPStrings = {{"Auto", "Heat", "Cool", "Off"}};
+
+constexpr SpaProperties::FieldDescriptor SpaProperties::fieldMap[] = {
+#pragma region R2
+    { "MainsCurrent", R2, 1, &SpaProperties::MainsCurrent },
+    { "MainsVoltage", R2, 2, &SpaProperties::MainsVoltage },
+    { "CaseTemperature", R2, 3, &SpaProperties::CaseTemperature },
+    { "PortCurrent", R2, 4, &SpaProperties::PortCurrent },
+    { "SpaTime", R2, 6, &SpaProperties::SpaTime }, // hour, minute, second, day, month, year
+    { "HeaterTemperature", R2, 12, &SpaProperties::HeaterTemperature },
+    { "PoolTemperature", R2, 13, &SpaProperties::PoolTemperature, 10 },
+    { "WaterPresent", R2, 14, &SpaProperties::WaterPresent },
+    { "AwakeMinutesRemaining", R2, 16, &SpaProperties::AwakeMinutesRemaining },
+    { "FiltPumpRunTimeTotal", R2, 17, &SpaProperties::FiltPumpRunTimeTotal },
+    { "FiltPumpReqMins", R2, 18, &SpaProperties::FiltPumpReqMins },
+    { "LoadTimeOut", R2, 19, &SpaProperties::LoadTimeOut },
+    { "HourMeter", R2, 20, &SpaProperties::HourMeter },
+    { "Relay1", R2, 21, &SpaProperties::Relay1 },
+    { "Relay2", R2, 22, &SpaProperties::Relay2 },
+    { "Relay3", R2, 23, &SpaProperties::Relay3 },
+    { "Relay4", R2, 24, &SpaProperties::Relay4 },
+    { "Relay5", R2, 25, &SpaProperties::Relay5 },
+    { "Relay6", R2, 26, &SpaProperties::Relay6 },
+    { "Relay7", R2, 27, &SpaProperties::Relay7 },
+    { "Relay8", R2, 28, &SpaProperties::Relay8 },
+    { "Relay9", R2, 29, &SpaProperties::Relay9 },
+#pragma endregion
+#pragma region R3
+    { "CLMT", R3, 1, &SpaProperties::CLMT },
+    { "PHSE", R3, 2, &SpaProperties::PHSE },
+    { "LLM1", R3, 3, &SpaProperties::LLM1 },
+    { "LLM2", R3, 4, &SpaProperties::LLM2 },
+    { "LLM3", R3, 5, &SpaProperties::LLM3 },
+    { "SVER", R3, 6, &SpaProperties::SVER },
+    { "Model", R3, 7, &SpaProperties::Model },
+    { "SerialNo1", R3, 8, &SpaProperties::SerialNo1 },
+    { "SerialNo2", R3, 9, &SpaProperties::SerialNo2 },
+    { "D1", R3, 10, &SpaProperties::D1 },
+    { "D2", R3, 11, &SpaProperties::D2 },
+    { "D3", R3, 12, &SpaProperties::D3 },
+    { "D4", R3, 13, &SpaProperties::D4 },
+    { "D5", R3, 14, &SpaProperties::D5 },
+    { "D6", R3, 15, &SpaProperties::D6 },
+    { "Pump", R3, 16, &SpaProperties::Pump },
+    { "LS", R3, 17, &SpaProperties::LS },
+    { "HV", R3, 18, &SpaProperties::HV },
+    { "SnpMR", R3, 19, &SpaProperties::SnpMR },
+    { "Status", R3, 20, &SpaProperties::Status },
+    { "PrimeCount", R3, 21, &SpaProperties::PrimeCount },
+    { "EC", R3, 22, &SpaProperties::EC },
+    { "HAMB", R3, 23, &SpaProperties::HAMB },
+    { "HCON", R3, 24, &SpaProperties::HCON },
+    // { "HV_2", R3, 25, &SpaProperties::HV_2 },
+#pragma endregion
+#pragma region R4
+    { "Mode", R4, 1, &SpaProperties::Mode, &SpaProperties::spaModeName },
+    { "Ser1_Timer", R4, 2, &SpaProperties::Ser1_Timer },
+    { "Ser2_Timer", R4, 3, &SpaProperties::Ser2_Timer },
+    { "Ser3_Timer", R4, 4, &SpaProperties::Ser3_Timer },
+    { "HeatMode", R4, 5, &SpaProperties::HeatMode },
+    { "PumpIdleTimer", R4, 6, &SpaProperties::PumpIdleTimer },
+    { "PumpRunTimer", R4, 7, &SpaProperties::PumpRunTimer },
+    { "AdtPoolHys", R4, 8, &SpaProperties::AdtPoolHys },
+    { "AdtHeaterHys", R4, 9, &SpaProperties::AdtHeaterHys },
+    { "Power", R4, 10, &SpaProperties::Power },
+    { "Power_kWh", R4, 11, &SpaProperties::Power_kWh },
+    { "Power_Today", R4, 12, &SpaProperties::Power_Today },
+    { "Power_Yesterday", R4, 13, &SpaProperties::Power_Yesterday },
+    { "ThermalCutOut", R4, 14, &SpaProperties::ThermalCutOut },
+    { "Test_D1", R4, 15, &SpaProperties::Test_D1 },
+    { "Test_D2", R4, 16, &SpaProperties::Test_D2 },
+    { "Test_D3", R4, 17, &SpaProperties::Test_D3 },
+    { "ElementHeatSourceOffset", R4, 18, &SpaProperties::ElementHeatSourceOffset },
+    { "Frequency", R4, 19, &SpaProperties::Frequency },
+    { "HPHeatSourceOffset_Heat", R4, 20, &SpaProperties::HPHeatSourceOffset_Heat },
+    { "HPHeatSourceOffset_Cool", R4, 21, &SpaProperties::HPHeatSourceOffset_Cool },
+    { "HeatSourceOffTime", R4, 22, &SpaProperties::HeatSourceOffTime },
+    { "Vari_Speed", R4, 24, &SpaProperties::Vari_Speed },
+    { "Vari_Percent", R4, 25, &SpaProperties::Vari_Percent },
+    { "Vari_Mode", R4, 23, &SpaProperties::Vari_Mode },
+#pragma endregion
+#pragma region R5
+    // Unknown encoding - TouchPad2.updateValue();
+    // Unknown encoding - TouchPad1.updateValue();
+    // { "RB_TP_Blower", R5, 5, &SpaProperties::RB_TP_Blower },
+    { "RB_TP_Sleep", R5, 10, &SpaProperties::RB_TP_Sleep },
+    { "RB_TP_Ozone", R5, 11, &SpaProperties::RB_TP_Ozone },
+    { "RB_TP_Heater", R5, 12, &SpaProperties::RB_TP_Heater },
+    { "RB_TP_Auto", R5, 13, &SpaProperties::RB_TP_Auto },
+    { "RB_TP_Light", R5, 14, &SpaProperties::RB_TP_Light },
+    { "WTMP", R5, 15, &SpaProperties::WTMP },
+    { "CleanCycle", R5, 16, &SpaProperties::CleanCycle },
+    { "RB_TP_Pump1", R5, 18, &SpaProperties::RB_TP_Pump1 },
+    { "RB_TP_Pump2", R5, 19, &SpaProperties::RB_TP_Pump2 },
+    { "RB_TP_Pump3", R5, 20, &SpaProperties::RB_TP_Pump3 },
+    { "RB_TP_Pump4", R5, 21, &SpaProperties::RB_TP_Pump4 },
+    { "RB_TP_Pump5", R5, 22, &SpaProperties::RB_TP_Pump5 },
+#pragma endregion
+#pragma region R6
+    { "VARIValue", R6, 1, &SpaProperties::VARIValue },
+    { "LBRTValue", R6, 2, &SpaProperties::LBRTValue },
+    { "CurrClr", R6, 3, &SpaProperties::CurrClr },
+    { "ColorMode", R6, 4, &SpaProperties::ColorMode },
+    { "LSPDValue", R6, 5, &SpaProperties::LSPDValue },
+    { "FiltSetHrs", R6, 6, &SpaProperties::FiltSetHrs },
+    { "FiltBlockHrs", R6, 7, &SpaProperties::FiltBlockHrs },
+    { "STMP", R6, 8, &SpaProperties::STMP },
+    { "L_24HOURS", R6, 9, &SpaProperties::L_24HOURS },
+    { "PSAV_LVL", R6, 10, &SpaProperties::PSAV_LVL },
+    { "PSAV_BGN", R6, 11, &SpaProperties::PSAV_BGN },
+    { "PSAV_END", R6, 12, &SpaProperties::PSAV_END },
+    { "L_1SNZ_DAY", R6, 13, &SpaProperties::L_1SNZ_DAY },
+    { "L_2SNZ_DAY", R6, 14, &SpaProperties::L_2SNZ_DAY },
+    { "L_1SNZ_BGN", R6, 15, &SpaProperties::L_1SNZ_BGN },
+    { "L_2SNZ_BGN", R6, 16, &SpaProperties::L_2SNZ_BGN },
+    { "L_1SNZ_END", R6, 17, &SpaProperties::L_1SNZ_END },
+    { "L_2SNZ_END", R6, 18, &SpaProperties::L_2SNZ_END },
+    { "DefaultScrn", R6, 19, &SpaProperties::DefaultScrn },
+    { "TOUT", R6, 20, &SpaProperties::TOUT },
+    { "VPMP", R6, 21, &SpaProperties::VPMP },
+    { "HIFI", R6, 22, &SpaProperties::HIFI },
+    { "BRND", R6, 23, &SpaProperties::BRND },
+    { "PRME", R6, 24, &SpaProperties::PRME },
+    { "ELMT", R6, 25, &SpaProperties::ELMT },
+    { "TYPE", R6, 26, &SpaProperties::TYPE },
+    { "GAS", R6, 27, &SpaProperties::GAS },
+#pragma endregion
+#pragma region R7
+    { "WCLNTime", R7, 1, &SpaProperties::WCLNTime },
+    // The following 2 may be reversed
+    { "TemperatureUnits", R7, 3, &SpaProperties::TemperatureUnits },
+    { "OzoneOff", R7, 2, &SpaProperties::OzoneOff },
+    { "Ozone24", R7, 4, &SpaProperties::Ozone24 },
+    { "Circ24", R7, 6, &SpaProperties::Circ24 },
+    { "CJET", R7, 5, &SpaProperties::CJET },
+    // 0 = off, 1 = step, 2 = variable
+    { "VELE", R7, 7, &SpaProperties::VELE },
+    // { "StartDD", R7, 8, &SpaProperties::StartDD },
+    // { "StartMM", R7, 9, &SpaProperties::StartMM },
+    // { "StartYY", R7, 10, &SpaProperties::StartYY },
+    { "V_Max", R7, 11, &SpaProperties::V_Max },
+    { "V_Min", R7, 12, &SpaProperties::V_Min },
+    { "V_Max_24", R7, 13, &SpaProperties::V_Max_24 },
+    { "V_Min_24", R7, 14, &SpaProperties::V_Min_24 },
+    { "CurrentZero", R7, 15, &SpaProperties::CurrentZero },
+    { "CurrentAdjust", R7, 16, &SpaProperties::CurrentAdjust },
+    { "VoltageAdjust", R7, 17, &SpaProperties::VoltageAdjust },
+    // 168 is unknown
+    { "Ser1", R7, 19, &SpaProperties::Ser1 },
+    { "Ser2", R7, 20, &SpaProperties::Ser2 },
+    { "Ser3", R7, 21, &SpaProperties::Ser3 },
+    { "VMAX", R7, 22, &SpaProperties::VMAX },
+    { "AHYS", R7, 23, &SpaProperties::AHYS },
+    { "HUSE", R7, 24, &SpaProperties::HUSE, FieldDescriptor::NUMBER_BOOL },
+    { "HELE", R7, 25, &SpaProperties::HELE },
+    { "HPMP", R7, 26, &SpaProperties::HPMP, &SpaProperties::HPMPName, FieldDescriptor::NUMBER_ENUM },
+    { "PMIN", R7, 27, &SpaProperties::PMIN },
+    { "PFLT", R7, 28, &SpaProperties::PFLT },
+    { "PHTR", R7, 29, &SpaProperties::PHTR },
+    { "PMAX", R7, 30, &SpaProperties::PMAX },
+#pragma endregion
+#pragma region R9
+    { "F1_HR", R9, 2, &SpaProperties::F1_HR },
+    { "F1_Time", R9, 3, &SpaProperties::F1_Time },
+    { "F1_ER", R9, 4, &SpaProperties::F1_ER },
+    { "F1_I", R9, 5, &SpaProperties::F1_I },
+    { "F1_V", R9, 6, &SpaProperties::F1_V },
+    { "F1_PT", R9, 7, &SpaProperties::F1_PT },
+    { "F1_HT", R9, 8, &SpaProperties::F1_HT },
+    { "F1_CT", R9, 9, &SpaProperties::F1_CT },
+    { "F1_PU", R9, 10, &SpaProperties::F1_PU },
+    { "F1_VE", R9, 11, &SpaProperties::F1_VE },
+    { "F1_ST", R9, 12, &SpaProperties::F1_ST },
+#pragma endregion
+#pragma region RA
+    { "F2_HR", RA, 2, &SpaProperties::F2_HR },
+    { "F2_Time", RA, 3, &SpaProperties::F2_Time },
+    { "F2_ER", RA, 4, &SpaProperties::F2_ER },
+    { "F2_I", RA, 5, &SpaProperties::F2_I },
+    { "F2_V", RA, 6, &SpaProperties::F2_V },
+    { "F2_PT", RA, 7, &SpaProperties::F2_PT },
+    { "F2_HT", RA, 8, &SpaProperties::F2_HT },
+    { "F2_CT", RA, 9, &SpaProperties::F2_CT },
+    { "F2_PU", RA, 10, &SpaProperties::F2_PU },
+    { "F2_VE", RA, 11, &SpaProperties::F2_VE },
+    { "F2_ST", RA, 12, &SpaProperties::F2_ST },
+#pragma endregion
+#pragma region RB
+    { "F3_HR", RB, 2, &SpaProperties::F3_HR },
+    { "F3_Time", RB, 3, &SpaProperties::F3_Time },
+    { "F3_ER", RB, 4, &SpaProperties::F3_ER },
+    { "F3_I", RB, 5, &SpaProperties::F3_I },
+    { "F3_V", RB, 6, &SpaProperties::F3_V },
+    { "F3_PT", RB, 7, &SpaProperties::F3_PT },
+    { "F3_HT", RB, 8, &SpaProperties::F3_HT },
+    { "F3_CT", RB, 9, &SpaProperties::F3_CT },
+    { "F3_PU", RB, 10, &SpaProperties::F3_PU },
+    { "F3_VE", RB, 11, &SpaProperties::F3_VE },
+    { "F3_ST", RB, 12, &SpaProperties::F3_ST },
+#pragma endregion
+#pragma region RC
+    // Outlet_Heater - offset unknown
+    // Outlet_Circ - offset unknown
+    // Outlet_Sanitise - offset unknown
+    // Outlet_Pump1 - offset unknown
+    // Outlet_Pump2 - offset unknown
+    // Outlet_Pump4 - offset unknown
+    // Outlet_Pump5 - offset unknown
+    { "Outlet_Blower", RC, 10, &SpaProperties::Outlet_Blower },
+#pragma endregion
+#pragma region RE
+    { "HP_Present", RE, 1, &SpaProperties::HP_Present },
+    // HP_FlowSwitch - offset unknown
+    // HP_HighSwitch - offset unknown
+    // HP_LowSwitch - offset unknown
+    // HP_CompCutOut - offset unknown
+    // HP_ExCutOut - offset unknown
+    // HP_D1 - offset unknown
+    // HP_D2 - offset unknown
+    // HP_D3 - offset unknown
+    { "HP_Ambient", RE, 10, &SpaProperties::HP_Ambient },
+    { "HP_Condensor", RE, 11, &SpaProperties::HP_Condensor },
+    { "HP_Compressor_State", RE, 12, &SpaProperties::HP_Compressor_State },
+    { "HP_Fan_State", RE, 13, &SpaProperties::HP_Fan_State },
+    { "HP_4W_Valve", RE, 14, &SpaProperties::HP_4W_Valve },
+    { "HP_Heater_State", RE, 15, &SpaProperties::HP_Heater_State },
+    { "HP_State", RE, 16, &SpaProperties::HP_State },
+    { "HP_Mode", RE, 17, &SpaProperties::HP_Mode },
+    { "HP_Defrost_Timer", RE, 18, &SpaProperties::HP_Defrost_Timer },
+    { "HP_Comp_Run_Timer", RE, 19, &SpaProperties::HP_Comp_Run_Timer },
+    { "HP_Low_Temp_Timer", RE, 20, &SpaProperties::HP_Low_Temp_Timer },
+    { "HP_Heat_Accum_Timer", RE, 21, &SpaProperties::HP_Heat_Accum_Timer },
+    { "HP_Sequence_Timer", RE, 22, &SpaProperties::HP_Sequence_Timer },
+    { "HP_Warning", RE, 23, &SpaProperties::HP_Warning },
+    { "FrezTmr", RE, 24, &SpaProperties::FrezTmr },
+    { "DBGN", RE, 25, &SpaProperties::DBGN },
+    { "DEND", RE, 26, &SpaProperties::DEND },
+    { "DCMP", RE, 27, &SpaProperties::DCMP },
+    { "DMAX", RE, 28, &SpaProperties::DMAX },
+    { "DELE", RE, 29, &SpaProperties::DELE },
+    { "DPMP", RE, 30, &SpaProperties::DPMP },
+    // CMAX - offset unknown
+    // HP_Compressor - offset unknown
+    // HP_Pump_State - offset unknown
+    // HP_Status - offset unknown
+#pragma endregion
+#pragma region RG
+    { "Pump1InstallState", RG, 7, &SpaProperties::Pump1InstallState },
+    { "Pump2InstallState", RG, 8, &SpaProperties::Pump2InstallState },
+    { "Pump3InstallState", RG, 9, &SpaProperties::Pump3InstallState },
+    { "Pump4InstallState", RG, 10, &SpaProperties::Pump4InstallState },
+    { "Pump5InstallState", RG, 11, &SpaProperties::Pump5InstallState },
+    { "Pump1OkToRun", RG, 1, &SpaProperties::Pump1OkToRun },
+    { "Pump2OkToRun", RG, 2, &SpaProperties::Pump2OkToRun },
+    { "Pump3OkToRun", RG, 3, &SpaProperties::Pump3OkToRun },
+    { "Pump4OkToRun", RG, 4, &SpaProperties::Pump4OkToRun },
+    { "Pump5OkToRun", RG, 5, &SpaProperties::Pump5OkToRun },
+    { "LockMode", RG, 12, &SpaProperties::LockMode },
+#pragma endregion
+};
+
+const SpaProperties::FieldDescriptor *SpaProperties::findField(Property<int> SpaProperties::*property) {
+    for (int i = 0; i < fieldMapSize; i++) {
+        if (fieldMap[i].storesInt() && fieldMap[i].member.i == property) return &fieldMap[i];
+    }
+    return nullptr;
+}
+
+const SpaProperties::FieldDescriptor *SpaProperties::findField(Property<bool> SpaProperties::*property) {
+    for (int i = 0; i < fieldMapSize; i++) {
+        if ((fieldMap[i].type == FieldDescriptor::BOOL || fieldMap[i].type == FieldDescriptor::NUMBER_BOOL) && fieldMap[i].member.b == property) return &fieldMap[i];
+    }
+    return nullptr;
+}
+
+const SpaProperties::FieldDescriptor *SpaProperties::findField(Property<PropertyString> SpaProperties::*property) {
+    for (int i = 0; i < fieldMapSize; i++) {
+        if (fieldMap[i].type == FieldDescriptor::STRING && fieldMap[i].member.s == property) return &fieldMap[i];
+    }
+    return nullptr;
+}
+
+#pragma region Name index
+// Perfect hash of the names in fieldMap, by hash and displace: the first hash of a name picks a
+// bucket, and each bucket has the seed of a second hash that gives every name in it a slot of its own.
+// The tables are in SpaNameIndex.h, which gen_name_index.py writes before each build, and the build
+// stops there if the names can't be placed.  A lookup is two hashes and one strcmp, to turn away
+// names that aren't in fieldMap.
+static_assert(SpaNameIndex::rows == SpaProperties::fieldMapSize, "SpaNameIndex.h is out of date, run gen_name_index.py");
+
+namespace {
+    uint32_t nameHash(const char *name, uint8_t seed) {
+        // FNV-1a from a seeded basis, then mixed so the low bits used for the slot depend on every character.
+        // Must match name_hash() in gen_name_index.py.
+        uint32_t hash = (2166136261u ^ seed) * 16777619u;
+        for (; *name; name++) hash = (hash ^ (uint8_t)*name) * 16777619u;
+        hash ^= hash >> 15;
+        hash *= 0x2c1b3c6du;
+        hash ^= hash >> 12;
+        return hash;
+    }
+}
+
+const SpaProperties::FieldDescriptor *SpaProperties::findField(const char *name) {
+    using namespace SpaNameIndex;
+    uint8_t row = slotRow[nameHash(name, bucketSeed[nameHash(name, 0) % buckets]) % slots];
+    if (row == noRow || strcmp(fieldMap[row].name, name) != 0) return nullptr;
+    return &fieldMap[row];
+}
+#pragma endregion
+
+/// @brief Row of fieldMap with this name and one of the types, or nullptr.
+static const SpaProperties::FieldDescriptor *findNamedField(const char *name, SpaProperties::FieldDescriptor::Type type,
+        SpaProperties::FieldDescriptor::Type alternative) {
+    const SpaProperties::FieldDescriptor *field = SpaProperties::findField(name);
+    if (field == nullptr || (field->type != type && field->type != alternative)) return nullptr;
+    return field;
+}
+
+SpaProperties::SpaProperties() {
+    assignSlots();
+
+    // These jitter by a step or two on almost every read
+    setDeadband("MainsCurrent", 2, 0, defaultMaxSilence);       // 0.2 A
+    setDeadband("MainsVoltage", 2, 0, defaultMaxSilence);       // 2 V
+    setDeadband("CaseTemperature", 5, 0, defaultMaxSilence);    // 0.5 'C
+    setDeadband("PortCurrent", 20, 0, defaultMaxSilence);       // 20 mA
+    setDeadband("Power", 0, 5, defaultMaxSilence);              // 5%
+}
+
+void SpaProperties::assignSlots() {
+    // fieldMap is sized in the class, so a missing row would only show as an empty one
+    static_assert(fieldMap[fieldMapSize - 1].name != nullptr, "fieldMap has fewer rows than fieldMapSize");
+    static_assert(intSlots == countProperties(FieldDescriptor::INT_STORE, 0, fieldMapSize) + 1, "intSlots doesn't match fieldMap");
+    static_assert(boolSlots == countProperties(FieldDescriptor::BOOL_STORE, 0, fieldMapSize) + 1, "boolSlots doesn't match fieldMap");
+    static_assert(stringSlots == countProperties(FieldDescriptor::STRING_STORE, 0, fieldMapSize) + 1, "stringSlots doesn't match fieldMap");
+    static_assert(timeSlots == countProperties(FieldDescriptor::TIME_STORE, 0, fieldMapSize) + 1, "timeSlots doesn't match fieldMap");
+
+    int ints = 1, bools = 1, strings = 1, times = 1;
+    for (int i = 0; i < fieldMapSize; i++) {
+        const FieldDescriptor &field = fieldMap[i];
+        switch (field.type) {
+            case FieldDescriptor::INT:
+            case FieldDescriptor::ENUM:
+            case FieldDescriptor::NUMBER_ENUM:
+                if ((this->*field.member.i)._slot == 0) (this->*field.member.i)._slot = ints++;
+                break;
+            case FieldDescriptor::BOOL:
+            case FieldDescriptor::NUMBER_BOOL:
+                if ((this->*field.member.b)._slot == 0) (this->*field.member.b)._slot = bools++;
+                break;
+            case FieldDescriptor::STRING:
+                if ((this->*field.member.s)._slot == 0) (this->*field.member.s)._slot = strings++;
+                break;
+            case FieldDescriptor::TIME:
+                if ((this->*field.member.t)._slot == 0) (this->*field.member.t)._slot = times++;
+                break;
         }
     }
-    return true;
-}
-
-boolean SpaProperties::update_MainsCurrent(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    MainsCurrent.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_SpaTime(String year, String month, String day, String hour, String minute, String second){
-
-    tmElements_t tm;
-    tm.Year=CalendarYrToTm(year.toInt());
-    tm.Month=month.toInt();
-    tm.Day=day.toInt();
-    tm.Hour=hour.toInt();
-    tm.Minute=minute.toInt();
-    tm.Second=second.toInt();
-
-    SpaTime.update_Value(makeTime(tm));
-
-    return true;
-}
-
-boolean SpaProperties::update_MainsVoltage(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    MainsVoltage.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_CaseTemperature(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    CaseTemperature.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_PortCurrent(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    PortCurrent.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HeaterTemperature(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HeaterTemperature.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_PoolTemperature(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    PoolTemperature.update_Value(s.toFloat() / 10);
-    return true;
-}
-
-boolean SpaProperties::update_WaterPresent(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    WaterPresent.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_AwakeMinutesRemaining(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    AwakeMinutesRemaining.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_FiltPumpRunTimeTotal(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    FiltPumpRunTimeTotal.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_FiltPumpReqMins(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    FiltPumpReqMins.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_LoadTimeOut(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    LoadTimeOut.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HourMeter(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HourMeter.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Relay1(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Relay1.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Relay2(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Relay2.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Relay3(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Relay3.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Relay4(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Relay4.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Relay5(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Relay5.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Relay6(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Relay6.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Relay7(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Relay7.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Relay8(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Relay8.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Relay9(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Relay9.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_CLMT(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    CLMT.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_PHSE(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    PHSE.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_LLM1(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    LLM1.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_LLM2(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    LLM2.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_LLM3(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    LLM3.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_SVER(String s){
-    SVER.update_Value(s);
-    return true;
-}
-
-boolean SpaProperties::update_Model(String s){
-    Model.update_Value(s);
-    return true;
-}
-
-boolean SpaProperties::update_SerialNo1(String s){
-    SerialNo1.update_Value(s);
-    return true;
-}
-
-boolean SpaProperties::update_SerialNo2(String s){
-    SerialNo2.update_Value(s);
-    return true;
-}
-
-boolean SpaProperties::update_D1(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    D1.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_D2(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    D2.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_D3(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    D3.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_D4(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    D4.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_D5(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    D5.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_D6(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    D6.update_Value( s == "1" );
-    return true;
 }
 
-boolean SpaProperties::update_Pump(String s){
-    Pump.update_Value(s);
-    return true;
-}
-
-boolean SpaProperties::update_LS(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
+bool SpaProperties::setDeadband(const char *name, long absolute, uint8_t relativePercent, unsigned long maxSilence) {
+    const FieldDescriptor *field = findNamedField(name, FieldDescriptor::INT, FieldDescriptor::INT);
+    if (field == nullptr) return false;
 
-    LS.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HV(String s) {
-    if (s!="0" && s!="1") {
-        return false;
+    FieldHooks *hooks = findHooks(field - fieldMap);
+    PropertyDeadband *deadband = hooks != nullptr ? hooks->deadband : nullptr;
+    if (deadband == nullptr) {
+        if (_deadbandCount == maxDeadbands) return false;
+        hooks = addHooks(field - fieldMap);
+        if (hooks == nullptr) return false;
+        deadband = &_deadbands[_deadbandCount++];
+        hooks->deadband = deadband;
     }
 
-    HV.update_Value( s == "1" );
+    deadband->configure(field->name, absolute, relativePercent, maxSilence);
     return true;
 }
 
-boolean SpaProperties::update_SnpMR(String s){
-    if (!isNumber(s)) {
-        return false;
+SpaProperties::FieldHooks *SpaProperties::findHooks(int row) {
+    for (int i = 0; i < maxHookedFields; i++) {
+        if (_hooks[i].row == row && row >= 0) return &_hooks[i];
     }
-
-    SnpMR.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Status(String s){
-    Status.update_Value(s);
-    return true;
+    return nullptr;
 }
 
-boolean SpaProperties::update_PrimeCount(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    PrimeCount.update_Value(s.toInt());
-    return true;
-}
+SpaProperties::FieldHooks *SpaProperties::addHooks(int row) {
+    if (row < 0) return nullptr;
+    FieldHooks *hooks = findHooks(row);
+    if (hooks != nullptr) return hooks;
 
-boolean SpaProperties::update_EC(String s){
-    if (!isNumber(s)) {
-        return false;
+    for (int i = 0; i < maxHookedFields && hooks == nullptr; i++) {
+        if (_hooks[i].row == -1) hooks = &_hooks[i];
     }
-
-    EC.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HAMB(String s){
-    if (!isNumber(s)) {
-        return false;
+    if (hooks == nullptr) {
+        debugW("Can't listen to %s, already listening to %d properties", fieldMap[row].name, maxHookedFields);
+        return nullptr;
     }
-
-    HAMB.update_Value(s.toInt());
-    return true;
+    hooks->row = row;
+    return hooks;
 }
 
-boolean SpaProperties::update_HCON(String s){
-    if (!isNumber(s)) {
-        return false;
+int SpaProperties::rowOf(const Property<int> &property) {
+    for (int i = 0; i < fieldMapSize; i++) {
+        if (fieldMap[i].storesInt() && &(this->*fieldMap[i].member.i) == &property) return i;
     }
-
-    HCON.update_Value(s.toInt());
-    return true;
+    return -1;
 }
 
-boolean SpaProperties::update_Mode(String s){
-    Mode.update_Value(s);
-    return true;
-}
-
-boolean SpaProperties::update_Ser1_Timer(String s){
-    if (!isNumber(s)) {
-        return false;
+int SpaProperties::rowOf(const Property<bool> &property) {
+    for (int i = 0; i < fieldMapSize; i++) {
+        if ((fieldMap[i].type == FieldDescriptor::BOOL || fieldMap[i].type == FieldDescriptor::NUMBER_BOOL) && &(this->*fieldMap[i].member.b) == &property) return i;
     }
-
-    Ser1_Timer.update_Value(s.toInt());
-    return true;
+    return -1;
 }
 
-boolean SpaProperties::update_Ser2_Timer(String s){
-    if (!isNumber(s)) {
-        return false;
+int SpaProperties::rowOf(const Property<PropertyString> &property) {
+    for (int i = 0; i < fieldMapSize; i++) {
+        if (fieldMap[i].type == FieldDescriptor::STRING && &(this->*fieldMap[i].member.s) == &property) return i;
     }
-
-    Ser2_Timer.update_Value(s.toInt());
-    return true;
+    return -1;
 }
 
-boolean SpaProperties::update_Ser3_Timer(String s){
-    if (!isNumber(s)) {
-        return false;
+int SpaProperties::rowOf(const Property<time_t> &property) {
+    for (int i = 0; i < fieldMapSize; i++) {
+        if (fieldMap[i].type == FieldDescriptor::TIME && &(this->*fieldMap[i].member.t) == &property) return i;
     }
-
-    Ser3_Timer.update_Value(s.toInt());
-    return true;
+    return -1;
 }
 
-boolean SpaProperties::update_HeatMode(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HeatMode.update_Value(s.toInt());
-    return true;
+int SpaProperties::namedRow(const char *name, PropertySubscription<int> &) {
+    const FieldDescriptor *field = findField(name);
+    return field == nullptr || !field->storesInt() ? -1 : field - fieldMap;
 }
 
-boolean SpaProperties::update_PumpIdleTimer(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    PumpIdleTimer.update_Value(s.toInt());
-    return true;
+int SpaProperties::namedRow(const char *name, PropertySubscription<bool> &) {
+    const FieldDescriptor *field = findNamedField(name, FieldDescriptor::BOOL, FieldDescriptor::NUMBER_BOOL);
+    return field == nullptr ? -1 : field - fieldMap;
 }
 
-boolean SpaProperties::update_PumpRunTimer(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    PumpRunTimer.update_Value(s.toInt());
-    return true;
+int SpaProperties::namedRow(const char *name, PropertySubscription<PropertyString> &) {
+    const FieldDescriptor *field = findNamedField(name, FieldDescriptor::STRING, FieldDescriptor::STRING);
+    return field == nullptr ? -1 : field - fieldMap;
 }
 
-boolean SpaProperties::update_AdtPoolHys(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    AdtPoolHys.update_Value(s.toInt());
-    return true;
+int SpaProperties::namedRow(const char *name, PropertySubscription<time_t> &) {
+    const FieldDescriptor *field = findNamedField(name, FieldDescriptor::TIME, FieldDescriptor::TIME);
+    return field == nullptr ? -1 : field - fieldMap;
 }
 
-boolean SpaProperties::update_AdtHeaterHys(String s){
-    if (!isNumber(s)) {
-        return false;
+void SpaProperties::notifySubscribers() {
+    for (int i = 0; i < maxHookedFields; i++) {
+        if (_hooks[i].row < 0) continue;
+        const FieldDescriptor &field = fieldMap[_hooks[i].row];
+        switch (field.type) {
+            case FieldDescriptor::INT:
+            case FieldDescriptor::ENUM:
+            case FieldDescriptor::NUMBER_ENUM:
+                notifyPending(_hooks[i], this->*field.member.i);
+                break;
+            case FieldDescriptor::BOOL:
+            case FieldDescriptor::NUMBER_BOOL:
+                notifyPending(_hooks[i], this->*field.member.b);
+                break;
+            case FieldDescriptor::STRING:
+                notifyPending(_hooks[i], this->*field.member.s);
+                break;
+            case FieldDescriptor::TIME:
+                notifyPending(_hooks[i], this->*field.member.t);
+                break;
+        }
     }
-
-    AdtHeaterHys.update_Value(s.toInt());
-    return true;
 }
 
-boolean SpaProperties::update_Power(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Power.update_Value(s.toInt());
-    return true;
-}
+int SpaProperties::changedSince(uint32_t generation, uint16_t *rows, int maxRows) {
+    int count = 0;
+    for (int i = 0; i < fieldMapSize && count < maxRows; i++) {
+        if (_changedGeneration[i] > generation) rows[count++] = i;
+    }
+    return count;
+}
+
+boolean SpaProperties::updateField(const FieldDescriptor &field, SpaField s) {
+    long number;
+
+    switch (field.type) {
+        case FieldDescriptor::INT:
+            if (!s.parseNumber(number, field.scale)) {
+                return false;
+            }
+            updateValue(field, this->*field.member.i, (int)number);
+            return true;
+
+        case FieldDescriptor::BOOL:
+            if (!s.equals("0") && !s.equals("1")) {
+                return false;
+            }
+            updateValue(field, this->*field.member.b, s.equals("1"));
+            return true;
+
+        case FieldDescriptor::NUMBER_BOOL:
+            if (!s.parseNumber(number)) {
+                return false;
+            }
+            updateValue(field, this->*field.member.b, number != 0);
+            return true;
+
+        case FieldDescriptor::STRING: {
+            // compared in the field first, so an unchanged value isn't copied
+            if (s.equals(value(this->*field.member.s).c_str())) {
+                return true;
+            }
+            PropertyString text;
+            text.assign(s.data, s.length);
+            updateValue(field, this->*field.member.s, text);
+            return true;
+        }
 
-boolean SpaProperties::update_Power_kWh(String s){
-    if (!isNumber(s)) {
-        return false;
+        case FieldDescriptor::ENUM:
+        case FieldDescriptor::NUMBER_ENUM:
+            for (int i = 0; field.enumName(i) != nullptr; i++) {
+                if (s.equals(field.enumName(i))) {
+                    updateValue(field, this->*field.member.i, i);
+                    return true;
+                }
+            }
+
+            if (field.type == FieldDescriptor::NUMBER_ENUM) {
+                if (!s.parseNumber(number)) {
+                    return false;
+                }
+                // A mode newer than HPMPStrings is still a mode, so it is kept as the number
+                if (field.enumName(number) == nullptr && value(this->*field.member.i) != number) {
+                    debugW("Unknown %s %ld", field.name, number);
+                }
+                updateValue(field, this->*field.member.i, (int)number);
+                return true;
+            }
+
+            // A name we don't know is kept as text, rather than leaving the last mode showing
+            if (s.isEmpty()) {
+                return false;
+            }
+            if (value(this->*field.member.i) != unknownEnum || !s.equals(_unknownEnumText.c_str())) {
+                debugW("Unknown %s %.*s", field.name, (int)s.length, s.data);
+                _unknownEnumText.assign(s.data, s.length);
+                // Still unknownEnum if the last was unknown too, but the text shown has changed
+                updateValue(field, this->*field.member.i, (int)unknownEnum, true);
+            }
+            return true;
+
+        default:
+            return false;
     }
-
-    Power_kWh.update_Value(s.toInt());
-    return true;
 }
 
-boolean SpaProperties::update_Power_Today(String s){
-    if (!isNumber(s)) {
-        return false;
+boolean SpaProperties::updateField(const FieldDescriptor &field, const SpaFrame &frame, int index) {
+    if (field.type != FieldDescriptor::TIME) {
+        return updateField(field, frame.field(index));
     }
 
-    Power_Today.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Power_Yesterday(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
+    tmElements_t tm;
+    tm.Hour=frame.field(index).toInt();
+    tm.Minute=frame.field(index + 1).toInt();
+    tm.Second=frame.field(index + 2).toInt();
+    tm.Day=frame.field(index + 3).toInt();
+    tm.Month=frame.field(index + 4).toInt();
+    tm.Year=CalendarYrToTm(frame.field(index + 5).toInt());
 
-    Power_Yesterday.update_Value(s.toInt());
+    updateValue(field, this->*field.member.t, makeTime(tm));
     return true;
 }
 
-boolean SpaProperties::update_ThermalCutOut(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
+String SpaProperties::fieldText(const FieldDescriptor &field) {
+    switch (field.type) {
+        case FieldDescriptor::INT:
+            return String(value(this->*field.member.i) * field.scale);
 
-    ThermalCutOut.update_Value(s.toInt());
-    return true;
-}
+        case FieldDescriptor::BOOL:
+        case FieldDescriptor::NUMBER_BOOL:
+            return value(this->*field.member.b) ? "1" : "0";
 
-boolean SpaProperties::update_Test_D1(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
+        case FieldDescriptor::STRING:
+            return value(this->*field.member.s).c_str();
 
-    Test_D1.update_Value(s.toInt());
-    return true;
-}
+        case FieldDescriptor::ENUM:
+        case FieldDescriptor::NUMBER_ENUM: {
+            int index = value(this->*field.member.i);
+            const char *name = field.enumName(index);
+            if (name != nullptr) return name;
+            return field.type == FieldDescriptor::ENUM ? String(_unknownEnumText.c_str()) : String(index);
+        }
 
-boolean SpaProperties::update_Test_D2(String s){
-    if (!isNumber(s)) {
-        return false;
+        default:
+            return "";
     }
-
-    Test_D2.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Test_D3(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Test_D3.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_ElementHeatSourceOffset(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    ElementHeatSourceOffset.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Frequency(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Frequency.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HPHeatSourceOffset_Heat(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HPHeatSourceOffset_Heat.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HPHeatSourceOffset_Cool(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HPHeatSourceOffset_Cool.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HeatSourceOffTime(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HeatSourceOffTime.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Vari_Speed(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Vari_Speed.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Vari_Percent(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Vari_Percent.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Vari_Mode(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Vari_Mode.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_RB_TP_Pump1(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    RB_TP_Pump1.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_RB_TP_Pump2(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    RB_TP_Pump2.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_RB_TP_Pump3(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    RB_TP_Pump3.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_RB_TP_Pump4(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    RB_TP_Pump4.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_RB_TP_Pump5(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    RB_TP_Pump5.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_RB_TP_Blower(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    RB_TP_Blower.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_RB_TP_Light(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    RB_TP_Light.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_RB_TP_Auto(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    RB_TP_Auto.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_RB_TP_Heater(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    RB_TP_Heater.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_RB_TP_Ozone(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    RB_TP_Ozone.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_RB_TP_Sleep(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    RB_TP_Sleep.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_WTMP(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    WTMP.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_CleanCycle(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    CleanCycle.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_VARIValue(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    VARIValue.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_LBRTValue(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    LBRTValue.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_CurrClr(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    CurrClr.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_ColorMode(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    ColorMode.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_LSPDValue(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    LSPDValue.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_FiltSetHrs(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    FiltSetHrs.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_FiltBlockHrs(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    FiltBlockHrs.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_STMP(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    STMP.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_L_24HOURS(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    L_24HOURS.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_PSAV_LVL(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    PSAV_LVL.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_PSAV_BGN(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    PSAV_BGN.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_PSAV_END(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    PSAV_END.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_L_1SNZ_DAY(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    L_1SNZ_DAY.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_L_2SNZ_DAY(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    L_2SNZ_DAY.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_L_1SNZ_BGN(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    L_1SNZ_BGN.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_L_2SNZ_BGN(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    L_2SNZ_BGN.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_L_1SNZ_END(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    L_1SNZ_END.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_L_2SNZ_END(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    L_2SNZ_END.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_DefaultScrn(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    DefaultScrn.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_TOUT(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    TOUT.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_VPMP(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    VPMP.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_HIFI(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    HIFI.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_BRND(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    BRND.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_PRME(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    PRME.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_ELMT(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    ELMT.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_TYPE(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    TYPE.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_GAS(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    GAS.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_WCLNTime(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    WCLNTime.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_TemperatureUnits(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    TemperatureUnits.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_OzoneOff(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    OzoneOff.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_Ozone24(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    Ozone24.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_Circ24(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    Circ24.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_CJET(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    CJET.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_VELE(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    VELE.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_V_Max(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    V_Max.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_V_Min(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    V_Min.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_V_Max_24(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    V_Max_24.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_V_Min_24(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    V_Min_24.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_CurrentZero(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    CurrentZero.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_CurrentAdjust(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    CurrentAdjust.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_VoltageAdjust(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    VoltageAdjust.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Ser1(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Ser1.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Ser2(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Ser2.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Ser3(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Ser3.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_VMAX(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    VMAX.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_AHYS(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    AHYS.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HUSE(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HUSE.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HELE(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    HELE.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_HPMP(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HPMP.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_PMIN(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    PMIN.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_PFLT(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    PFLT.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_PHTR(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    PHTR.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_PMAX(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    PMAX.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F1_HR(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F1_HR.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F1_Time(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F1_Time.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F1_ER(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F1_ER.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F1_I(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F1_I.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F1_V(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F1_V.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F1_PT(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F1_PT.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F1_HT(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F1_HT.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F1_CT(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F1_CT.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F1_ST(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F1_ST.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F1_PU(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F1_PU.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F1_VE(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    F1_VE.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_F2_HR(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F2_HR.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F2_Time(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F2_Time.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F2_ER(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F2_ER.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F2_I(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F2_I.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F2_V(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F2_V.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F2_PT(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F2_PT.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F2_HT(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F2_HT.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F2_CT(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F2_CT.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F2_ST(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F2_ST.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F2_PU(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F2_PU.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F2_VE(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    F2_VE.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_F3_HR(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F3_HR.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F3_Time(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F3_Time.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F3_ER(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F3_ER.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F3_I(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F3_I.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F3_V(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F3_V.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F3_PT(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F3_PT.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F3_HT(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F3_HT.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F3_CT(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F3_CT.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F3_ST(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F3_ST.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F3_PU(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    F3_PU.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_F3_VE(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    F3_VE.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_Outlet_Blower(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    Outlet_Blower.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HP_Present(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HP_Present.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HP_Ambient(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HP_Ambient.update_Value(s.toInt());
-    return true;
-}
-
-
-boolean SpaProperties::update_HP_Condensor(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HP_Condensor.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HP_Compressor_State(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    HP_Compressor_State.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_HP_Fan_State(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    HP_Fan_State.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_HP_4W_Valve(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    HP_4W_Valve.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_HP_Heater_State(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    HP_Heater_State.update_Value( s == "1" );
-    return true;
-}
-
-
-boolean SpaProperties::update_HP_State(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HP_State.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HP_Mode(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HP_Mode.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HP_Defrost_Timer(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HP_Defrost_Timer.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HP_Comp_Run_Timer(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HP_Comp_Run_Timer.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HP_Low_Temp_Timer(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HP_Low_Temp_Timer.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HP_Heat_Accum_Timer(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HP_Heat_Accum_Timer.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HP_Sequence_Timer(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HP_Sequence_Timer.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_HP_Warning(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    HP_Warning.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_FrezTmr(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    FrezTmr.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_DBGN(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    DBGN.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_DEND(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    DEND.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_DCMP(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    DCMP.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_DMAX(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    DMAX.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_DELE(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    DELE.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_DPMP(String s){
-    if (!isNumber(s)) {
-        return false;
-    }
-
-    DPMP.update_Value(s.toInt());
-    return true;
-}
-
-boolean SpaProperties::update_Pump1InstallState(String s){
-    Pump1InstallState.update_Value(s);
-    return true;
-}
-
-boolean SpaProperties::update_Pump2InstallState(String s){
-    Pump2InstallState.update_Value(s);
-    return true;
-}
-
-boolean SpaProperties::update_Pump3InstallState(String s){
-    Pump3InstallState.update_Value(s);
-    return true;
-}
-
-boolean SpaProperties::update_Pump4InstallState(String s){
-    Pump4InstallState.update_Value(s);
-    return true;
-}
-
-boolean SpaProperties::update_Pump5InstallState(String s){
-    Pump5InstallState.update_Value(s);
-    return true;
-}
-
-boolean SpaProperties::update_Pump1OkToRun(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    Pump1OkToRun.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_Pump2OkToRun(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    Pump2OkToRun.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_Pump3OkToRun(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    Pump3OkToRun.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_Pump4OkToRun(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    Pump4OkToRun.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_Pump5OkToRun(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    Pump5OkToRun.update_Value( s == "1" );
-    return true;
-}
-
-boolean SpaProperties::update_LockMode(String s) {
-    if (s!="0" && s!="1") {
-        return false;
-    }
-
-    LockMode.update_Value( s == "1" );
-    return true;
 }
@@ -6,35 +6,249 @@
 #include <time.h>
 #include <TimeLib.h>
 #include <array>
+#include "SpaFrame.h"
+#include "InlineString.h"
 
 
+/// @brief Has a property moved far enough from the value a subscriber last saw to tell it again?
+/// Numbers compare against the deadband, anything else notifies on any change.
 template <typename T>
-class Property
+inline bool outsideDeadband(const T &last, const T &value, const T &deadband) { return !(last == value); }
+inline bool outsideDeadband(const int &last, const int &value, const int &deadband) { return abs(value - last) > deadband; }
+inline bool outsideDeadband(const time_t &last, const time_t &value, const time_t &deadband) {
+    return (value > last ? value - last : last - value) > deadband;
+}
+
+/// @brief Filter on a number property's own notifications (its callback and subscribers), for readings
+/// that jitter on every frame.  The property's value is always the latest, only telling anyone is held back.
+class PropertyDeadband
 {
+public:
+    /// @param name property name, for reporting
+    /// @param absolute change from the value last notified that is ignored
+    /// @param relativePercent change that is ignored, as a percentage of the value last notified
+    /// @param maxSilence time (ms) after which a change inside the deadband is notified anyway, 0 for never
+    void configure(const char *name, long absolute, uint8_t relativePercent, unsigned long maxSilence) {
+        _name = name;
+        _absolute = absolute;
+        _relativePercent = relativePercent;
+        _maxSilence = maxSilence;
+    }
+
+    const char *name() const { return _name; }
+
+    /// @brief Notifications held back because the change was inside the deadband.
+    unsigned long suppressed() const { return _suppressed; }
+
+    /// @brief Is a new value worth notifying?  If so it becomes the value compared against.
+    bool admit(long value) {
+        if (_notified && (value == _last || (!outside(value) && !silenceExpired()))) {
+            if (value != _last) _suppressed++;
+            return false;
+        }
+        _last = value;
+        _lastTime = millis();
+        _notified = true;
+        return true;
+    }
+
+    /// @brief A change was held back, and it has now been quiet for longer than maxSilence.
+    bool overdue(long value) const { return _notified && value != _last && silenceExpired(); }
+
 private:
-    T _value;
-    void (*_callback)(T) = nullptr;
+    const char *_name = "";
+    long _absolute = 0;
+    uint8_t _relativePercent = 0;
+    unsigned long _maxSilence = 0;
+
+    long _last = 0;
+    unsigned long _lastTime = 0;
+    unsigned long _suppressed = 0;
+    bool _notified = false;
+
+    bool outside(long value) const {
+        long change = labs(value - _last);
+        return change > _absolute && change * 100 > (long)_relativePercent * labs(_last);
+    }
+    bool silenceExpired() const { return _maxSilence != 0 && millis() - _lastTime >= _maxSilence; }
+};
+
+/// @brief Deadbands only apply to numbers, anything else is always notified.
+template <typename T>
+inline bool admitDeadband(PropertyDeadband &deadband, const T &value) { return true; }
+inline bool admitDeadband(PropertyDeadband &deadband, const int &value) { return deadband.admit(value); }
+template <typename T>
+inline bool deadbandOverdue(const PropertyDeadband &deadband, const T &value) { return false; }
+inline bool deadbandOverdue(const PropertyDeadband &deadband, const int &value) { return deadband.overdue(value); }
+
+/// @brief Text value of a property, held in place.  The longest seen is the 14 character SVER.
+typedef InlineString<15> PropertyString;
+
+class SpaProperties;
+
+/// @brief One subscriber to a Property, with its own deadband and minimum interval.
+///
+/// The subscriber owns this (usually as a member or static), and SpaProperties links it into the
+/// property's list, so subscribing and notifying never touch the heap.  It must stay subscribed to only
+/// one property.
+template <typename T>
+class PropertySubscription
+{
+    friend class SpaProperties;
 
 public:
-    T getValue() { return _value; }
-    void update_Value(T newval)
-    {
-        T oldvalue = _value;
-        _value = newval;
-        if ((_callback) && (oldvalue != newval))
-            {
-                _callback(_value);
-            }
-    };
-    void setCallback(void (*c)(T)) { _callback = c; };
-    void clearCallback() { _callback = nullptr; };
+    /// @param callback called with the new value, and context
+    /// @param deadband change from the last value notified that is ignored, for int and time_t properties
+    /// @param minInterval shortest time (ms) between notifications, a change in between is held until it's up
+    PropertySubscription(void (*callback)(const T &, void *), void *context = nullptr, T deadband = T(), unsigned long minInterval = 0)
+        : _callback(callback), _context(context), _deadband(deadband), _minInterval(minInterval) {}
+
+    /// @brief Value last passed to the callback.
+    const T &lastValue() const { return _last; }
+
+    /// @brief Changes not passed on because they were inside the deadband.
+    unsigned long suppressed() const { return _suppressed; }
+
+private:
+    void (*_callback)(const T &, void *);
+    void *_context;
+    T _deadband;
+    unsigned long _minInterval;
+
+    T _last = T();
+    unsigned long _lastTime = 0;
+    unsigned long _suppressed = 0;
+    bool _notified = false;
+    bool _pending = false;
+    PropertySubscription *_next = nullptr;
+
+    /// @param changed pass it on even if it is the value last notified, eg an unknown mode with new text
+    void offer(const T &value, bool changed = false) {
+        if (_notified && !changed && !outsideDeadband(_last, value, _deadband)) {
+            if (!(_last == value)) _suppressed++;
+            _pending = false;
+            return;
+        }
+        if (_notified && millis() - _lastTime < _minInterval) {
+            _pending = true;
+            return;
+        }
+        _last = value;
+        _lastTime = millis();
+        _notified = true;
+        _pending = false;
+        _callback(value, _context);
+    }
+};
+
+/// @brief A property of the spa, as a handle on its value in SpaProperties' store.
+///
+/// The values are kept in arrays by type, see SpaProperties::value(), so a property is only the
+/// index of its value in the array for T.
+template <typename T>
+class Property
+{
+    friend class SpaProperties;
+
+private:
+    /// @brief Slot 0 of each array is never written, so a property that isn't decoded reads as T().
+    uint8_t _slot = 0;
 };
 
 /// @brief represents the properties of the spa.
 class SpaProperties
 {
-    
-private:
+
+public:
+    SpaProperties();
+
+    /// @brief Registers of the RF response, in the order they are returned.
+    enum Register : uint8_t { R2, R3, R4, R5, R6, R7, R9, RA, RB, RC, RE, RG, numRegisters };
+
+    /// @brief Where a property is found in the RF response and how it is decoded.  See fieldMap.
+    struct FieldDescriptor {
+        enum Type : uint8_t {
+            INT,            // Number, divided by scale
+            BOOL,           // "0" or "1"
+            NUMBER_BOOL,    // Number, true if not 0
+            STRING,
+            TIME,           // Six fields from offset: hour, minute, second, day, month, year
+            ENUM,           // One of a fixed set of names, stored as its index, see enumName
+            NUMBER_ENUM     // Number, the index of one of a fixed set of names, see enumName
+        };
+
+        union Member {
+            Property<int> SpaProperties::*i;
+            Property<bool> SpaProperties::*b;
+            Property<PropertyString> SpaProperties::*s;
+            Property<time_t> SpaProperties::*t;
+
+            constexpr Member(Property<int> SpaProperties::*p) : i(p) {}
+            constexpr Member(Property<bool> SpaProperties::*p) : b(p) {}
+            constexpr Member(Property<PropertyString> SpaProperties::*p) : s(p) {}
+            constexpr Member(Property<time_t> SpaProperties::*p) : t(p) {}
+        };
+
+        const char *name;
+        Register reg;
+        /// @brief Field number from the start of the register (the register name is 0).
+        uint8_t offset;
+        Type type;
+        uint8_t scale;
+        Member member;
+        /// @brief Name of each value of an ENUM or NUMBER_ENUM field by index, nullptr past the last.
+        const char *(*enumName)(int);
+
+        /// @brief True if the property is a Property<int>, ie member.i.
+        constexpr bool storesInt() const { return type == INT || type == ENUM || type == NUMBER_ENUM; }
+
+        /// @brief Which array of the property store the value is in, see SpaProperties::value().
+        enum Store : uint8_t { INT_STORE, BOOL_STORE, STRING_STORE, TIME_STORE };
+        constexpr Store store() const {
+            return storesInt() ? INT_STORE : type == STRING ? STRING_STORE : type == TIME ? TIME_STORE : BOOL_STORE;
+        }
+
+        /// @brief True if both rows decode into the same property.
+        constexpr bool sameProperty(const FieldDescriptor &other) const {
+            return store() != other.store() ? false :
+                store() == INT_STORE ? member.i == other.member.i :
+                store() == BOOL_STORE ? member.b == other.member.b :
+                store() == STRING_STORE ? member.s == other.member.s : member.t == other.member.t;
+        }
+
+        constexpr FieldDescriptor(const char *n, Register r, uint8_t o, Property<int> SpaProperties::*p, uint8_t sc = 1)
+            : name(n), reg(r), offset(o), type(INT), scale(sc), member(p), enumName(nullptr) {}
+        constexpr FieldDescriptor(const char *n, Register r, uint8_t o, Property<int> SpaProperties::*p, const char *(*e)(int), Type t = ENUM)
+            : name(n), reg(r), offset(o), type(t), scale(1), member(p), enumName(e) {}
+        constexpr FieldDescriptor(const char *n, Register r, uint8_t o, Property<bool> SpaProperties::*p, Type t = BOOL)
+            : name(n), reg(r), offset(o), type(t), scale(1), member(p), enumName(nullptr) {}
+        constexpr FieldDescriptor(const char *n, Register r, uint8_t o, Property<PropertyString> SpaProperties::*p)
+            : name(n), reg(r), offset(o), type(STRING), scale(1), member(p), enumName(nullptr) {}
+        constexpr FieldDescriptor(const char *n, Register r, uint8_t o, Property<time_t> SpaProperties::*p)
+            : name(n), reg(r), offset(o), type(TIME), scale(1), member(p), enumName(nullptr) {}
+    };
+
+    /// @brief Every property decoded from the RF response, one row per field, in decode order.
+    static const int fieldMapSize = 203;
+    static const FieldDescriptor fieldMap[fieldMapSize];
+
+    /// @brief Find the row of fieldMap for a property, eg findField(&SpaInterface::STMP).
+    /// @return nullptr if the property isn't decoded from the RF response
+    static const FieldDescriptor *findField(Property<int> SpaProperties::*property);
+    static const FieldDescriptor *findField(Property<bool> SpaProperties::*property);
+    static const FieldDescriptor *findField(Property<PropertyString> SpaProperties::*property);
+
+    /// @brief Find the row of fieldMap with a name, eg findField("STMP").  Takes the same time for
+    /// any name, through the perfect hash that gen_name_index.py builds into SpaNameIndex.h.
+    /// @return nullptr if there is no such property
+    static const FieldDescriptor *findField(const char *name);
+
+    /// @brief Current value of the property described by field, as text that updateField() decodes
+    /// back to the same value.
+    /// @return empty for TIME fields
+    String fieldText(const FieldDescriptor &field);
+
+protected:
 
 #pragma region R2
     /// @brief Mains current draw (A)
@@ -106,13 +320,13 @@ private:
     /// See SV-Series-OEM-Install-Manual.pdf page 20.
     Property<int> LLM3;
     /// @brief Software version
-    Property<String> SVER;
+    Property<PropertyString> SVER;
     /// @brief Model
-    Property<String> Model; 
+    Property<PropertyString> Model; 
     /// @brief SerialNo1
-    Property<String> SerialNo1;
+    Property<PropertyString> SerialNo1;
     /// @brief SerialNo2
-    Property<String> SerialNo2;
+    Property<PropertyString> SerialNo2;
     /// @brief Dipswitch 1
     Property<bool> D1;
     /// @brief Dipswitch 2
@@ -126,7 +340,7 @@ private:
     /// @brief Dipswitch 6
     Property<bool> D6;
     /// @brief Pump
-    Property<String> Pump;
+    Property<PropertyString> Pump;
     /// @brief Load shed count
     ///
     /// Number of services active at which the heater will turn itself off.
@@ -136,7 +350,7 @@ private:
     /// @brief MR / name clash with MR constant from specreg.h
     Property<int> SnpMR;
     /// @brief Status (Filtering, etc)
-    Property<String> Status;
+    Property<PropertyString> Status;
     /// @brief PrimeCount
     Property<int> PrimeCount;
     /// @brief Heat element current draw (A)
@@ -154,8 +368,8 @@ Property<bool> HV_2;
     // R4
     /// @brief Operation mode
     ///
-    /// One of NORM, ECON, AWAY, WEEK
-    Property<String> Mode;
+    /// 0 = NORM, 1 = ECON, 2 = AWAY, 3 = WEEK, see spaModeStrings
+    Property<int> Mode;
     /// @brief Service Timer 1 (wks) 0 = off
     Property<int> Ser1_Timer;
     /// @brief Service Timer 2 (wks) 0 = off
@@ -571,31 +785,31 @@ Property<bool> HV_2;
     /// (eg 1-1-014) First part (1- or 0-) indicates whether the pump is installed/fitted. If so (1-
     /// means it is), the second part (1- above) indicates it's speed type. The third
     /// part (014 above) represents it's possible states (0 OFF, 1 ON, 4 AUTO)
-    Property<String> Pump1InstallState;
+    Property<PropertyString> Pump1InstallState;
     /// @brief Pump 2 install state
     ///
     /// (eg 1-1-014) First part (1- or 0-) indicates whether the pump is installed/fitted. If so (1-
     /// means it is), the second part (1- above) indicates it's speed type. The third
     /// part (014 above) represents it's possible states (0 OFF, 1 ON, 4 AUTO)
-    Property<String> Pump2InstallState;
+    Property<PropertyString> Pump2InstallState;
     /// @brief Pump 3 install state
     ///
     /// (eg 1-1-014) First part (1- or 0-) indicates whether the pump is installed/fitted. If so (1-
     /// means it is), the second part (1- above) indicates it's speed type. The third
     /// part (014 above) represents it's possible states (0 OFF, 1 ON, 4 AUTO)
-    Property<String> Pump3InstallState;
+    Property<PropertyString> Pump3InstallState;
     /// @brief Pump 4 install state
     ///
     /// (eg 1-1-014) First part (1- or 0-) indicates whether the pump is installed/fitted. If so (1-
     /// means it is), the second part (1- above) indicates it's speed type. The third
     /// part (014 above) represents it's possible states (0 OFF, 1 ON, 4 AUTO)
-    Property<String> Pump4InstallState;
+    Property<PropertyString> Pump4InstallState;
     /// @brief Pump 5 install state
     ///
     /// (eg 1-1-014) First part (1- or 0-) indicates whether the pump is installed/fitted. If so (1-
     /// means it is), the second part (1- above) indicates it's speed type. The third
     /// part (014 above) represents it's possible states (0 OFF, 1 ON, 4 AUTO)
-    Property<String> Pump5InstallState;
+    Property<PropertyString> Pump5InstallState;
     /// @brief Pump 1 is in safe state to start
     Property<bool> Pump1OkToRun;
     /// @brief Pump 2 is in safe state to start
@@ -614,952 +828,911 @@ Property<bool> HV_2;
 #pragma endregion
 
 
+
 protected:
-#pragma region R2
-    boolean update_MainsCurrent(String);
-    boolean update_SpaTime(String year, String month, String day, String hour, String minute, String second);
-    boolean update_MainsVoltage(String);
-    boolean update_CaseTemperature(String);
-    boolean update_PortCurrent(String);
-    boolean update_SpaTime(String);
-    boolean update_HeaterTemperature(String);
-    boolean update_PoolTemperature(String);
-    boolean update_WaterPresent(String);
-    boolean update_AwakeMinutesRemaining(String);
-    boolean update_FiltPumpRunTimeTotal(String);
-    boolean update_FiltPumpReqMins(String);
-    boolean update_LoadTimeOut(String);
-    boolean update_HourMeter(String);
-    boolean update_Relay1(String);
-    boolean update_Relay2(String);
-    boolean update_Relay3(String);
-    boolean update_Relay4(String);
-    boolean update_Relay5(String);
-    boolean update_Relay6(String);
-    boolean update_Relay7(String);
-    boolean update_Relay8(String);
-    boolean update_Relay9(String);
-#pragma endregion
-#pragma region R3
-    boolean update_CLMT(String);
-    boolean update_PHSE(String);
-    boolean update_LLM1(String);
-    boolean update_LLM2(String);
-    boolean update_LLM3(String);
-    boolean update_SVER(String);
-    boolean update_Model(String);
-    boolean update_SerialNo1(String);
-    boolean update_SerialNo2(String);
-    boolean update_D1(String);
-    boolean update_D2(String);
-    boolean update_D3(String);
-    boolean update_D4(String);
-    boolean update_D5(String);
-    boolean update_D6(String);
-    boolean update_Pump(String);
-    boolean update_LS(String);
-    boolean update_HV(String);
-    boolean update_SnpMR(String);
-    boolean update_Status(String);
-    boolean update_PrimeCount(String);
-    boolean update_EC(String);
-    boolean update_HAMB(String);
-    boolean update_HCON(String);
-//    boolean update_HV_2(String);
-#pragma endregion
-#pragma region R4
-    boolean update_Mode(String);
-    boolean update_Ser1_Timer(String);
-    boolean update_Ser2_Timer(String);
-    boolean update_Ser3_Timer(String);
-    boolean update_HeatMode(String);
-    boolean update_PumpIdleTimer(String);
-    boolean update_PumpRunTimer(String);
-    boolean update_AdtPoolHys(String);
-    boolean update_AdtHeaterHys(String);
-    boolean update_Power(String);
-    boolean update_Power_kWh(String);
-    boolean update_Power_Today(String);
-    boolean update_Power_Yesterday(String);
-    boolean update_ThermalCutOut(String);
-    boolean update_Test_D1(String);
-    boolean update_Test_D2(String);
-    boolean update_Test_D3(String);
-    boolean update_ElementHeatSourceOffset(String);
-    boolean update_Frequency(String);
-    boolean update_HPHeatSourceOffset_Heat(String);
-    boolean update_HPHeatSourceOffset_Cool(String);
-    boolean update_HeatSourceOffTime(String);
-    boolean update_Vari_Speed(String);
-    boolean update_Vari_Percent(String);
-    boolean update_Vari_Mode(String);
-#pragma endregion
-#pragma region R5
-    // R5
-    //  Unknown encoding - TouchPad2.update_Value();
-    //  Unknown encoding - TouchPad1.update_Value();
-    boolean update_RB_TP_Pump1(String);
-    boolean update_RB_TP_Pump2(String);
-    boolean update_RB_TP_Pump3(String);
-    boolean update_RB_TP_Pump4(String);
-    boolean update_RB_TP_Pump5(String);
-    boolean update_RB_TP_Blower(String);
-    boolean update_RB_TP_Light(String);
-    boolean update_RB_TP_Auto(String);
-    boolean update_RB_TP_Heater(String);
-    boolean update_RB_TP_Ozone(String);
-    boolean update_RB_TP_Sleep(String);
-    boolean update_WTMP(String);
-    boolean update_CleanCycle(String);
-#pragma endregion
-#pragma region R6
-    boolean update_VARIValue(String);
-    boolean update_LBRTValue(String);
-    boolean update_CurrClr(String);
-    boolean update_ColorMode(String);
-    boolean update_LSPDValue(String);
-    boolean update_FiltSetHrs(String);
-    boolean update_FiltBlockHrs(String);
-    boolean update_STMP(String);
-    boolean update_L_24HOURS(String);
-    boolean update_PSAV_LVL(String);
-    boolean update_PSAV_BGN(String);
-    boolean update_PSAV_END(String);
-    boolean update_L_1SNZ_DAY(String);
-    boolean update_L_2SNZ_DAY(String);
-    boolean update_L_1SNZ_BGN(String);
-    boolean update_L_2SNZ_BGN(String);
-    boolean update_L_1SNZ_END(String);
-    boolean update_L_2SNZ_END(String);
-    boolean update_DefaultScrn(String);
-    boolean update_TOUT(String);
-    boolean update_VPMP(String);
-    boolean update_HIFI(String);
-    boolean update_BRND(String);
-    boolean update_PRME(String);
-    boolean update_ELMT(String);
-    boolean update_TYPE(String);
-    boolean update_GAS(String);
-#pragma endregion
-#pragma region R7
-    boolean update_WCLNTime(String);
-    // The following 2 may be reversed
-    boolean update_TemperatureUnits(String);
-    boolean update_OzoneOff(String);
-    boolean update_Ozone24(String);
-    // The following 2 may be reversed
-    boolean update_Circ24(String);
-    boolean update_CJET(String);
-    boolean update_VELE(String);
-    boolean update_V_Max(String);
-    boolean update_V_Min(String);
-    boolean update_V_Max_24(String);
-    boolean update_V_Min_24(String);
-    boolean update_CurrentZero(String);
-    boolean update_CurrentAdjust(String);
-    boolean update_VoltageAdjust(String);
-    boolean update_Ser1(String);
-    boolean update_Ser2(String);
-    boolean update_Ser3(String);
-    boolean update_VMAX(String);
-    boolean update_AHYS(String);
-    boolean update_HUSE(String);
-    boolean update_HELE(String);
-    boolean update_HPMP(String);
-    boolean update_PMIN(String);
-    boolean update_PFLT(String);
-    boolean update_PHTR(String);
-    boolean update_PMAX(String);
-#pragma endregion
-#pragma region R9
-    boolean update_F1_HR(String);
-    boolean update_F1_Time(String);
-    boolean update_F1_ER(String);
-    boolean update_F1_I(String);
-    boolean update_F1_V(String);
-    boolean update_F1_PT(String);
-    boolean update_F1_HT(String);
-    boolean update_F1_CT(String);
-    boolean update_F1_PU(String);
-    boolean update_F1_VE(String);
-    boolean update_F1_ST(String);
-#pragma endregion
-#pragma region RA
-    boolean update_F2_HR(String);
-    boolean update_F2_Time(String);
-    boolean update_F2_ER(String);
-    boolean update_F2_I(String);
-    boolean update_F2_V(String);
-    boolean update_F2_PT(String);
-    boolean update_F2_HT(String);
-    boolean update_F2_CT(String);
-    boolean update_F2_PU(String);
-    boolean update_F2_VE(String);
-    boolean update_F2_ST(String);
-#pragma endregion
-#pragma region RB
-    boolean update_F3_HR(String);
-    boolean update_F3_Time(String);
-    boolean update_F3_ER(String);
-    boolean update_F3_I(String);
-    boolean update_F3_V(String);
-    boolean update_F3_PT(String);
-    boolean update_F3_HT(String);
-    boolean update_F3_CT(String);
-    boolean update_F3_PU(String);
-    boolean update_F3_VE(String);
-    boolean update_F3_ST(String);
-#pragma endregion
-#pragma region RC
-    // Outlet_Heater.update_Value(String);
-    // Outlet_Circ.update_Value(String);
-    // Outlet_Sanitise.update_Value(String);
-    // Outlet_Pump1.update_Value(String);
-    // Outlet_Pump2.update_Value(String);
-    // Outlet_Pump4.update_Value(String);
-    // Outlet_Pump5.update_Value(String);
-    boolean update_Outlet_Blower(String);
-#pragma endregion
-#pragma region RE
-    boolean update_HP_Present(String);
-    // HP_FlowSwitch.update_Value(String);
-    // HP_HighSwitch.update_Value(String);
-    // HP_LowSwitch.update_Value(String);
-    // HP_CompCutOut.update_Value(String);
-    // HP_ExCutOut.update_Value(String);
-    // HP_D1.update_Value(String);
-    // HP_D2.update_Value(String);
-    // HP_D3.update_Value(String);
-    boolean update_HP_Ambient(String);
-    boolean update_HP_Condensor(String);
-    boolean update_HP_Compressor_State(String);
-    boolean update_HP_Fan_State(String);
-    boolean update_HP_4W_Valve(String);
-    boolean update_HP_Heater_State(String);
-    boolean update_HP_State(String);
-    boolean update_HP_Mode(String);
-    boolean update_HP_Defrost_Timer(String);
-    boolean update_HP_Comp_Run_Timer(String);
-    boolean update_HP_Low_Temp_Timer(String);
-    boolean update_HP_Heat_Accum_Timer(String);
-    boolean update_HP_Sequence_Timer(String);
-    boolean update_HP_Warning(String);
-    boolean update_FrezTmr(String);
-    boolean update_DBGN(String);
-    boolean update_DEND(String);
-    boolean update_DCMP(String);
-    boolean update_DMAX(String);
-    boolean update_DELE(String);
-    boolean update_DPMP(String);
-// CMAX.update_Value(String);
-// HP_Compressor.update_Value(String);
-// HP_Pump_State.update_Value(String);
-// HP_Status.update_Value(String);
-#pragma endregion
-#pragma region RG
-    boolean update_Pump1InstallState(String);
-    boolean update_Pump2InstallState(String);
-    boolean update_Pump3InstallState(String);
-    boolean update_Pump4InstallState(String);
-    boolean update_Pump5InstallState(String);
-    boolean update_Pump1OkToRun(String);
-    boolean update_Pump2OkToRun(String);
-    boolean update_Pump3OkToRun(String);
-    boolean update_Pump4OkToRun(String);
-    boolean update_Pump5OkToRun(String);
-    boolean update_LockMode(String);
+    /// @brief Decode a single field into the property described by field.  Used for the values
+    /// returned by commands, TIME fields can only be decoded from a frame.
+    /// @return false if the value isn't valid for the property
+    boolean updateField(const FieldDescriptor &field, SpaField s);
+
+    /// @brief Decode the field(s) for a property from frame.
+    /// @param index index in frame of the first field
+    /// @return false if the value isn't valid for the property
+    boolean updateField(const FieldDescriptor &field, const SpaFrame &frame, int index);
+
+    /// @brief Pass on every property change held back by a subscriber's minimum interval, once it is up.
+    /// Called after each frame, as unchanged registers aren't decoded and so don't update their properties.
+    void notifySubscribers();
+
+#pragma region Store
+    // The values of the properties by type, each with a slot 0 that isn't used.  The sizes are checked
+    // against fieldMap when it is compiled, see assignSlots().
+    static const int intSlots = 157;
+    static const int boolSlots = 36;
+    static const int stringSlots = 12;
+    static const int timeSlots = 2;
+
+    int _intValues[intSlots] = {};
+    uint8_t _boolValues[(boolSlots + 7) / 8] = {};
+    PropertyString _stringValues[stringSlots];
+    time_t _timeValues[timeSlots] = {};
+
+    /// @brief Counted up on every change to a property.
+    uint32_t _generation = 0;
+
+    /// @brief _generation when each property last changed, by fieldMap row.
+    uint32_t _changedGeneration[fieldMapSize] = {};
+
+    /// @brief Value of an ENUM property when the spa sends a name that isn't one of its names.  The
+    /// text is kept in _unknownEnumText, so it can still be shown.  Mode is the only ENUM field.
+    static const int unknownEnum = -1;
+    PropertyString _unknownEnumText;
+
+    int value(const Property<int> &property) const { return _intValues[property._slot]; }
+    bool value(const Property<bool> &property) const { return _boolValues[property._slot / 8] & (1 << (property._slot % 8)); }
+    const PropertyString &value(const Property<PropertyString> &property) const { return _stringValues[property._slot]; }
+    time_t value(const Property<time_t> &property) const { return _timeValues[property._slot]; }
+
+    void store(const Property<int> &property, int value) { _intValues[property._slot] = value; }
+    void store(const Property<bool> &property, bool value) {
+        if (value) _boolValues[property._slot / 8] |= 1 << (property._slot % 8);
+        else _boolValues[property._slot / 8] &= ~(1 << (property._slot % 8));
+    }
+    void store(const Property<PropertyString> &property, const PropertyString &value) { _stringValues[property._slot] = value; }
+    void store(const Property<time_t> &property, time_t value) { _timeValues[property._slot] = value; }
+
+    /// @brief Give every property in fieldMap its slot.
+    void assignSlots();
+
+    /// @brief Properties in a store decoded by rows [begin, end) of fieldMap, a property decoded by more
+    /// than one row counted once.  Both of these halve the range at each step, to keep the constexpr
+    /// recursion shallow.
+    static constexpr int countProperties(FieldDescriptor::Store store, int begin, int end) {
+        return end - begin == 1 ? (fieldMap[begin].store() == store && !decodedBefore(begin, 0, begin) ? 1 : 0) :
+            countProperties(store, begin, (begin + end) / 2) + countProperties(store, (begin + end) / 2, end);
+    }
+
+    /// @brief True if any of rows [begin, end) decodes the property of row.
+    static constexpr bool decodedBefore(int row, int begin, int end) {
+        return end <= begin ? false :
+            end - begin == 1 ? fieldMap[begin].sameProperty(fieldMap[row]) :
+            decodedBefore(row, begin, (begin + end) / 2) || decodedBefore(row, (begin + end) / 2, end);
+    }
+
+    /// @brief Set the value of the property in a row of fieldMap, and if it has changed record the
+    /// generation and tell anyone listening.
+    /// @param changed treat it as a change even if the value is the same, see _unknownEnumText
+    template <typename T>
+    void updateValue(const FieldDescriptor &field, const Property<T> &property, const T &newValue, bool changed = false) {
+        if (!changed && value(property) == newValue) return;
+        store(property, newValue);
+
+        int row = &field - fieldMap;
+        _changedGeneration[row] = ++_generation;
+        FieldHooks *hooks = findHooks(row);
+        if (hooks != nullptr && (hooks->deadband == nullptr || admitDeadband(*hooks->deadband, newValue))) {
+            notify(*hooks, newValue, changed);
+        }
+    }
 #pragma endregion
 
+#pragma region Listeners
+    /// @brief What is listening to a property: its callback, subscribers and deadband.  Only the few
+    /// properties with any have one, so the rest don't carry three empty pointers each.
+    struct FieldHooks {
+        /// @brief fieldMap row, -1 if the entry is free
+        int16_t row = -1;
+        /// @brief void (*)(T), for the property's T
+        void (*callback)() = nullptr;
+        /// @brief PropertySubscription<T> *, for the property's T
+        void *subscribers = nullptr;
+        PropertyDeadband *deadband = nullptr;
+    };
+
+    /// @brief Most properties that can be listened to at once.
+    static const int maxHookedFields = 32;
+    FieldHooks _hooks[maxHookedFields];
+
+    /// @brief Hooks of a row of fieldMap, nullptr if it hasn't any.
+    FieldHooks *findHooks(int row);
+
+    /// @brief Hooks of a row of fieldMap, made if it hasn't any.
+    /// @return nullptr if row is -1, or there is no room
+    FieldHooks *addHooks(int row);
+
+    /// @brief Row of fieldMap of a property, or -1.
+    int rowOf(const Property<int> &property);
+    int rowOf(const Property<bool> &property);
+    int rowOf(const Property<PropertyString> &property);
+    int rowOf(const Property<time_t> &property);
+
+    /// @brief Row of fieldMap with this name, if it is of the subscription's type, or -1.
+    int namedRow(const char *name, PropertySubscription<int> &);
+    int namedRow(const char *name, PropertySubscription<bool> &);
+    int namedRow(const char *name, PropertySubscription<PropertyString> &);
+    int namedRow(const char *name, PropertySubscription<time_t> &);
+
+    template <typename T>
+    void notify(FieldHooks &hooks, const T &value, bool changed = false) {
+        if (hooks.callback != nullptr) reinterpret_cast<void (*)(T)>(hooks.callback)(value);
+        for (PropertySubscription<T> *s = static_cast<PropertySubscription<T> *>(hooks.subscribers); s != nullptr; s = s->_next) {
+            s->offer(value, changed);
+        }
+    }
+
+    /// @brief Pass on a change held back by the deadband's maximum silence or a subscriber's minimum interval.
+    template <typename T>
+    void notifyPending(FieldHooks &hooks, const Property<T> &property) {
+        T current = value(property);
+        if (hooks.deadband != nullptr && deadbandOverdue(*hooks.deadband, current) && admitDeadband(*hooks.deadband, current)) {
+            notify(hooks, current);
+            return;
+        }
+        // A held change has already passed the subscriber's deadband, and may be new text for an unknown mode
+        for (PropertySubscription<T> *s = static_cast<PropertySubscription<T> *>(hooks.subscribers); s != nullptr; s = s->_next) {
+            if (s->_pending) s->offer(current, true);
+        }
+    }
+
+    /// @brief Set the single callback of a property, as the setXCallback() methods do.
+    template <typename T>
+    void setCallback(Property<T> &property, void (*callback)(T)) {
+        FieldHooks *hooks = callback != nullptr ? addHooks(rowOf(property)) : findHooks(rowOf(property));
+        if (hooks != nullptr) hooks->callback = reinterpret_cast<void (*)()>(callback);
+    }
+
+    /// @brief Most properties that can have a deadband, see setDeadband().
+    static const int maxDeadbands = 8;
+    /// @brief Longest (ms) a change inside one of the default deadbands goes unnotified.
+    static const unsigned long defaultMaxSilence = 300000;
+    PropertyDeadband _deadbands[maxDeadbands];
+    int _deadbandCount = 0;
+#pragma endregion
 
 public:
+    /// @brief Filter the notifications of a number property in fieldMap, eg setDeadband("MainsVoltage", 2, 0, 300000).
+    /// See PropertyDeadband::configure().  The readings that jitter have one by default.
+    /// @return false if there is no such number property, or maxDeadbands have been used
+    bool setDeadband(const char *name, long absolute, uint8_t relativePercent, unsigned long maxSilence);
+
+    int getDeadbandCount() { return _deadbandCount; }
+    const PropertyDeadband &getDeadband(int index) { return _deadbands[index]; }
+
+    /// @brief Subscribe to a property in fieldMap by name, eg subscribe("STMP", s).  The subscriber is
+    /// told the current value after the next frame, and then of each change.
+    /// @return false if there is no such property, it isn't of the subscription's type, or
+    /// maxHookedFields properties are already listened to
+    template <typename T>
+    bool subscribe(const char *name, PropertySubscription<T> &subscription) {
+        FieldHooks *hooks = addHooks(namedRow(name, subscription));
+        if (hooks == nullptr) return false;
+        unsubscribe(name, subscription);
+        subscription._notified = false;
+        subscription._pending = true;
+        subscription._next = static_cast<PropertySubscription<T> *>(hooks->subscribers);
+        hooks->subscribers = &subscription;
+        return true;
+    }
+
+    template <typename T>
+    void unsubscribe(const char *name, PropertySubscription<T> &subscription) {
+        FieldHooks *hooks = findHooks(namedRow(name, subscription));
+        if (hooks == nullptr) return;
+        for (PropertySubscription<T> **s = reinterpret_cast<PropertySubscription<T> **>(&hooks->subscribers); *s != nullptr; s = &(*s)->_next) {
+            if (*s == &subscription) {
+                *s = subscription._next;
+                subscription._next = nullptr;
+                return;
+            }
+        }
+    }
+
+    /// @brief Generation of the properties, counted up on every change.  Keep it to ask changedSince() later.
+    uint32_t getGeneration() { return _generation; }
+
+    /// @brief Find the properties that have changed since a generation, by scanning one word per property.
+    /// @param rows set to the fieldMap row of each, in fieldMap order
+    /// @return number of rows found, at most maxRows
+    int changedSince(uint32_t generation, uint16_t *rows, int maxRows);
+
     /// @brief Gets the mains current multiplied by 10 (77 = 7.7 actual)
     /// @return 
-    int getMainsCurrent() { return MainsCurrent.getValue(); }
-    void setMainsCurrentCallback(void (*callback)(int)) { MainsCurrent.setCallback(callback); }
+    int getMainsCurrent() { return value(MainsCurrent); }
+    void setMainsCurrentCallback(void (*callback)(int)) { setCallback(MainsCurrent, callback); }
 
-    int getMainsVoltage() { return MainsVoltage.getValue(); }
-    void setMainsVoltageCallback(void (*callback)(int)) { MainsVoltage.setCallback(callback); }
+    int getMainsVoltage() { return value(MainsVoltage); }
+    void setMainsVoltageCallback(void (*callback)(int)) { setCallback(MainsVoltage, callback); }
 
     /// @brief Gets current case temperature multiplied by 10 (245 = 24.5 actual)
     /// @return 
-    int getCaseTemperature() { return CaseTemperature.getValue(); }
-    void setCaseTemperatureCallback(void (*callback)(int)) { CaseTemperature.setCallback(callback); }
+    int getCaseTemperature() { return value(CaseTemperature); }
+    void setCaseTemperatureCallback(void (*callback)(int)) { setCallback(CaseTemperature, callback); }
 
-    int getPortCurrent() { return PortCurrent.getValue(); }
-    void setPortCurrentCallback(void (*callback)(int)) { PortCurrent.setCallback(callback); }
+    int getPortCurrent() { return value(PortCurrent); }
+    void setPortCurrentCallback(void (*callback)(int)) { setCallback(PortCurrent, callback); }
 
     /// @brief Gets the current time from the spa clock
     /// @return 
-    time_t getSpaTime() { return SpaTime.getValue(); }
-    void setSpaTimeCallback(void (*callback)(time_t)) { SpaTime.setCallback(callback); }
+    time_t getSpaTime() { return value(SpaTime); }
+    void setSpaTimeCallback(void (*callback)(time_t)) { setCallback(SpaTime, callback); }
     
 
     /// @brief Get current heater temperature multiplied by 10 (245 = 24.5 actual)
     /// @return 
-    int getHeaterTemperature() { return HeaterTemperature.getValue(); }
-    void setHeaterTemperatureCallback(void (*callback)(int)) { HeaterTemperature.setCallback(callback); }
+    int getHeaterTemperature() { return value(HeaterTemperature); }
+    void setHeaterTemperatureCallback(void (*callback)(int)) { setCallback(HeaterTemperature, callback); }
 
-    int getPoolTemperature() { return PoolTemperature.getValue(); }
-    void setPoolTemperatureCallback(void (*callback)(int)) { PoolTemperature.setCallback(callback); }
+    int getPoolTemperature() { return value(PoolTemperature); }
+    void setPoolTemperatureCallback(void (*callback)(int)) { setCallback(PoolTemperature, callback); }
 
-    bool getWaterPresent() { return WaterPresent.getValue(); }
-    void setWaterPresentCallback(void (*callback)(bool)) { WaterPresent.setCallback(callback); }
+    bool getWaterPresent() { return value(WaterPresent); }
+    void setWaterPresentCallback(void (*callback)(bool)) { setCallback(WaterPresent, callback); }
 
-    int getAwakeMinutesRemaining() { return AwakeMinutesRemaining.getValue(); }
-    void setAwakeMinutesRemainingCallback(void (*callback)(int)) { AwakeMinutesRemaining.setCallback(callback); }
+    int getAwakeMinutesRemaining() { return value(AwakeMinutesRemaining); }
+    void setAwakeMinutesRemainingCallback(void (*callback)(int)) { setCallback(AwakeMinutesRemaining, callback); }
 
-    int getFiltPumpRunTimeTotal() { return FiltPumpRunTimeTotal.getValue(); }
-    void setFiltPumpRunTimeTotalCallback(void (*callback)(int)) { FiltPumpRunTimeTotal.setCallback(callback); }
+    int getFiltPumpRunTimeTotal() { return value(FiltPumpRunTimeTotal); }
+    void setFiltPumpRunTimeTotalCallback(void (*callback)(int)) { setCallback(FiltPumpRunTimeTotal, callback); }
 
-    int getFiltPumpReqMins() { return FiltPumpReqMins.getValue(); }
-    void setFiltPumpReqMinsCallback(void (*callback)(int)) { FiltPumpReqMins.setCallback(callback); }
+    int getFiltPumpReqMins() { return value(FiltPumpReqMins); }
+    void setFiltPumpReqMinsCallback(void (*callback)(int)) { setCallback(FiltPumpReqMins, callback); }
 
-    int getLoadTimeOut() { return LoadTimeOut.getValue(); }
-    void setLoadTimeOutCallback(void (*callback)(int)) { LoadTimeOut.setCallback(callback); }
+    int getLoadTimeOut() { return value(LoadTimeOut); }
+    void setLoadTimeOutCallback(void (*callback)(int)) { setCallback(LoadTimeOut, callback); }
 
     /// @brief Get runtime hours multiplied by 10 (899 = 89.9 actual)
     /// @return 
-    int getHourMeter() { return HourMeter.getValue(); }
-    void setHourMeterCallback(void (*callback)(int)) { HourMeter.setCallback(callback); }
+    int getHourMeter() { return value(HourMeter); }
+    void setHourMeterCallback(void (*callback)(int)) { setCallback(HourMeter, callback); }
 
-    int getRelay1() { return Relay1.getValue(); }
-    void setRelay1Callback(void (*callback)(int)) { Relay1.setCallback(callback); }
+    int getRelay1() { return value(Relay1); }
+    void setRelay1Callback(void (*callback)(int)) { setCallback(Relay1, callback); }
 
-    int getRelay2() { return Relay2.getValue(); }
-    void setRelay2Callback(void (*callback)(int)) { Relay2.setCallback(callback); }
+    int getRelay2() { return value(Relay2); }
+    void setRelay2Callback(void (*callback)(int)) { setCallback(Relay2, callback); }
 
-    int getRelay3() { return Relay3.getValue(); }
-    void setRelay3Callback(void (*callback)(int)) { Relay3.setCallback(callback); }
+    int getRelay3() { return value(Relay3); }
+    void setRelay3Callback(void (*callback)(int)) { setCallback(Relay3, callback); }
 
-    int getRelay4() { return Relay4.getValue(); }
-    void setRelay4Callback(void (*callback)(int)) { Relay4.setCallback(callback); }
+    int getRelay4() { return value(Relay4); }
+    void setRelay4Callback(void (*callback)(int)) { setCallback(Relay4, callback); }
 
-    int getRelay5() { return Relay5.getValue(); }
-    void setRelay5Callback(void (*callback)(int)) { Relay5.setCallback(callback); }
+    int getRelay5() { return value(Relay5); }
+    void setRelay5Callback(void (*callback)(int)) { setCallback(Relay5, callback); }
 
-    int getRelay6() { return Relay6.getValue(); }
-    void setRelay6Callback(void (*callback)(int)) { Relay6.setCallback(callback); }
+    int getRelay6() { return value(Relay6); }
+    void setRelay6Callback(void (*callback)(int)) { setCallback(Relay6, callback); }
 
-    int getRelay7() { return Relay7.getValue(); }
-    void setRelay7Callback(void (*callback)(int)) { Relay7.setCallback(callback); }
+    int getRelay7() { return value(Relay7); }
+    void setRelay7Callback(void (*callback)(int)) { setCallback(Relay7, callback); }
 
-    int getRelay8() { return Relay8.getValue(); }
-    void setRelay8Callback(void (*callback)(int)) { Relay8.setCallback(callback); }
+    int getRelay8() { return value(Relay8); }
+    void setRelay8Callback(void (*callback)(int)) { setCallback(Relay8, callback); }
 
-    int getRelay9() { return Relay9.getValue(); }
-    void setRelay9Callback(void (*callback)(int)) { Relay9.setCallback(callback); }
+    int getRelay9() { return value(Relay9); }
+    void setRelay9Callback(void (*callback)(int)) { setCallback(Relay9, callback); }
 
-    int getCLMT() { return CLMT.getValue(); }
-    void setCLMTCallback(void (*callback)(int)) { CLMT.setCallback(callback); }
+    int getCLMT() { return value(CLMT); }
+    void setCLMTCallback(void (*callback)(int)) { setCallback(CLMT, callback); }
 
-    int getPHSE() { return PHSE.getValue(); }
-    void setPHSECallback(void (*callback)(int)) { PHSE.setCallback(callback); }
+    int getPHSE() { return value(PHSE); }
+    void setPHSECallback(void (*callback)(int)) { setCallback(PHSE, callback); }
 
-    int getLLM1() { return LLM1.getValue(); }
-    void setLLM1Callback(void (*callback)(int)) { LLM1.setCallback(callback); }
+    int getLLM1() { return value(LLM1); }
+    void setLLM1Callback(void (*callback)(int)) { setCallback(LLM1, callback); }
 
-    int getLLM2() { return LLM2.getValue(); }
-    void setLLM2Callback(void (*callback)(int)) { LLM2.setCallback(callback); }
+    int getLLM2() { return value(LLM2); }
+    void setLLM2Callback(void (*callback)(int)) { setCallback(LLM2, callback); }
 
-    int getLLM3() { return LLM3.getValue(); }
-    void setLLM3Callback(void (*callback)(int)) { LLM3.setCallback(callback); }
+    int getLLM3() { return value(LLM3); }
+    void setLLM3Callback(void (*callback)(int)) { setCallback(LLM3, callback); }
 
-    String getSVER() { return SVER.getValue(); }
-    void setSVERCallback(void (*callback)(String)) { SVER.setCallback(callback); }
+    const char *getSVER() { return value(SVER).c_str(); }
+    void setSVERCallback(void (*callback)(PropertyString)) { setCallback(SVER, callback); }
 
-    String getModel() { return Model.getValue(); }
-    void setModelCallback(void (*callback)(String)) { Model.setCallback(callback); }
+    const char *getModel() { return value(Model).c_str(); }
+    void setModelCallback(void (*callback)(PropertyString)) { setCallback(Model, callback); }
 
-    String getSerialNo1() { return SerialNo1.getValue(); }
-    void setSerialNo1Callback(void (*callback)(String)) { SerialNo1.setCallback(callback); }
+    const char *getSerialNo1() { return value(SerialNo1).c_str(); }
+    void setSerialNo1Callback(void (*callback)(PropertyString)) { setCallback(SerialNo1, callback); }
 
-    String getSerialNo2() { return SerialNo2.getValue(); }
-    void setSerialNo2Callback(void (*callback)(String)) { SerialNo2.setCallback(callback); }
+    const char *getSerialNo2() { return value(SerialNo2).c_str(); }
+    void setSerialNo2Callback(void (*callback)(PropertyString)) { setCallback(SerialNo2, callback); }
 
-    bool getD1() { return D1.getValue(); }
-    void setD1Callback(void (*callback)(bool)) { D1.setCallback(callback); }
+    bool getD1() { return value(D1); }
+    void setD1Callback(void (*callback)(bool)) { setCallback(D1, callback); }
 
-    bool getD2() { return D2.getValue(); }
-    void setD2Callback(void (*callback)(bool)) { D2.setCallback(callback); }
+    bool getD2() { return value(D2); }
+    void setD2Callback(void (*callback)(bool)) { setCallback(D2, callback); }
 
-    bool getD3() { return D3.getValue(); }
-    void setD3Callback(void (*callback)(bool)) { D3.setCallback(callback); }
+    bool getD3() { return value(D3); }
+    void setD3Callback(void (*callback)(bool)) { setCallback(D3, callback); }
 
-    bool getD4() { return D4.getValue(); }
-    void setD4Callback(void (*callback)(bool)) { D4.setCallback(callback); }
+    bool getD4() { return value(D4); }
+    void setD4Callback(void (*callback)(bool)) { setCallback(D4, callback); }
 
-    bool getD5() { return D5.getValue(); }
-    void setD5Callback(void (*callback)(bool)) { D5.setCallback(callback); }
+    bool getD5() { return value(D5); }
+    void setD5Callback(void (*callback)(bool)) { setCallback(D5, callback); }
 
-    bool getD6() { return D6.getValue(); }
-    void setD6Callback(void (*callback)(bool)) { D6.setCallback(callback); }
+    bool getD6() { return value(D6); }
+    void setD6Callback(void (*callback)(bool)) { setCallback(D6, callback); }
 
-    String getPump() { return Pump.getValue(); }
-    void setPumpCallback(void (*callback)(String)) { Pump.setCallback(callback); }
+    const char *getPump() { return value(Pump).c_str(); }
+    void setPumpCallback(void (*callback)(PropertyString)) { setCallback(Pump, callback); }
 
-    int getLS() { return LS.getValue(); }
-    void setLSCallback(void (*callback)(int)) { LS.setCallback(callback); }
+    int getLS() { return value(LS); }
+    void setLSCallback(void (*callback)(int)) { setCallback(LS, callback); }
 
-    bool getHV() { return HV.getValue(); }
-    void setHVCallback(void (*callback)(bool)) { HV.setCallback(callback); }
+    bool getHV() { return value(HV); }
+    void setHVCallback(void (*callback)(bool)) { setCallback(HV, callback); }
 
-    int getSnpMR() { return SnpMR.getValue(); }
-    void setSnpMRCallback(void (*callback)(int)) { SnpMR.setCallback(callback); }
+    int getSnpMR() { return value(SnpMR); }
+    void setSnpMRCallback(void (*callback)(int)) { setCallback(SnpMR, callback); }
 
-    String getStatus() { return Status.getValue(); }
-    void setStatusCallback(void (*callback)(String)) { Status.setCallback(callback); }
+    const char *getStatus() { return value(Status).c_str(); }
+    void setStatusCallback(void (*callback)(PropertyString)) { setCallback(Status, callback); }
 
-    int getPrimeCount() { return PrimeCount.getValue(); }
-    void setPrimeCountCallback(void (*callback)(int)) { PrimeCount.setCallback(callback); }
+    int getPrimeCount() { return value(PrimeCount); }
+    void setPrimeCountCallback(void (*callback)(int)) { setCallback(PrimeCount, callback); }
 
     /// @brief Get EC value multiplied by 10 (66 = 6.6 actual)
     /// @return 
-    int getEC() { return EC.getValue(); }
-    void setECCallback(void (*callback)(int)) { EC.setCallback(callback); }
+    int getEC() { return value(EC); }
+    void setECCallback(void (*callback)(int)) { setCallback(EC, callback); }
 
-    int getHAMB() { return HAMB.getValue(); }
-    void setHAMBCallback(void (*callback)(int)) { HAMB.setCallback(callback); }
+    int getHAMB() { return value(HAMB); }
+    void setHAMBCallback(void (*callback)(int)) { setCallback(HAMB, callback); }
 
-    int getHCON() { return HCON.getValue(); }
-    void setHCONCallback(void (*callback)(int)) { HCON.setCallback(callback); }
+    int getHCON() { return value(HCON); }
+    void setHCONCallback(void (*callback)(int)) { setCallback(HCON, callback); }
 
-    String getMode() { return Mode.getValue(); }
-    void setModeCallback(void (*callback)(String)) { Mode.setCallback(callback); }
-    const std::array <String, 4> spaModeStrings = {"NORM","ECON", "AWAY","WEEK"};
+    /// @brief Operation mode, the index of its name in spaModeStrings
+    int getMode() { return value(Mode); }
+    void setModeCallback(void (*callback)(int)) { setCallback(Mode, callback); }
+    /// @brief Name of the current mode, or the text the spa sent if it isn't one of spaModeStrings.
+    String getModeName() { return fieldText(*findField(&SpaProperties::Mode)); }
+    static const std::array <const char *, 4> spaModeStrings;
+    /// @brief Name of a mode for the Mode field, nullptr past the last.
+    static const char *spaModeName(int mode) { return mode >= 0 && mode < (int)spaModeStrings.size() ? spaModeStrings[mode] : nullptr; }
 
-    int getSer1_Timer() { return Ser1_Timer.getValue(); }
-    void setSer1_TimerCallback(void (*callback)(int)) { Ser1_Timer.setCallback(callback); }
+    int getSer1_Timer() { return value(Ser1_Timer); }
+    void setSer1_TimerCallback(void (*callback)(int)) { setCallback(Ser1_Timer, callback); }
 
-    int getSer2_Timer() { return Ser2_Timer.getValue(); }
-    void setSer2_TimerCallback(void (*callback)(int)) { Ser2_Timer.setCallback(callback); }
+    int getSer2_Timer() { return value(Ser2_Timer); }
+    void setSer2_TimerCallback(void (*callback)(int)) { setCallback(Ser2_Timer, callback); }
 
-    int getSer3_Timer() { return Ser3_Timer.getValue(); }
-    void setSer3_TimerCallback(void (*callback)(int)) { Ser3_Timer.setCallback(callback); }
+    int getSer3_Timer() { return value(Ser3_Timer); }
+    void setSer3_TimerCallback(void (*callback)(int)) { setCallback(Ser3_Timer, callback); }
 
-    int getHeatMode() { return HeatMode.getValue(); }
-    void setHeatModeCallback(void (*callback)(int)) { HeatMode.setCallback(callback); }
+    int getHeatMode() { return value(HeatMode); }
+    void setHeatModeCallback(void (*callback)(int)) { setCallback(HeatMode, callback); }
 
-    int getPumpIdleTimer() { return PumpIdleTimer.getValue(); }
-    void setPumpIdleTimerCallback(void (*callback)(int)) { PumpIdleTimer.setCallback(callback); }
+    int getPumpIdleTimer() { return value(PumpIdleTimer); }
+    void setPumpIdleTimerCallback(void (*callback)(int)) { setCallback(PumpIdleTimer, callback); }
 
-    int getPumpRunTimer() { return PumpRunTimer.getValue(); }
-    void setPumpRunTimerCallback(void (*callback)(int)) { PumpRunTimer.setCallback(callback); }
+    int getPumpRunTimer() { return value(PumpRunTimer); }
+    void setPumpRunTimerCallback(void (*callback)(int)) { setCallback(PumpRunTimer, callback); }
 
     /// @brief Get pool hysteris value multiplied by 10 (66 = 6.6 actual)
     /// @return 
-    int getAdtPoolHys() { return AdtPoolHys.getValue(); }
-    void setAdtPoolHysCallback(void (*callback)(int)) { AdtPoolHys.setCallback(callback); }
+    int getAdtPoolHys() { return value(AdtPoolHys); }
+    void setAdtPoolHysCallback(void (*callback)(int)) { setCallback(AdtPoolHys, callback); }
 
     /// @brief Get heater hysteris value multiplied by 10 (66 = 6.6 actual)
     /// @return 
-    int getAdtHeaterHys() { return AdtHeaterHys.getValue(); }
-    void setAdtHeaterHysCallback(void (*callback)(int)) { AdtHeaterHys.setCallback(callback); }
+    int getAdtHeaterHys() { return value(AdtHeaterHys); }
+    void setAdtHeaterHysCallback(void (*callback)(int)) { setCallback(AdtHeaterHys, callback); }
 
     /// @brief Get current power consumption (W) multiplied by 10 (24350 = 2435.0)
     /// @return 
-    int getPower() { return Power.getValue(); }
-    void setPowerCallback(void (*callback)(int)) { Power.setCallback(callback); }
+    int getPower() { return value(Power); }
+    void setPowerCallback(void (*callback)(int)) { setCallback(Power, callback); }
 
     /// @brief Get energy consumption since last reset (kWh) multiplied by 100 (24350 = 243.50)
     /// @return 
-    int getPower_kWh() { return Power_kWh.getValue(); }
-    void setPower_kWhCallback(void (*callback)(int)) { Power_kWh.setCallback(callback); }
+    int getPower_kWh() { return value(Power_kWh); }
+    void setPower_kWhCallback(void (*callback)(int)) { setCallback(Power_kWh, callback); }
 
     /// @brief Get energy consumption today (kWh) multiplied by 100 (24350 = 243.50)
     /// @return 
-    int getPower_Today() { return Power_Today.getValue(); }
-    void setPower_TodayCallback(void (*callback)(int)) { Power_Today.setCallback(callback); }
+    int getPower_Today() { return value(Power_Today); }
+    void setPower_TodayCallback(void (*callback)(int)) { setCallback(Power_Today, callback); }
 
     /// @brief Get energy consumption yesterday (kWh) multiplied by 100 (24350 = 243.50)
     /// @return 
-    int getPower_Yesterday() { return Power_Yesterday.getValue(); }
-    void setPower_YesterdayCallback(void (*callback)(int)) { Power_Yesterday.setCallback(callback); }
+    int getPower_Yesterday() { return value(Power_Yesterday); }
+    void setPower_YesterdayCallback(void (*callback)(int)) { setCallback(Power_Yesterday, callback); }
 
-    int getThermalCutOut() { return ThermalCutOut.getValue(); }
-    void setThermalCutOutCallback(void (*callback)(int)) { ThermalCutOut.setCallback(callback); }
+    int getThermalCutOut() { return value(ThermalCutOut); }
+    void setThermalCutOutCallback(void (*callback)(int)) { setCallback(ThermalCutOut, callback); }
 
-    int getTest_D1() { return Test_D1.getValue(); }
-    void setTest_D1Callback(void (*callback)(int)) { Test_D1.setCallback(callback); }
+    int getTest_D1() { return value(Test_D1); }
+    void setTest_D1Callback(void (*callback)(int)) { setCallback(Test_D1, callback); }
 
-    int getTest_D2() { return Test_D2.getValue(); }
-    void setTest_D2Callback(void (*callback)(int)) { Test_D2.setCallback(callback); }
+    int getTest_D2() { return value(Test_D2); }
+    void setTest_D2Callback(void (*callback)(int)) { setCallback(Test_D2, callback); }
 
-    int getTest_D3() { return Test_D3.getValue(); }
-    void setTest_D3Callback(void (*callback)(int)) { Test_D3.setCallback(callback); }
+    int getTest_D3() { return value(Test_D3); }
+    void setTest_D3Callback(void (*callback)(int)) { setCallback(Test_D3, callback); }
 
     /// @brief Get Heat Element Source Offset multiplied by 10 (543 = 54.3 actual)
     /// @return 
-    int getElementHeatSourceOffset() { return ElementHeatSourceOffset.getValue(); }
-    void setElementHeatSourceOffsetCallback(void (*callback)(int)) { ElementHeatSourceOffset.setCallback(callback); }
+    int getElementHeatSourceOffset() { return value(ElementHeatSourceOffset); }
+    void setElementHeatSourceOffsetCallback(void (*callback)(int)) { setCallback(ElementHeatSourceOffset, callback); }
 
-    int getFrequency() { return Frequency.getValue(); }
-    void setFrequencyCallback(void (*callback)(int)) { Frequency.setCallback(callback); }
+    int getFrequency() { return value(Frequency); }
+    void setFrequencyCallback(void (*callback)(int)) { setCallback(Frequency, callback); }
 
     /// @brief Get Heat Pump Heating Source Offset multiplied by 10 (543 = 54.3 actual)
     /// @return 
-    int getHPHeatSourceOffset_Heat() { return HPHeatSourceOffset_Heat.getValue(); }
-    void setHPHeatSourceOffset_HeatCallback(void (*callback)(int)) { HPHeatSourceOffset_Heat.setCallback(callback); }
+    int getHPHeatSourceOffset_Heat() { return value(HPHeatSourceOffset_Heat); }
+    void setHPHeatSourceOffset_HeatCallback(void (*callback)(int)) { setCallback(HPHeatSourceOffset_Heat, callback); }
 
     /// @brief Get Heat Pump Cooling Source Offset multiplied by 10 (543 = 54.3 actual)
     /// @return 
-    int getHPHeatSourceOffset_Cool() { return HPHeatSourceOffset_Cool.getValue(); }
-    void setHPHeatSourceOffset_CoolCallback(void (*callback)(int)) { HPHeatSourceOffset_Cool.setCallback(callback); }
+    int getHPHeatSourceOffset_Cool() { return value(HPHeatSourceOffset_Cool); }
+    void setHPHeatSourceOffset_CoolCallback(void (*callback)(int)) { setCallback(HPHeatSourceOffset_Cool, callback); }
 
-    int getHeatSourceOffTime() { return HeatSourceOffTime.getValue(); }
-    void setHeatSourceOffTimeCallback(void (*callback)(int)) { HeatSourceOffTime.setCallback(callback); }
+    int getHeatSourceOffTime() { return value(HeatSourceOffTime); }
+    void setHeatSourceOffTimeCallback(void (*callback)(int)) { setCallback(HeatSourceOffTime, callback); }
 
-    int getVari_Speed() { return Vari_Speed.getValue(); }
-    void setVari_SpeedCallback(void (*callback)(int)) { Vari_Speed.setCallback(callback); }
+    int getVari_Speed() { return value(Vari_Speed); }
+    void setVari_SpeedCallback(void (*callback)(int)) { setCallback(Vari_Speed, callback); }
 
-    int getVari_Percent() { return Vari_Percent.getValue(); }
-    void setVari_PercentCallback(void (*callback)(int)) { Vari_Percent.setCallback(callback); }
+    int getVari_Percent() { return value(Vari_Percent); }
+    void setVari_PercentCallback(void (*callback)(int)) { setCallback(Vari_Percent, callback); }
 
-    int getVari_Mode() { return Vari_Mode.getValue(); }
-    void setVari_ModeCallback(void (*callback)(int)) { Vari_Mode.setCallback(callback); }
+    int getVari_Mode() { return value(Vari_Mode); }
+    void setVari_ModeCallback(void (*callback)(int)) { setCallback(Vari_Mode, callback); }
 
-    int getRB_TP_Pump1() { return RB_TP_Pump1.getValue(); }
-    void setRB_TP_Pump1Callback(void (*callback)(int)) { RB_TP_Pump1.setCallback(callback); }
+    int getRB_TP_Pump1() { return value(RB_TP_Pump1); }
+    void setRB_TP_Pump1Callback(void (*callback)(int)) { setCallback(RB_TP_Pump1, callback); }
 
-    int getRB_TP_Pump2() { return RB_TP_Pump2.getValue(); }
-    void setRB_TP_Pump2Callback(void (*callback)(int)) { RB_TP_Pump2.setCallback(callback); }
+    int getRB_TP_Pump2() { return value(RB_TP_Pump2); }
+    void setRB_TP_Pump2Callback(void (*callback)(int)) { setCallback(RB_TP_Pump2, callback); }
 
-    int getRB_TP_Pump3() { return RB_TP_Pump3.getValue(); }
-    void setRB_TP_Pump3Callback(void (*callback)(int)) { RB_TP_Pump3.setCallback(callback); }
+    int getRB_TP_Pump3() { return value(RB_TP_Pump3); }
+    void setRB_TP_Pump3Callback(void (*callback)(int)) { setCallback(RB_TP_Pump3, callback); }
 
-    int getRB_TP_Pump4() { return RB_TP_Pump4.getValue(); }
-    void setRB_TP_Pump4Callback(void (*callback)(int)) { RB_TP_Pump4.setCallback(callback); }
+    int getRB_TP_Pump4() { return value(RB_TP_Pump4); }
+    void setRB_TP_Pump4Callback(void (*callback)(int)) { setCallback(RB_TP_Pump4, callback); }
 
-    int getRB_TP_Pump5() { return RB_TP_Pump5.getValue(); }
-    void setRB_TP_Pump5Callback(void (*callback)(int)) { RB_TP_Pump5.setCallback(callback); }
-    const std::array<String, 2> autoPumpOptions = {"Manual", "Auto"};
+    int getRB_TP_Pump5() { return value(RB_TP_Pump5); }
+    void setRB_TP_Pump5Callback(void (*callback)(int)) { setCallback(RB_TP_Pump5, callback); }
+    static const std::array<const char *, 2> autoPumpOptions;
 
-    int getRB_TP_Blower() { return RB_TP_Blower.getValue(); }
-    void setRB_TP_BlowerCallback(void (*callback)(int)) { RB_TP_Blower.setCallback(callback); }
-    const std::array <String, 2> blowerStrings = {"Variable", "Ramp"};
+    int getRB_TP_Blower() { return value(RB_TP_Blower); }
+    void setRB_TP_BlowerCallback(void (*callback)(int)) { setCallback(RB_TP_Blower, callback); }
+    static const std::array <const char *, 2> blowerStrings;
 
-    int getRB_TP_Light() { return RB_TP_Light.getValue(); }
-    void setRB_TP_LightCallback(void (*callback)(int)) { RB_TP_Light.setCallback(callback); }
+    int getRB_TP_Light() { return value(RB_TP_Light); }
+    void setRB_TP_LightCallback(void (*callback)(int)) { setCallback(RB_TP_Light, callback); }
 
-    bool getRB_TP_Auto() { return RB_TP_Auto.getValue(); }
-    void setRB_TP_AutoCallback(void (*callback)(bool)) { RB_TP_Auto.setCallback(callback); }
+    bool getRB_TP_Auto() { return value(RB_TP_Auto); }
+    void setRB_TP_AutoCallback(void (*callback)(bool)) { setCallback(RB_TP_Auto, callback); }
 
-    bool getRB_TP_Heater() { return RB_TP_Heater.getValue(); }
-    void setRB_TP_HeaterCallback(void (*callback)(bool)) { RB_TP_Heater.setCallback(callback); }
+    bool getRB_TP_Heater() { return value(RB_TP_Heater); }
+    void setRB_TP_HeaterCallback(void (*callback)(bool)) { setCallback(RB_TP_Heater, callback); }
 
-    bool getRB_TP_Ozone() { return RB_TP_Ozone.getValue(); }
-    void setRB_TP_OzoneCallback(void (*callback)(bool)) { RB_TP_Ozone.setCallback(callback); }
+    bool getRB_TP_Ozone() { return value(RB_TP_Ozone); }
+    void setRB_TP_OzoneCallback(void (*callback)(bool)) { setCallback(RB_TP_Ozone, callback); }
 
-    bool getRB_TP_Sleep() { return RB_TP_Sleep.getValue(); }
-    void setRB_TP_SleepCallback(void (*callback)(bool)) { RB_TP_Sleep.setCallback(callback); }
+    bool getRB_TP_Sleep() { return value(RB_TP_Sleep); }
+    void setRB_TP_SleepCallback(void (*callback)(bool)) { setCallback(RB_TP_Sleep, callback); }
 
     /// @brief Get current water temperature divide by 10 to get actual temp (384 = 38.4 )
     /// @return 
-    int getWTMP() { return WTMP.getValue(); }
-    void setWTMPCallback(void (*callback)(int)) { WTMP.setCallback(callback); }
+    int getWTMP() { return value(WTMP); }
+    void setWTMPCallback(void (*callback)(int)) { setCallback(WTMP, callback); }
 
-    bool getCleanCycle() { return CleanCycle.getValue(); }
-    void setCleanCycleCallback(void (*callback)(bool)) { CleanCycle.setCallback(callback); }
+    bool getCleanCycle() { return value(CleanCycle); }
+    void setCleanCycleCallback(void (*callback)(bool)) { setCallback(CleanCycle, callback); }
 
-    int getVARIValue() { return VARIValue.getValue(); }
-    void setVARIValueCallback(void (*callback)(int)) { VARIValue.setCallback(callback); }
+    int getVARIValue() { return value(VARIValue); }
+    void setVARIValueCallback(void (*callback)(int)) { setCallback(VARIValue, callback); }
 
-    int getLBRTValue() { return LBRTValue.getValue(); }
-    void setLBRTValueCallback(void (*callback)(int)) { LBRTValue.setCallback(callback); }
+    int getLBRTValue() { return value(LBRTValue); }
+    void setLBRTValueCallback(void (*callback)(int)) { setCallback(LBRTValue, callback); }
 
-    int getCurrClr() { return CurrClr.getValue(); }
-    void setCurrClrCallback(void (*callback)(int)) { CurrClr.setCallback(callback); }
+    int getCurrClr() { return value(CurrClr); }
+    void setCurrClrCallback(void (*callback)(int)) { setCallback(CurrClr, callback); }
     const std::array <int, 25> colorMap = {0, 4, 4, 19, 13, 25, 25, 16, 10, 7, 2, 8, 5, 3, 6, 6, 21, 21, 21, 18, 18, 9, 9, 1, 1};
 
-    int getColorMode() { return ColorMode.getValue(); }
-    void setColorModeCallback(void (*callback)(int)) { ColorMode.setCallback(callback); }
-    const std::array <String, 5> colorModeStrings = {"White","Color","Fade","Step","Party"};
+    int getColorMode() { return value(ColorMode); }
+    void setColorModeCallback(void (*callback)(int)) { setCallback(ColorMode, callback); }
+    static const std::array <const char *, 5> colorModeStrings;
 
-    int getLSPDValue() { return LSPDValue.getValue(); }
-    void setLSPDValueCallback(void (*callback)(int)) { LSPDValue.setCallback(callback); }
-    const std::array <String, 5> lightSpeedMap = {"1","2","3","4","5"};
+    int getLSPDValue() { return value(LSPDValue); }
+    void setLSPDValueCallback(void (*callback)(int)) { setCallback(LSPDValue, callback); }
+    static const std::array <const char *, 5> lightSpeedMap;
 
-    int getFiltSetHrs() { return FiltSetHrs.getValue(); }
-    void setFiltSetHrsCallback(void (*callback)(int)) { FiltSetHrs.setCallback(callback); }
+    int getFiltSetHrs() { return value(FiltSetHrs); }
+    void setFiltSetHrsCallback(void (*callback)(int)) { setCallback(FiltSetHrs, callback); }
 
-    int getFiltBlockHrs() { return FiltBlockHrs.getValue(); }
-    void setFiltBlockHrsCallback(void (*callback)(int)) { FiltBlockHrs.setCallback(callback); }
+    int getFiltBlockHrs() { return value(FiltBlockHrs); }
+    void setFiltBlockHrsCallback(void (*callback)(int)) { setCallback(FiltBlockHrs, callback); }
 
     /// @brief Get water temperature setpoint divide by 10 to get actual temp (384 = 38.4 )
     /// @return 
-    int getSTMP() { return STMP.getValue(); }
-    void setSTMPCallback(void (*callback)(int)) { STMP.setCallback(callback); }
+    int getSTMP() { return value(STMP); }
+    void setSTMPCallback(void (*callback)(int)) { setCallback(STMP, callback); }
 
-    int getL_24HOURS() { return L_24HOURS.getValue(); }
-    void setL_24HOURSCallback(void (*callback)(int)) { L_24HOURS.setCallback(callback); }
+    int getL_24HOURS() { return value(L_24HOURS); }
+    void setL_24HOURSCallback(void (*callback)(int)) { setCallback(L_24HOURS, callback); }
 
-    int getPSAV_LVL() { return PSAV_LVL.getValue(); }
-    void setPSAV_LVLCallback(void (*callback)(int)) { PSAV_LVL.setCallback(callback); }
+    int getPSAV_LVL() { return value(PSAV_LVL); }
+    void setPSAV_LVLCallback(void (*callback)(int)) { setCallback(PSAV_LVL, callback); }
 
-    int getPSAV_BGN() { return PSAV_BGN.getValue(); }
-    void setPSAV_BGNCallback(void (*callback)(int)) { PSAV_BGN.setCallback(callback); }
+    int getPSAV_BGN() { return value(PSAV_BGN); }
+    void setPSAV_BGNCallback(void (*callback)(int)) { setCallback(PSAV_BGN, callback); }
 
-    int getPSAV_END() { return PSAV_END.getValue(); }
-    void setPSAV_ENDCallback(void (*callback)(int)) { PSAV_END.setCallback(callback); }
+    int getPSAV_END() { return value(PSAV_END); }
+    void setPSAV_ENDCallback(void (*callback)(int)) { setCallback(PSAV_END, callback); }
 
-    int getL_1SNZ_DAY() { return L_1SNZ_DAY.getValue(); }
-    void setL_1SNZ_DAYCallback(void (*callback)(int)) { L_1SNZ_DAY.setCallback(callback); }
-    const std::array <String, 11> sleepSelection = {"Off", "Everyday", "Weekends", "Weekdays", "Monday", "Tuesday", "Wednesday", "Thuesday", "Friday", "Saturday", "Sunday"};
+    int getL_1SNZ_DAY() { return value(L_1SNZ_DAY); }
+    void setL_1SNZ_DAYCallback(void (*callback)(int)) { setCallback(L_1SNZ_DAY, callback); }
+    static const std::array <const char *, 11> sleepSelection;
     const std::array <byte, 11> sleepBitmap = {128, 127, 96, 31, 16, 8, 4, 2, 1, 64, 32}; 
 
-    int getL_2SNZ_DAY() { return L_2SNZ_DAY.getValue(); }
-    void setL_2SNZ_DAYCallback(void (*callback)(int)) { L_2SNZ_DAY.setCallback(callback); }
+    int getL_2SNZ_DAY() { return value(L_2SNZ_DAY); }
+    void setL_2SNZ_DAYCallback(void (*callback)(int)) { setCallback(L_2SNZ_DAY, callback); }
 
-    int getL_1SNZ_BGN() { return L_1SNZ_BGN.getValue(); }
-    void setL_1SNZ_BGNCallback(void (*callback)(int)) { L_1SNZ_BGN.setCallback(callback); }
+    int getL_1SNZ_BGN() { return value(L_1SNZ_BGN); }
+    void setL_1SNZ_BGNCallback(void (*callback)(int)) { setCallback(L_1SNZ_BGN, callback); }
 
-    int getL_2SNZ_BGN() { return L_2SNZ_BGN.getValue(); }
-    void setL_2SNZ_BGNCallback(void (*callback)(int)) { L_2SNZ_BGN.setCallback(callback); }
+    int getL_2SNZ_BGN() { return value(L_2SNZ_BGN); }
+    void setL_2SNZ_BGNCallback(void (*callback)(int)) { setCallback(L_2SNZ_BGN, callback); }
 
-    int getL_1SNZ_END() { return L_1SNZ_END.getValue(); }
-    void setL_1SNZ_ENDCallback(void (*callback)(int)) { L_1SNZ_END.setCallback(callback); }
+    int getL_1SNZ_END() { return value(L_1SNZ_END); }
+    void setL_1SNZ_ENDCallback(void (*callback)(int)) { setCallback(L_1SNZ_END, callback); }
 
-    int getL_2SNZ_END() { return L_2SNZ_END.getValue(); }
-    void setL_2SNZ_ENDCallback(void (*callback)(int)) { L_2SNZ_END.setCallback(callback); }
+    int getL_2SNZ_END() { return value(L_2SNZ_END); }
+    void setL_2SNZ_ENDCallback(void (*callback)(int)) { setCallback(L_2SNZ_END, callback); }
 
-    int getDefaultScrn() { return DefaultScrn.getValue(); }
-    void setDefaultScrnCallback(void (*callback)(int)) { DefaultScrn.setCallback(callback); }
+    int getDefaultScrn() { return value(DefaultScrn); }
+    void setDefaultScrnCallback(void (*callback)(int)) { setCallback(DefaultScrn, callback); }
 
-    int getTOUT() { return TOUT.getValue(); }
-    void setTOUTCallback(void (*callback)(int)) { TOUT.setCallback(callback); }
+    int getTOUT() { return value(TOUT); }
+    void setTOUTCallback(void (*callback)(int)) { setCallback(TOUT, callback); }
 
-    bool getVPMP() { return VPMP.getValue(); }
-    void setVPMPCallback(void (*callback)(bool)) { VPMP.setCallback(callback); }
+    bool getVPMP() { return value(VPMP); }
+    void setVPMPCallback(void (*callback)(bool)) { setCallback(VPMP, callback); }
 
-    bool getHIFI() { return HIFI.getValue(); }
-    void setHIFICallback(void (*callback)(bool)) { HIFI.setCallback(callback); }
+    bool getHIFI() { return value(HIFI); }
+    void setHIFICallback(void (*callback)(bool)) { setCallback(HIFI, callback); }
 
-    int getBRND() { return BRND.getValue(); }
-    void setBRNDCallback(void (*callback)(int)) { BRND.setCallback(callback); }
+    int getBRND() { return value(BRND); }
+    void setBRNDCallback(void (*callback)(int)) { setCallback(BRND, callback); }
 
-    int getPRME() { return PRME.getValue(); }
-    void setPRMECallback(void (*callback)(int)) { PRME.setCallback(callback); }
+    int getPRME() { return value(PRME); }
+    void setPRMECallback(void (*callback)(int)) { setCallback(PRME, callback); }
 
-    int getELMT() { return ELMT.getValue(); }
-    void setELMTCallback(void (*callback)(int)) { ELMT.setCallback(callback); }
+    int getELMT() { return value(ELMT); }
+    void setELMTCallback(void (*callback)(int)) { setCallback(ELMT, callback); }
 
-    int getTYPE() { return TYPE.getValue(); }
-    void setTYPECallback(void (*callback)(int)) { TYPE.setCallback(callback); }
+    int getTYPE() { return value(TYPE); }
+    void setTYPECallback(void (*callback)(int)) { setCallback(TYPE, callback); }
 
-    int getGAS() { return GAS.getValue(); }
-    void setGASCallback(void (*callback)(int)) { GAS.setCallback(callback); }
+    int getGAS() { return value(GAS); }
+    void setGASCallback(void (*callback)(int)) { setCallback(GAS, callback); }
 
-    int getWCLNTime() { return WCLNTime.getValue(); }
-    void setWCLNTimeCallback(void (*callback)(int)) { WCLNTime.setCallback(callback); }
+    int getWCLNTime() { return value(WCLNTime); }
+    void setWCLNTimeCallback(void (*callback)(int)) { setCallback(WCLNTime, callback); }
 
-    bool getTemperatureUnits() { return TemperatureUnits.getValue(); }
-    void setTemperatureUnitsCallback(void (*callback)(bool)) { TemperatureUnits.setCallback(callback); }
+    bool getTemperatureUnits() { return value(TemperatureUnits); }
+    void setTemperatureUnitsCallback(void (*callback)(bool)) { setCallback(TemperatureUnits, callback); }
 
-    bool getOzoneOff() { return OzoneOff.getValue(); }
-    void setOzoneOffCallback(void (*callback)(bool)) { OzoneOff.setCallback(callback); }
+    bool getOzoneOff() { return value(OzoneOff); }
+    void setOzoneOffCallback(void (*callback)(bool)) { setCallback(OzoneOff, callback); }
 
-    bool getCirc24() { return Circ24.getValue(); }
-    void setCirc24Callback(void (*callback)(bool)) { Circ24.setCallback(callback); }
+    bool getCirc24() { return value(Circ24); }
+    void setCirc24Callback(void (*callback)(bool)) { setCallback(Circ24, callback); }
 
-    bool getCJET() { return CJET.getValue(); }
-    void setCJETCallback(void (*callback)(bool)) { CJET.setCallback(callback); }
+    bool getCJET() { return value(CJET); }
+    void setCJETCallback(void (*callback)(bool)) { setCallback(CJET, callback); }
 
-    bool getVELE() { return VELE.getValue(); }
-    void setVELECallback(void (*callback)(bool)) { VELE.setCallback(callback); }
+    bool getVELE() { return value(VELE); }
+    void setVELECallback(void (*callback)(bool)) { setCallback(VELE, callback); }
 
-    int getV_Max() { return V_Max.getValue(); }
-    void setV_MaxCallback(void (*callback)(int)) { V_Max.setCallback(callback); }
+    int getV_Max() { return value(V_Max); }
+    void setV_MaxCallback(void (*callback)(int)) { setCallback(V_Max, callback); }
 
-    int getV_Min() { return V_Min.getValue(); }
-    void setV_MinCallback(void (*callback)(int)) { V_Min.setCallback(callback); }
+    int getV_Min() { return value(V_Min); }
+    void setV_MinCallback(void (*callback)(int)) { setCallback(V_Min, callback); }
 
-    int getV_Max_24() { return V_Max_24.getValue(); }
-    void setV_Max_24Callback(void (*callback)(int)) { V_Max_24.setCallback(callback); }
+    int getV_Max_24() { return value(V_Max_24); }
+    void setV_Max_24Callback(void (*callback)(int)) { setCallback(V_Max_24, callback); }
 
-    int getV_Min_24() { return V_Min_24.getValue(); }
-    void setV_Min_24Callback(void (*callback)(int)) { V_Min_24.setCallback(callback); }
+    int getV_Min_24() { return value(V_Min_24); }
+    void setV_Min_24Callback(void (*callback)(int)) { setCallback(V_Min_24, callback); }
 
-    int getCurrentZero() { return CurrentZero.getValue(); }
-    void setCurrentZeroCallback(void (*callback)(int)) { CurrentZero.setCallback(callback); }
+    int getCurrentZero() { return value(CurrentZero); }
+    void setCurrentZeroCallback(void (*callback)(int)) { setCallback(CurrentZero, callback); }
 
     /// @brief Get Current measurement adjustment multiplied by 10 (77 = 7.7 actual)
     /// @return 
-    int getCurrentAdjust() { return CurrentAdjust.getValue(); }
-    void setCurrentAdjustCallback(void (*callback)(int)) { CurrentAdjust.setCallback(callback); }
+    int getCurrentAdjust() { return value(CurrentAdjust); }
+    void setCurrentAdjustCallback(void (*callback)(int)) { setCallback(CurrentAdjust, callback); }
 
     /// @brief Get Voltage measurement adjustment multiplied by 10 (77 = 7.7 actual)
     /// @return 
-    int getVoltageAdjust() { return VoltageAdjust.getValue(); }
-    void setVoltageAdjustCallback(void (*callback)(int)) { VoltageAdjust.setCallback(callback); }
+    int getVoltageAdjust() { return value(VoltageAdjust); }
+    void setVoltageAdjustCallback(void (*callback)(int)) { setCallback(VoltageAdjust, callback); }
 
-    int getSer1() { return Ser1.getValue(); }
-    void setSer1Callback(void (*callback)(int)) { Ser1.setCallback(callback); }
+    int getSer1() { return value(Ser1); }
+    void setSer1Callback(void (*callback)(int)) { setCallback(Ser1, callback); }
 
-    int getSer2() { return Ser2.getValue(); }
-    void setSer2Callback(void (*callback)(int)) { Ser2.setCallback(callback); }
+    int getSer2() { return value(Ser2); }
+    void setSer2Callback(void (*callback)(int)) { setCallback(Ser2, callback); }
 
-    int getSer3() { return Ser3.getValue(); }
-    void setSer3Callback(void (*callback)(int)) { Ser3.setCallback(callback); }
+    int getSer3() { return value(Ser3); }
+    void setSer3Callback(void (*callback)(int)) { setCallback(Ser3, callback); }
 
-    int getVMAX() { return VMAX.getValue(); }
-    void setVMAXCallback(void (*callback)(int)) { VMAX.setCallback(callback); }
+    int getVMAX() { return value(VMAX); }
+    void setVMAXCallback(void (*callback)(int)) { setCallback(VMAX, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getAHYS() { return AHYS.getValue(); }
-    void setAHYSCallback(void (*callback)(int)) { AHYS.setCallback(callback); }   
+    int getAHYS() { return value(AHYS); }
+    void setAHYSCallback(void (*callback)(int)) { setCallback(AHYS, callback); }   
 
-    bool getHUSE() { return HUSE.getValue(); }
-    void setHUSECallback(void (*callback)(bool)) { HUSE.setCallback(callback); }
+    bool getHUSE() { return value(HUSE); }
+    void setHUSECallback(void (*callback)(bool)) { setCallback(HUSE, callback); }
 
-    bool getHELE() { return HELE.getValue(); }
-    void setHELECallback(void (*callback)(bool)) { HELE.setCallback(callback); }
+    bool getHELE() { return value(HELE); }
+    void setHELECallback(void (*callback)(bool)) { setCallback(HELE, callback); }
 
-    int getHPMP() { return HPMP.getValue(); }
-    void setHPMPCallback(void (*callback)(int)) { HPMP.setCallback(callback); }
-    const std::array <String, 4> HPMPStrings = {"Auto","Heat","Cool","Off"};
+    /// @brief Heatpump mode, the index of its name in HPMPStrings
+    int getHPMP() { return value(HPMP); }
+    void setHPMPCallback(void (*callback)(int)) { setCallback(HPMP, callback); }
+    static const std::array <const char *, 4> HPMPStrings;
+    /// @brief Name of a mode for the HPMP field, nullptr past the last.
+    static const char *HPMPName(int mode) { return mode >= 0 && mode < (int)HPMPStrings.size() ? HPMPStrings[mode] : nullptr; }
+    /// @brief Name of the current heatpump mode, or its number if it isn't one of HPMPStrings.
+    String getHPMPName() { return fieldText(*findField(&SpaProperties::HPMP)); }
 
-    int getPMIN() { return PMIN.getValue(); }
-    void setPMINCallback(void (*callback)(int)) { PMIN.setCallback(callback); }
+    int getPMIN() { return value(PMIN); }
+    void setPMINCallback(void (*callback)(int)) { setCallback(PMIN, callback); }
 
-    int getPFLT() { return PFLT.getValue(); }
-    void setPFLTCallback(void (*callback)(int)) { PFLT.setCallback(callback); }
+    int getPFLT() { return value(PFLT); }
+    void setPFLTCallback(void (*callback)(int)) { setCallback(PFLT, callback); }
 
-    int getPHTR() { return PHTR.getValue(); }
-    void setPHTRCallback(void (*callback)(int)) { PHTR.setCallback(callback); }
+    int getPHTR() { return value(PHTR); }
+    void setPHTRCallback(void (*callback)(int)) { setCallback(PHTR, callback); }
 
-    int getPMAX() { return PMAX.getValue(); }
-    void setPMAXCallback(void (*callback)(int)) { PMAX.setCallback(callback); }
+    int getPMAX() { return value(PMAX); }
+    void setPMAXCallback(void (*callback)(int)) { setCallback(PMAX, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getF1_HR() { return F1_HR.getValue(); }
-    void setF1_HRCallback(void (*callback)(int)) { F1_HR.setCallback(callback); }  
+    int getF1_HR() { return value(F1_HR); }
+    void setF1_HRCallback(void (*callback)(int)) { setCallback(F1_HR, callback); }  
 
-    int getF1_Time() { return F1_Time.getValue(); }
-    void setF1_TimeCallback(void (*callback)(int)) { F1_Time.setCallback(callback); }
+    int getF1_Time() { return value(F1_Time); }
+    void setF1_TimeCallback(void (*callback)(int)) { setCallback(F1_Time, callback); }
 
-    int getF1_ER() { return F1_ER.getValue(); }
-    void setF1_ERCallback(void (*callback)(int)) { F1_ER.setCallback(callback); }
+    int getF1_ER() { return value(F1_ER); }
+    void setF1_ERCallback(void (*callback)(int)) { setCallback(F1_ER, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getF1_I() { return F1_I.getValue(); }
-    void setF1_ICallback(void (*callback)(int)) { F1_I.setCallback(callback); }
+    int getF1_I() { return value(F1_I); }
+    void setF1_ICallback(void (*callback)(int)) { setCallback(F1_I, callback); }
 
-    int getF1_V() { return F1_V.getValue(); }
-    void setF1_VCallback(void (*callback)(int)) { F1_V.setCallback(callback); }
+    int getF1_V() { return value(F1_V); }
+    void setF1_VCallback(void (*callback)(int)) { setCallback(F1_V, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getF1_PT() { return F1_PT.getValue(); }
-    void setF1_PTCallback(void (*callback)(int)) { F1_PT.setCallback(callback); }
+    int getF1_PT() { return value(F1_PT); }
+    void setF1_PTCallback(void (*callback)(int)) { setCallback(F1_PT, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getF1_HT() { return F1_HT.getValue(); }
-    void setF1_HTCallback(void (*callback)(int)) { F1_HT.setCallback(callback); }
+    int getF1_HT() { return value(F1_HT); }
+    void setF1_HTCallback(void (*callback)(int)) { setCallback(F1_HT, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getF1_CT() { return F1_CT.getValue(); }
-    void setF1_CTCallback(void (*callback)(int)) { F1_CT.setCallback(callback); }
+    int getF1_CT() { return value(F1_CT); }
+    void setF1_CTCallback(void (*callback)(int)) { setCallback(F1_CT, callback); }
 
-    int getF1_PU() { return F1_PU.getValue(); }
-    void setF1_PUCallback(void (*callback)(int)) { F1_PU.setCallback(callback); }
+    int getF1_PU() { return value(F1_PU); }
+    void setF1_PUCallback(void (*callback)(int)) { setCallback(F1_PU, callback); }
 
-    bool getF1_VE() { return F1_VE.getValue(); }
-    void setF1_VECallback(void (*callback)(bool)) { F1_VE.setCallback(callback); }
+    bool getF1_VE() { return value(F1_VE); }
+    void setF1_VECallback(void (*callback)(bool)) { setCallback(F1_VE, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getF1_ST() { return F1_ST.getValue(); }
-    void setF1_STCallback(void (*callback)(int)) { F1_ST.setCallback(callback); }
+    int getF1_ST() { return value(F1_ST); }
+    void setF1_STCallback(void (*callback)(int)) { setCallback(F1_ST, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getF2_HR() { return F2_HR.getValue(); }
-    void setF2_HRCallback(void (*callback)(int)) { F2_HR.setCallback(callback); }  
+    int getF2_HR() { return value(F2_HR); }
+    void setF2_HRCallback(void (*callback)(int)) { setCallback(F2_HR, callback); }  
 
-    int getF2_Time() { return F2_Time.getValue(); }
-    void setF2_TimeCallback(void (*callback)(int)) { F2_Time.setCallback(callback); }
+    int getF2_Time() { return value(F2_Time); }
+    void setF2_TimeCallback(void (*callback)(int)) { setCallback(F2_Time, callback); }
 
-    int getF2_ER() { return F2_ER.getValue(); }
-    void setF2_ERCallback(void (*callback)(int)) { F2_ER.setCallback(callback); }
+    int getF2_ER() { return value(F2_ER); }
+    void setF2_ERCallback(void (*callback)(int)) { setCallback(F2_ER, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getF2_I() { return F2_I.getValue(); }
-    void setF2_ICallback(void (*callback)(int)) { F2_I.setCallback(callback); }
+    int getF2_I() { return value(F2_I); }
+    void setF2_ICallback(void (*callback)(int)) { setCallback(F2_I, callback); }
 
-    int getF2_V() { return F2_V.getValue(); }
-    void setF2_VCallback(void (*callback)(int)) { F2_V.setCallback(callback); }
+    int getF2_V() { return value(F2_V); }
+    void setF2_VCallback(void (*callback)(int)) { setCallback(F2_V, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getF2_PT() { return F2_PT.getValue(); }
-    void setF2_PTCallback(void (*callback)(int)) { F2_PT.setCallback(callback); }
+    int getF2_PT() { return value(F2_PT); }
+    void setF2_PTCallback(void (*callback)(int)) { setCallback(F2_PT, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getF2_HT() { return F2_HT.getValue(); }
-    void setF2_HTCallback(void (*callback)(int)) { F2_HT.setCallback(callback); }
+    int getF2_HT() { return value(F2_HT); }
+    void setF2_HTCallback(void (*callback)(int)) { setCallback(F2_HT, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getF2_CT() { return F2_CT.getValue(); }
-    void setF2_CTCallback(void (*callback)(int)) { F2_CT.setCallback(callback); }
+    int getF2_CT() { return value(F2_CT); }
+    void setF2_CTCallback(void (*callback)(int)) { setCallback(F2_CT, callback); }
 
-    int getF2_PU() { return F2_PU.getValue(); }
-    void setF2_PUCallback(void (*callback)(int)) { F2_PU.setCallback(callback); }
+    int getF2_PU() { return value(F2_PU); }
+    void setF2_PUCallback(void (*callback)(int)) { setCallback(F2_PU, callback); }
 
-    bool getF2_VE() { return F2_VE.getValue(); }
-    void setF2_VECallback(void (*callback)(bool)) { F2_VE.setCallback(callback); }
+    bool getF2_VE() { return value(F2_VE); }
+    void setF2_VECallback(void (*callback)(bool)) { setCallback(F2_VE, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getF2_ST() { return F2_ST.getValue(); }
-    void setF2_STCallback(void (*callback)(int)) { F2_ST.setCallback(callback); }
+    int getF2_ST() { return value(F2_ST); }
+    void setF2_STCallback(void (*callback)(int)) { setCallback(F2_ST, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getF3_HR() { return F3_HR.getValue(); }
-    void setF3_HRCallback(void (*callback)(int)) { F3_HR.setCallback(callback); }  
+    int getF3_HR() { return value(F3_HR); }
+    void setF3_HRCallback(void (*callback)(int)) { setCallback(F3_HR, callback); }  
 
-    int getF3_Time() { return F3_Time.getValue(); }
-    void setF3_TimeCallback(void (*callback)(int)) { F3_Time.setCallback(callback); }
+    int getF3_Time() { return value(F3_Time); }
+    void setF3_TimeCallback(void (*callback)(int)) { setCallback(F3_Time, callback); }
 
-    int getF3_ER() { return F3_ER.getValue(); }
-    void setF3_ERCallback(void (*callback)(int)) { F3_ER.setCallback(callback); }
+    int getF3_ER() { return value(F3_ER); }
+    void setF3_ERCallback(void (*callback)(int)) { setCallback(F3_ER, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getF3_I() { return F3_I.getValue(); }
-    void setF3_ICallback(void (*callback)(int)) { F3_I.setCallback(callback); }
+    int getF3_I() { return value(F3_I); }
+    void setF3_ICallback(void (*callback)(int)) { setCallback(F3_I, callback); }
 
-    int getF3_V() { return F3_V.getValue(); }
-    void setF3_VCallback(void (*callback)(int)) { F3_V.setCallback(callback); }
+    int getF3_V() { return value(F3_V); }
+    void setF3_VCallback(void (*callback)(int)) { setCallback(F3_V, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getF3_PT() { return F3_PT.getValue(); }
-    void setF3_PTCallback(void (*callback)(int)) { F3_PT.setCallback(callback); }
+    int getF3_PT() { return value(F3_PT); }
+    void setF3_PTCallback(void (*callback)(int)) { setCallback(F3_PT, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getF3_HT() { return F3_HT.getValue(); }
-    void setF3_HTCallback(void (*callback)(int)) { F3_HT.setCallback(callback); }
+    int getF3_HT() { return value(F3_HT); }
+    void setF3_HTCallback(void (*callback)(int)) { setCallback(F3_HT, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    int getF3_CT() { return F3_CT.getValue(); }
-    void setF3_CTCallback(void (*callback)(int)) { F3_CT.setCallback(callback); }
+    int getF3_CT() { return value(F3_CT); }
+    void setF3_CTCallback(void (*callback)(int)) { setCallback(F3_CT, callback); }
 
-    int getF3_PU() { return F3_PU.getValue(); }
-    void setF3_PUCallback(void (*callback)(int)) { F3_PU.setCallback(callback); }
+    int getF3_PU() { return value(F3_PU); }
+    void setF3_PUCallback(void (*callback)(int)) { setCallback(F3_PU, callback); }
 
     /// @brief Actual value multiplied by 10 (5 = 0.5)
     /// @return 
-    bool getF3_VE() { return F3_VE.getValue(); }
-    void setF3_VECallback(void (*callback)(bool)) { F3_VE.setCallback(callback); }
+    bool getF3_VE() { return value(F3_VE); }
+    void setF3_VECallback(void (*callback)(bool)) { setCallback(F3_VE, callback); }
 
-    int getF3_ST() { return F3_ST.getValue(); }
-    void setF3_STCallback(void (*callback)(int)) { F3_ST.setCallback(callback); }
+    int getF3_ST() { return value(F3_ST); }
+    void setF3_STCallback(void (*callback)(int)) { setCallback(F3_ST, callback); }
 
-    int getOutlet_Blower() { return Outlet_Blower.getValue(); }
-    void setOutlet_BlowerCallback(void (*callback)(int)) { Outlet_Blower.setCallback(callback); }
+    int getOutlet_Blower() { return value(Outlet_Blower); }
+    void setOutlet_BlowerCallback(void (*callback)(int)) { setCallback(Outlet_Blower, callback); }
 
-    int getHP_Present() { return HP_Present.getValue(); }
-    void setHP_PresentCallback(void (*callback)(int)) { HP_Present.setCallback(callback); }
+    int getHP_Present() { return value(HP_Present); }
+    void setHP_PresentCallback(void (*callback)(int)) { setCallback(HP_Present, callback); }
 
-    int getHP_Ambient() { return HP_Ambient.getValue(); }
-    void setHP_AmbientCallback(void (*callback)(int)) { HP_Ambient.setCallback(callback); }
+    int getHP_Ambient() { return value(HP_Ambient); }
+    void setHP_AmbientCallback(void (*callback)(int)) { setCallback(HP_Ambient, callback); }
 
-    int getHP_Condensor() { return HP_Condensor.getValue(); }
-    void setHP_CondensorCallback(void (*callback)(int)) { HP_Condensor.setCallback(callback); }
+    int getHP_Condensor() { return value(HP_Condensor); }
+    void setHP_CondensorCallback(void (*callback)(int)) { setCallback(HP_Condensor, callback); }
 
-    bool getHP_Compressor_State() { return HP_Compressor_State.getValue(); }
-    void setHP_Compressor_StateCallback(void (*callback)(bool)) { HP_Compressor_State.setCallback(callback); }
+    bool getHP_Compressor_State() { return value(HP_Compressor_State); }
+    void setHP_Compressor_StateCallback(void (*callback)(bool)) { setCallback(HP_Compressor_State, callback); }
 
-    bool getHP_Fan_State() { return HP_Fan_State.getValue(); }
-    void setHP_Fan_StateCallback(void (*callback)(bool)) { HP_Fan_State.setCallback(callback); }
+    bool getHP_Fan_State() { return value(HP_Fan_State); }
+    void setHP_Fan_StateCallback(void (*callback)(bool)) { setCallback(HP_Fan_State, callback); }
 
-    bool getHP_4W_Valve() { return HP_4W_Valve.getValue(); }
-    void setHP_4W_ValveCallback(void (*callback)(bool)) { HP_4W_Valve.setCallback(callback); }
+    bool getHP_4W_Valve() { return value(HP_4W_Valve); }
+    void setHP_4W_ValveCallback(void (*callback)(bool)) { setCallback(HP_4W_Valve, callback); }
 
-    bool getHP_Heater_State() { return HP_Heater_State.getValue(); }
-    void setHP_Heater_StateCallback(void (*callback)(bool)) { HP_Heater_State.setCallback(callback); }
+    bool getHP_Heater_State() { return value(HP_Heater_State); }
+    void setHP_Heater_StateCallback(void (*callback)(bool)) { setCallback(HP_Heater_State, callback); }
 
-    int getHP_Mode() { return HP_Mode.getValue(); }
-    void setHP_ModeCallback(void (*callback)(int)) { HP_Mode.setCallback(callback); }
+    int getHP_Mode() { return value(HP_Mode); }
+    void setHP_ModeCallback(void (*callback)(int)) { setCallback(HP_Mode, callback); }
 
-    int getHP_Defrost_Timer() { return HP_Defrost_Timer.getValue(); }
-    void setHP_Defrost_TimerCallback(void (*callback)(int)) { HP_Defrost_Timer.setCallback(callback); }
+    int getHP_Defrost_Timer() { return value(HP_Defrost_Timer); }
+    void setHP_Defrost_TimerCallback(void (*callback)(int)) { setCallback(HP_Defrost_Timer, callback); }
 
-    int getHP_Comp_Run_Timer() { return HP_Comp_Run_Timer.getValue(); }
-    void setHP_Comp_Run_TimerCallback(void (*callback)(int)) { HP_Comp_Run_Timer.setCallback(callback); }
+    int getHP_Comp_Run_Timer() { return value(HP_Comp_Run_Timer); }
+    void setHP_Comp_Run_TimerCallback(void (*callback)(int)) { setCallback(HP_Comp_Run_Timer, callback); }
 
-    int getHP_Low_Temp_Timer() { return HP_Low_Temp_Timer.getValue(); }
-    void setHP_Low_Temp_TimerCallback(void (*callback)(int)) { HP_Low_Temp_Timer.setCallback(callback); }
+    int getHP_Low_Temp_Timer() { return value(HP_Low_Temp_Timer); }
+    void setHP_Low_Temp_TimerCallback(void (*callback)(int)) { setCallback(HP_Low_Temp_Timer, callback); }
 
-    int getHP_Heat_Accum_Timer() { return HP_Heat_Accum_Timer.getValue(); }
-    void setHP_Heat_Accum_TimerCallback(void (*callback)(int)) { HP_Heat_Accum_Timer.setCallback(callback); }
+    int getHP_Heat_Accum_Timer() { return value(HP_Heat_Accum_Timer); }
+    void setHP_Heat_Accum_TimerCallback(void (*callback)(int)) { setCallback(HP_Heat_Accum_Timer, callback); }
 
-    int getHP_Warning() { return HP_Warning.getValue(); }
-    void setHP_WarningCallback(void (*callback)(int)) { HP_Warning.setCallback(callback); }
+    int getHP_Warning() { return value(HP_Warning); }
+    void setHP_WarningCallback(void (*callback)(int)) { setCallback(HP_Warning, callback); }
 
-    int getHP_FrezTmr() { return FrezTmr.getValue(); }
-    void setHP_FrezTmrCallback(void (*callback)(int)) { FrezTmr.setCallback(callback); }
+    int getHP_FrezTmr() { return value(FrezTmr); }
+    void setHP_FrezTmrCallback(void (*callback)(int)) { setCallback(FrezTmr, callback); }
 
-    int getDBGN() { return DBGN.getValue(); }
-    void setDBGNCallback(void (*callback)(int)) { DBGN.setCallback(callback); }
+    int getDBGN() { return value(DBGN); }
+    void setDBGNCallback(void (*callback)(int)) { setCallback(DBGN, callback); }
 
-    int getDEND() { return DEND.getValue(); }
-    void setDENDCallback(void (*callback)(int)) { DEND.setCallback(callback); }
+    int getDEND() { return value(DEND); }
+    void setDENDCallback(void (*callback)(int)) { setCallback(DEND, callback); }
 
-    int getDCMP() { return DCMP.getValue(); }
-    void setDCMPCallback(void (*callback)(int)) { DCMP.setCallback(callback); }
+    int getDCMP() { return value(DCMP); }
+    void setDCMPCallback(void (*callback)(int)) { setCallback(DCMP, callback); }
 
-    int getDMAX() { return DMAX.getValue(); }
-    void setDMAXCallback(void (*callback)(int)) { DMAX.setCallback(callback); }
+    int getDMAX() { return value(DMAX); }
+    void setDMAXCallback(void (*callback)(int)) { setCallback(DMAX, callback); }
 
-    int getDELE() { return DELE.getValue(); }
-    void setDELECallback(void (*callback)(int)) { DELE.setCallback(callback); }
+    int getDELE() { return value(DELE); }
+    void setDELECallback(void (*callback)(int)) { setCallback(DELE, callback); }
 
-    int getDPMP() { return DPMP.getValue(); }
-    void setDPMPCallback(void (*callback)(int)) { DPMP.setCallback(callback); }
+    int getDPMP() { return value(DPMP); }
+    void setDPMPCallback(void (*callback)(int)) { setCallback(DPMP, callback); }
 
-    String getPump1InstallState() { return Pump1InstallState.getValue(); }
-    void setPump1InstallStateCallback(void (*callback)(String)) { Pump1InstallState.setCallback(callback); }
+    const char *getPump1InstallState() { return value(Pump1InstallState).c_str(); }
+    void setPump1InstallStateCallback(void (*callback)(PropertyString)) { setCallback(Pump1InstallState, callback); }
 
-    String getPump2InstallState() { return Pump2InstallState.getValue(); }
-    void setPump2InstallStateCallback(void (*callback)(String)) { Pump2InstallState.setCallback(callback); }
+    const char *getPump2InstallState() { return value(Pump2InstallState).c_str(); }
+    void setPump2InstallStateCallback(void (*callback)(PropertyString)) { setCallback(Pump2InstallState, callback); }
 
-    String getPump3InstallState() { return Pump3InstallState.getValue(); }
-    void setPump3InstallStateCallback(void (*callback)(String)) { Pump3InstallState.setCallback(callback); }
+    const char *getPump3InstallState() { return value(Pump3InstallState).c_str(); }
+    void setPump3InstallStateCallback(void (*callback)(PropertyString)) { setCallback(Pump3InstallState, callback); }
 
-    String getPump4InstallState() { return Pump4InstallState.getValue(); }
-    void setPump4InstallStateCallback(void (*callback)(String)) { Pump4InstallState.setCallback(callback); }
+    const char *getPump4InstallState() { return value(Pump4InstallState).c_str(); }
+    void setPump4InstallStateCallback(void (*callback)(PropertyString)) { setCallback(Pump4InstallState, callback); }
 
-    String getPump5InstallState() { return Pump5InstallState.getValue(); }
-    void setPump5InstallStateCallback(void (*callback)(String)) { Pump5InstallState.setCallback(callback); }
+    const char *getPump5InstallState() { return value(Pump5InstallState).c_str(); }
+    void setPump5InstallStateCallback(void (*callback)(PropertyString)) { setCallback(Pump5InstallState, callback); }
 
-    bool getPump1OkToRun() { return Pump1OkToRun.getValue(); }
-    void setPump1OkToRunCallback(void (*callback)(bool)) { Pump1OkToRun.setCallback(callback); }
+    bool getPump1OkToRun() { return value(Pump1OkToRun); }
+    void setPump1OkToRunCallback(void (*callback)(bool)) { setCallback(Pump1OkToRun, callback); }
 
-    bool getPump2OkToRun() { return Pump2OkToRun.getValue(); }
-    void setPump2OkToRunCallback(void (*callback)(bool)) { Pump2OkToRun.setCallback(callback); }
+    bool getPump2OkToRun() { return value(Pump2OkToRun); }
+    void setPump2OkToRunCallback(void (*callback)(bool)) { setCallback(Pump2OkToRun, callback); }
 
-    bool getPump3OkToRun() { return Pump3OkToRun.getValue(); }
-    void setPump3OkToRunCallback(void (*callback)(bool)) { Pump3OkToRun.setCallback(callback); }
+    bool getPump3OkToRun() { return value(Pump3OkToRun); }
+    void setPump3OkToRunCallback(void (*callback)(bool)) { setCallback(Pump3OkToRun, callback); }
 
-    bool getPump4OkToRun() { return Pump4OkToRun.getValue(); }
-    void setPump4OkToRunCallback(void (*callback)(bool)) { Pump4OkToRun.setCallback(callback); }
+    bool getPump4OkToRun() { return value(Pump4OkToRun); }
+    void setPump4OkToRunCallback(void (*callback)(bool)) { setCallback(Pump4OkToRun, callback); }
 
-    bool getPump5OkToRun() { return Pump5OkToRun.getValue(); }
-    void setPump5OkToRunCallback(void (*callback)(bool)) { Pump5OkToRun.setCallback(callback); }
+    bool getPump5OkToRun() { return value(Pump5OkToRun); }
+    void setPump5OkToRunCallback(void (*callback)(bool)) { setCallback(Pump5OkToRun, callback); }
 
-    int getLockMode() { return LockMode.getValue(); }
-    void setLockModeCallback(void (*callback)(int)) { LockMode.setCallback(callback); }
+    int getLockMode() { return value(LockMode); }
+    void setLockModeCallback(void (*callback)(int)) { setCallback(LockMode, callback); }
 };
 
 #endif
\ No newline at end of file
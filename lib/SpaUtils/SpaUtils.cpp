@@ -126,7 +126,8 @@ int getPumpSpeedMin(String pumpInstallState) {
   return min;
 }
 
-bool generateStatusJson(SpaInterface &si, MQTTClientWrapper &mqttClient, String &output, bool prettyJson) {
+/// @brief Status JSON from the properties as they are, see generateStatusJson().
+static bool buildStatusJson(SpaInterface &si, MQTTClientWrapper &mqttClient, String &output, bool prettyJson) {
   JsonDocument json;
 
   json["temperatures"]["setPoint"] = si.getSTMP() / 10.0;
@@ -144,13 +145,13 @@ bool generateStatusJson(SpaInterface &si, MQTTClientWrapper &mqttClient, String
   json["status"]["heatingActive"] = si.getRB_TP_Heater()? "ON": "OFF";
   json["status"]["ozoneActive"] = si.getRB_TP_Ozone()? "ON": "OFF";
   json["status"]["state"] = si.getStatus();
-  json["status"]["spaMode"] = si.getMode();
+  json["status"]["spaMode"] = si.getModeName();
   json["status"]["controller"] = si.getModel();
-  json["status"]["serial"] = si.getSerialNo1() + "-" + si.getSerialNo2();
+  json["status"]["serial"] = String(si.getSerialNo1()) + "-" + si.getSerialNo2();
   json["status"]["siInitialised"] = si.isInitialised()?"true":"false";
   json["status"]["mqtt"] = mqttClient.connected()?"connected":"disconnected";
 
-  json["heatpump"]["mode"] = si.HPMPStrings[si.getHPMP()];
+  json["heatpump"]["mode"] = si.getHPMPName();
   json["heatpump"]["auxheat"] = si.getHELE()==0? "OFF" : "ON";
 
   JsonObject pumps = json["pumps"].to<JsonObject>();
@@ -183,11 +184,11 @@ bool generateStatusJson(SpaInterface &si, MQTTClientWrapper &mqttClient, String
   for (const auto& pair : si.sleepBitmap) {
       if (pair == si.getL_1SNZ_DAY()) {
         json["sleepTimers"]["timer1"]["state"]=si.sleepSelection[member];
-        debugD("SleepTimer1: %s", si.sleepSelection[member].c_str());
+        debugD("SleepTimer1: %s", si.sleepSelection[member]);
       }
       if (pair == si.getL_2SNZ_DAY()) {
         json["sleepTimers"]["timer2"]["state"]=si.sleepSelection[member];
-        debugD("SleepTimer2: %s", si.sleepSelection[member].c_str());
+        debugD("SleepTimer2: %s", si.sleepSelection[member]);
       }
       member++;
   }
@@ -227,3 +228,158 @@ bool generateStatusJson(SpaInterface &si, MQTTClientWrapper &mqttClient, String
   return (jsonSize > 0);
 }
 
+bool generateStatusJson(SpaInterface &si, MQTTClientWrapper &mqttClient, String &output, bool prettyJson) {
+  // Every value from the same frame, even if it is being decoded on the other core. Built again if
+  // a frame was published meanwhile.
+  bool built = false;
+  si.readConsistent([&]() {
+    output = "";
+    built = buildStatusJson(si, mqttClient, output, prettyJson);
+  });
+  return built;
+}
+
+bool generateMetricsJson(SpaInterface &si, String &output, bool prettyJson) {
+  JsonDocument json;
+
+  json["loop"]["maxMicros"] = si.getLoopTimeMax();
+  // RAM held by the decoded properties, to compare between builds
+  json["propertiesBytes"] = sizeof(SpaProperties);
+  json["readRetries"] = si.getReadRetries();
+
+  const PropertyHistory &history = si.getHistory();
+  json["history"]["bytes"] = history.bytes();
+  JsonArray tiers = json["history"]["tiers"].to<JsonArray>();
+  for (int t = 0; t < PropertyHistory::numTiers; t++) {
+    JsonObject tier = tiers.add<JsonObject>();
+    tier["interval"] = PropertyHistory::interval(t);
+    tier["capacity"] = history.capacity(t);
+    tier["points"] = history.count(t);
+    tier["hours"] = history.capacity(t) * PropertyHistory::interval(t) / 3600.0;
+  }
+  json["energy"]["saves"] = si.getEnergy().saves();
+
+  json["statusRead"]["durationMillis"] = si.getStatusReadDuration();
+  json["statusRead"]["steps"] = si.getStatusReadSteps();
+
+  json["bus"]["queuedCommands"] = si.getQueuedCommands();
+  json["bus"]["coalescedCommands"] = si.getCoalescedCommands();
+  json["bus"]["optimisticRollbacks"] = si.getOptimisticRollbacks();
+  json["bus"]["stackFree"] = si.getBusStackFree();
+  json["bus"]["logDropped"] = si.getBusLogDropped();
+
+  json["transaction"]["durationMillis"] = si.getTransactionDuration();
+  json["transaction"]["commands"] = si.getTransactionSize();
+
+  for (int i = 0; i < SpaInterface::numCommandClasses; i++) {
+    const CommandTiming &timing = si.getCommandTiming(i);
+    JsonObject latency = json["latency"][timing.name()].to<JsonObject>();
+    latency["p50"] = timing.percentile(50);
+    latency["p95"] = timing.percentile(95);
+    latency["p99"] = timing.percentile(99);
+    latency["samples"] = timing.samples();
+    latency["failures"] = timing.failures();
+    latency["wakeGap"] = timing.wakeGap();
+    latency["timeout"] = timing.timeout();
+  }
+
+  const LinkHealth &link = si.getLinkHealth();
+  json["link"]["framesAttempted"] = link.framesAttempted();
+  json["link"]["framesSucceeded"] = link.framesSucceeded();
+  json["link"]["framesAbandoned"] = link.framesAbandoned();
+  json["link"]["framesRepaired"] = link.framesRepaired();
+  for (int i = 0; i < LinkHealth::numFrameFailures; i++) {
+    LinkHealth::FrameFailure reason = (LinkHealth::FrameFailure)i;
+    json["link"]["framesFailed"][LinkHealth::failureName(reason)] = link.frameFailures(reason);
+  }
+  json["link"]["resyncBytes"] = link.resyncBytes();
+  json["link"]["recoveryMillis"] = link.lastRecoveryTime();
+  json["link"]["maxRecoveryMillis"] = link.maxRecoveryTime();
+  json["link"]["bytesFlushed"] = link.bytesFlushed();
+  // Each bucket is {"maxBytes": n, "count": c}, the last one has no maxBytes
+  JsonArray histogram = json["link"]["flushHistogram"].to<JsonArray>();
+  for (int i = 0; i < LinkHealth::flushBuckets; i++) {
+    JsonObject bucket = histogram.add<JsonObject>();
+    if (LinkHealth::flushBucketLimit(i) >= 0) bucket["maxBytes"] = LinkHealth::flushBucketLimit(i);
+    bucket["count"] = link.flushCount(i);
+  }
+  json["link"]["commandsSent"] = link.commandsSent();
+  json["link"]["commandTimeouts"] = link.commandTimeouts();
+  json["link"]["echoMismatches"] = link.echoMismatches();
+  json["link"]["rxOverflows"] = link.rxOverflows();
+
+  json["poll"]["tier"] = SpaInterface::pollTierName(si.getPollTier());
+  json["poll"]["intervalSeconds"] = si.getPollInterval();
+  json["poll"]["pollsPerHour"] = si.getPollsPerHour();
+  json["poll"]["busUtilisation"] = si.getBusUtilisation();
+
+  const RegisterLayout &layout = si.getRegisterLayout();
+  if (layout.isValid()) {
+    json["layout"]["source"] = layout.isStored() ? "stored" : "learnt";
+    json["layout"]["firmware"] = layout.firmware();
+    json["layout"]["model"] = layout.model();
+  }
+  json["layout"]["mismatches"] = si.getLayoutMismatches();
+
+  for (int i = 0; i < si.getRegisterCount(); i++) {
+    json["registerSkips"][si.getRegisterName(i)] = si.getRegisterSkips(i);
+  }
+
+  for (int i = 0; i < si.getDeadbandCount(); i++) {
+    json["deadbandSuppressed"][si.getDeadband(i).name()] = si.getDeadband(i).suppressed();
+  }
+
+  int jsonSize;
+  if (prettyJson) {
+    jsonSize = serializeJsonPretty(json, output);
+  } else {
+    jsonSize = serializeJson(json, output);
+  }
+  return (jsonSize > 0);
+}
+
+static void addEnergyRollups(const EnergyMeter &energy, EnergyMeter::Period period, int count, JsonArray rollups) {
+  for (int age = 0; age < energy.rollupCount(period) && age < count; age++) {
+    const EnergyMeter::Rollup *rollup = energy.rollup(period, age);
+    JsonObject entry = rollups.add<JsonObject>();
+    char start[11];
+    snprintf(start, sizeof(start), "%04d-%02d-%02d", year(rollup->start), month(rollup->start), day(rollup->start));
+    entry["start"] = start;
+    for (int l = 0; l < EnergyMeter::numLoads; l++) {
+      entry[EnergyMeter::loadName((EnergyMeter::Load)l)] = rollup->wh[l];
+    }
+    entry["total"] = rollup->total();
+  }
+}
+
+bool generateEnergyJson(SpaInterface &si, String &output, bool currentOnly, bool prettyJson) {
+  JsonDocument json;
+
+  // Wh, the newest period first.  Just the current day, week and month fit in an MQTT message.
+  int count = currentOnly ? 1 : EnergyMeter::monthCount;
+
+  // Taken in one go, so a frame can't roll the day over part way through.
+  si.readConsistent([&]() {
+    json.clear();
+    const EnergyMeter &energy = si.getEnergy();
+    for (int l = 0; l < EnergyMeter::numLoads; l++) {
+      json["lifetime"][EnergyMeter::loadName((EnergyMeter::Load)l)] = energy.lifetime((EnergyMeter::Load)l);
+    }
+    addEnergyRollups(energy, EnergyMeter::DAY, count, json["days"].to<JsonArray>());
+    addEnergyRollups(energy, EnergyMeter::WEEK, count, json["weeks"].to<JsonArray>());
+    addEnergyRollups(energy, EnergyMeter::MONTH, count, json["months"].to<JsonArray>());
+  });
+
+  // Each interval goes to the first load running in this order, as the spa only reports the total power.
+  for (int l = 0; l < EnergyMeter::numLoads; l++) {
+    json["loadPriority"].add(EnergyMeter::loadName((EnergyMeter::Load)l));
+  }
+
+  int jsonSize;
+  if (prettyJson) {
+    jsonSize = serializeJsonPretty(json, output);
+  } else {
+    jsonSize = serializeJson(json, output);
+  }
+  return (jsonSize > 0);
+}
@@ -24,5 +24,7 @@ int getPumpSpeedMax(String pumpState);
 int getPumpSpeedMin(String pumpState);
 
 bool generateStatusJson(SpaInterface &si, MQTTClientWrapper &mqttClient, String &output, bool prettyJson=false);
+bool generateMetricsJson(SpaInterface &si, String &output, bool prettyJson=false);
+bool generateEnergyJson(SpaInterface &si, String &output, bool currentOnly, bool prettyJson=false);
 
 #endif // SPAUTILS_H
@@ -36,6 +36,28 @@ void WebUI::begin() {
         }
     });
 
+    server->on("/json/metrics", HTTP_GET, [&]() {
+        debugD("uri: %s", server->uri().c_str());
+        server->sendHeader("Connection", "close");
+        String json;
+        if (generateMetricsJson(*_spa, json, true)) {
+            server->send(200, "text/json", json.c_str());
+        } else {
+            server->send(200, "text/text", "Error generating json");
+        }
+    });
+
+    server->on("/json/energy", HTTP_GET, [&]() {
+        debugD("uri: %s", server->uri().c_str());
+        server->sendHeader("Connection", "close");
+        String json;
+        if (generateEnergyJson(*_spa, json, false, true)) {
+            server->send(200, "text/json", json.c_str());
+        } else {
+            server->send(200, "text/text", "Error generating json");
+        }
+    });
+
     server->on("/reboot", HTTP_GET, [&]() {
         debugD("uri: %s", server->uri().c_str());
         server->send(200, "text/html", WebUI::rebootPage);
@@ -160,6 +182,14 @@ void WebUI::begin() {
             _spa->setSpaTime(makeTime(tm));
             server->send(200, "text/plain", "Date/Time updated");
         }
+        else if (server->args() > 0 && _spa->isSettable(server->argName(0).c_str())) {
+            // Any property that can be set, by its name in the RF response, eg STMP=380
+            if (_spa->setField(server->argName(0).c_str(), server->arg(0).c_str())) {
+                server->send(200, "text/plain", server->argName(0) + " updated");
+            } else {
+                server->send(400, "text/plain", "Invalid " + server->argName(0) + " value");
+            }
+        }
         else {
             server->send(400, "text/plain", "Invalid temperature value");
         }
@@ -181,7 +211,137 @@ void WebUI::begin() {
     server->on("/status", HTTP_GET, [&]() {
         debugD("uri: %s", server->uri().c_str());
         server->sendHeader("Connection", "close");
-        server->send(200, "text/plain", _spa->statusResponse.getValue());
+        if (server->hasArg("frame")) {
+            // A raw frame from the flight recorder, 0 is the latest read whether it was good or not
+            String frame;
+            unsigned long time;
+            FlightRecorder::FrameResult result;
+            if (_spa->getRecorder().getFrame(server->arg("frame").toInt(), frame, time, result)) {
+                server->send(200, "text/plain", frame);
+            } else {
+                server->send(404, "text/plain", "No such frame");
+            }
+        } else {
+            server->send(200, "text/plain", _spa->getStatusResponse());
+        }
+    });
+
+    server->on("/recorder", HTTP_GET, [&]() {
+        debugD("uri: %s", server->uri().c_str());
+        server->sendHeader("Connection", "close");
+        server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+        server->send(200, "text/plain", "");
+
+        // Sent a frame at a time, so only one frame is copied out of the recorder at once
+        FlightRecorder &recorder = _spa->getRecorder();
+        String text;
+        unsigned long time;
+        FlightRecorder::FrameResult result;
+        for (int age = recorder.frameCount() - 1; age >= 0; age--) {
+            if (recorder.getFrame(age, text, time, result)) {
+                server->sendContent("# Frame " + String(age) + ", " + String(time) + " ms, " + FlightRecorder::resultName(result) + "\n");
+                server->sendContent(text);
+                server->sendContent("\n");
+            }
+        }
+
+        server->sendContent("# Commands\n");
+        for (int age = recorder.commandCount() - 1; age >= 0; age--) {
+            if (recorder.getCommand(age, text)) server->sendContent(text + "\n");
+        }
+        server->sendContent("");
+    });
+
+    server->on("/history", HTTP_GET, [&]() {
+        // ?series=WTMP (all if left out) &from=&to= (spa time, the last 24 hours if left out) &format=csv|bin
+        debugD("uri: %s", server->uri().c_str());
+        const PropertyHistory &history = _spa->getHistory();
+
+        int seriesIds[PropertyHistory::numSeries];
+        int seriesCount = 0;
+        if (server->hasArg("series")) {
+            int id = PropertyHistory::findSeries(server->arg("series").c_str());
+            if (id < 0) {
+                server->send(404, "text/plain", "No such series");
+                return;
+            }
+            seriesIds[seriesCount++] = id;
+        } else {
+            for (int s = 0; s < PropertyHistory::numSeries; s++) seriesIds[seriesCount++] = s;
+        }
+
+        time_t to = server->hasArg("to") ? (time_t)server->arg("to").toInt() : history.time(0, 0);
+        time_t from = server->hasArg("from") ? (time_t)server->arg("from").toInt() : to - 24 * 3600;
+        int tier = history.tierFor(from);
+
+        // Oldest and newest ages of the points in the range
+        int oldest = history.count(tier) - 1;
+        while (oldest >= 0 && history.time(tier, oldest) < from) oldest--;
+        int newest = 0;
+        while (newest <= oldest && history.time(tier, newest) > to) newest++;
+        int count = oldest >= newest ? oldest - newest + 1 : 0;
+
+        server->sendHeader("Connection", "close");
+        server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+
+        if (server->arg("format") == "bin") {
+            // Little endian: uint32 time of the first point, uint32 seconds between points, uint16
+            // number of points, uint8 number of series, then per series uint8 SeriesId and uint8
+            // resolution, then the points oldest first, an int16 per series (-32768 for no value).
+            server->send(200, "application/octet-stream", "");
+            uint8_t header[11 + 2 * PropertyHistory::numSeries];
+            uint32_t first = count > 0 ? (uint32_t)history.time(tier, oldest) : 0;
+            uint32_t interval = PropertyHistory::interval(tier);
+            uint16_t points = count;
+            memcpy(header, &first, 4);
+            memcpy(header + 4, &interval, 4);
+            memcpy(header + 8, &points, 2);
+            header[10] = seriesCount;
+            for (int s = 0; s < seriesCount; s++) {
+                header[11 + 2 * s] = seriesIds[s];
+                header[12 + 2 * s] = PropertyHistory::series[seriesIds[s]].resolution;
+            }
+            server->sendContent((const char *)header, 11 + 2 * seriesCount);
+
+            int16_t rows[64 * PropertyHistory::numSeries];
+            int held = 0;
+            for (int age = oldest; age >= newest; age--) {
+                for (int s = 0; s < seriesCount; s++) rows[held++] = history.value(seriesIds[s], tier, age);
+                if (held + seriesCount > (int)(sizeof(rows) / sizeof(rows[0])) || age == newest) {
+                    server->sendContent((const char *)rows, held * sizeof(rows[0]));
+                    held = 0;
+                }
+            }
+        } else {
+            server->send(200, "text/csv", "");
+            String text = "time";
+            for (int s = 0; s < seriesCount; s++) {
+                const PropertyHistory::Series &series = PropertyHistory::series[seriesIds[s]];
+                text += String(",") + series.name + " (" + series.unit + ")";
+            }
+            text += "\n";
+
+            // Sent about 50 rows at a time
+            int rows = 0;
+            for (int age = oldest; age >= newest; age--) {
+                text += String((unsigned long)history.time(tier, age));
+                for (int s = 0; s < seriesCount; s++) {
+                    int16_t value = history.value(seriesIds[s], tier, age);
+                    int resolution = PropertyHistory::series[seriesIds[s]].resolution;
+                    text += ",";
+                    if (value == PropertyHistory::noValue) continue;
+                    if (resolution == 1) text += String(value);
+                    else text += String((float)value / resolution, 1);
+                }
+                text += "\n";
+                if (++rows % 50 == 0) {
+                    server->sendContent(text);
+                    text = "";
+                }
+            }
+            server->sendContent(text);
+        }
+        server->sendContent("");
     });
 
     server->begin();
@@ -107,6 +107,10 @@ window.onload = function() {
 <p><a href="/json.html">Spa JSON HTML</a></p>
 <p><a href="/json">Spa JSON</a></p>
 <p><a href="/status">Spa Response</a></p>
+<p><a href="/recorder">Spa Flight Recorder</a></p>
+<p><a href="/history">Spa History (CSV, last 24 hours)</a></p>
+<p><a href="/json/energy">Spa Energy (Wh by day, week and month)</a></p>
+<p><a href="/json/metrics">Spa Interface Metrics</a></p>
 <p><a href="#" onclick="sendCurrentTime();">Send Current Time to Spa</a></p>
 <p><a href="/config">Configuration</a></p>
 <p><a href="/fota">Firmware Update</a></p>
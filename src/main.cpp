@@ -45,6 +45,7 @@ ulong mqttLastConnect = 0;
 ulong wifiLastConnect = millis();
 ulong bootTime = millis();
 ulong statusLastPublish = millis();
+ulong metricsLastPublish = millis();
 bool delayedStart = true; // Delay spa connection for 10sec after boot to allow for external debugging if required.
 bool autoDiscoveryPublished = false;
 
@@ -52,6 +53,9 @@ String mqttBase = "";
 String mqttStatusTopic = "";
 String mqttSet = "";
 String mqttAvailability = "";
+String mqttRfResponseTopic = "";
+String mqttMetricsTopic = "";
+String mqttEnergyTopic = "";
 
 String spaSerialNumber = "";
 
@@ -255,7 +259,7 @@ void mqttHaAutoDiscovery() {
 
   ADConf.deviceClass = "";
   ADConf.entityCategory = "";
-  const String* selectedPumpOptions = nullptr;
+  const char *const *selectedPumpOptions = nullptr;
   size_t arrSize = 0;
   for (int pumpNumber = 1; pumpNumber <= 5; pumpNumber++) {
     String pumpInstallState = (si.*(pumpInstallStateFunctions[pumpNumber - 1]))();
@@ -413,12 +417,16 @@ void mqttHaAutoDiscovery() {
 
 #pragma region MQTT Publish / Subscribe
 
-void mqttPublishStatusString(String s){
+void mqttPublishStatusString(const char *s){
 
-  mqttClient.publish(String(mqttBase+"rfResponse").c_str(),s.c_str());
+  mqttClient.publish(mqttRfResponseTopic.c_str(),s);
 
 }
 
+void spaCommandComplete(const char *cmd, bool success) {
+  if (!success) debugW("Spa did not accept command %s", cmd);
+}
+
 void mqttPublishStatus() {
   String json;
   if (generateStatusJson(si, mqttClient, json, false)) {
@@ -428,6 +436,24 @@ void mqttPublishStatus() {
   }
 }
 
+void mqttPublishMetrics() {
+  String json;
+  if (generateMetricsJson(si, json, false)) {
+    mqttClient.publish(mqttMetricsTopic.c_str(),json.c_str());
+  } else {
+    debugD("Error generating json");
+  }
+}
+
+void mqttPublishEnergy() {
+  String json;
+  if (generateEnergyJson(si, json, true, false)) {
+    mqttClient.publish(mqttEnergyTopic.c_str(),json.c_str());
+  } else {
+    debugD("Error generating json");
+  }
+}
+
 
 void mqttCallback(char* topic, byte* payload, unsigned int length) {
   String t = String(topic);
@@ -501,7 +527,7 @@ void mqttCallback(char* topic, byte* payload, unsigned int length) {
   } else if (property == "sleepTimers_1_state" || property == "sleepTimers_2_state") {
     int member=0;
     for (const auto& i : si.sleepSelection) {
-      if (i == p) {
+      if (p == i) {
         if (property == "sleepTimers_1_state")
           si.setL_1SNZ_DAY(si.sleepBitmap[member]);
         else if (property == "sleepTimers_2_state")
@@ -520,6 +546,9 @@ void mqttCallback(char* topic, byte* payload, unsigned int length) {
     si.setL_2SNZ_END(convertToInteger(p));
   } else if (property == "status_spaMode") {
     si.setMode(p);
+  } else if (si.isSettable(property.c_str())) {
+    // Anything else that can be set, by its name in the RF response, eg set/STMP
+    si.setField(property.c_str(), p.c_str());
   } else {
     debugE("Unhandled property - %s",property.c_str());
   }
@@ -603,6 +632,7 @@ void setup() {
   ui.begin();
   ui.setWifiManagerCallback(startWifiManagerCallback);
   si.setUpdateFrequency(config.UpdateFrequency.getValue());
+  si.setCommandCallback(spaCommandComplete);
 
   config.setCallback(configChangeCallbackString);
   config.setCallback(configChangeCallbackInt);
@@ -640,6 +670,7 @@ void loop() {
   } else {
     if (delayedStart) {
       delayedStart = !(bootTime + 10000 < millis());
+      if (!delayedStart) si.begin(); // From here on the spa bus task owns the serial port
     } else {
 
       si.loop();
@@ -648,13 +679,16 @@ void loop() {
         if ( spaSerialNumber=="" ) {
           debugI("Initialising...");
       
-          spaSerialNumber = si.getSerialNo1()+"-"+si.getSerialNo2();
+          spaSerialNumber = String(si.getSerialNo1())+"-"+si.getSerialNo2();
           debugI("Spa serial number is %s",spaSerialNumber.c_str());
 
           mqttBase = String("sn_esp32/") + spaSerialNumber + String("/");
           mqttStatusTopic = mqttBase + "status";
           mqttSet = mqttBase + "set";
           mqttAvailability = mqttBase+"available";
+          mqttRfResponseTopic = mqttBase+"rfResponse";
+          mqttMetricsTopic = mqttBase+"metrics";
+          mqttEnergyTopic = mqttBase+"energy";
           debugI("MQTT base topic is %s",mqttBase.c_str());
         }
         if (!mqttClient.connected()) {  // MQTT broker reconnect if not connected
@@ -688,10 +722,16 @@ void loop() {
             si.setUpdateCallback(mqttPublishStatus);
             mqttPublishStatus();
 
-            si.statusResponse.setCallback(mqttPublishStatusString);
+            si.setStatusResponseCallback(mqttPublishStatusString);
 
           }
           
+          if (millis() - metricsLastPublish > 60000) {
+            metricsLastPublish = millis();
+            mqttPublishMetrics();
+            mqttPublishEnergy();
+          }
+
           // all systems are go! Start the knight rider animation loop
           blinker.setState(KNIGHT_RIDER);
         }
@@ -0,0 +1,177 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+// Just enough of the Arduino core for the spa interface to build and run on the host, see
+// test/test_replay.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <sys/types.h>
+#include <string>
+#include "NativeClock.h"
+#include "freertos/FreeRTOS.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef unsigned long ulong;
+typedef unsigned int uint;
+
+#define SERIAL_8N1 0x800001c
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline unsigned long micros() { return NativeClock::instance().micros(); }
+inline unsigned long millis() { return micros() / 1000; }
+inline void delay(unsigned long ms) { NativeClock::instance().sleep(ms); }
+inline void yield() {}
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+// glibc may or may not have strlcpy, so always use our own.
+inline size_t native_strlcpy(char *dst, const char *src, size_t size) {
+    size_t length = strlen(src);
+    if (size > 0) {
+        size_t n = length < size - 1 ? length : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return length;
+}
+#define strlcpy native_strlcpy
+
+class String {
+    public:
+        String() {}
+        String(const char *s) : _s(s ? s : "") {}
+        String(const std::string &s) : _s(s) {}
+        explicit String(char c) : _s(1, c) {}
+        explicit String(int v) : _s(std::to_string(v)) {}
+        explicit String(unsigned int v) : _s(std::to_string(v)) {}
+        explicit String(long v) : _s(std::to_string(v)) {}
+        explicit String(unsigned long v) : _s(std::to_string(v)) {}
+        explicit String(long long v) : _s(std::to_string(v)) {}
+        explicit String(unsigned long long v) : _s(std::to_string(v)) {}
+        explicit String(double v, unsigned int decimals = 2) {
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%.*f", decimals, v);
+            _s = buffer;
+        }
+
+        const char *c_str() const { return _s.c_str(); }
+        unsigned int length() const { return _s.size(); }
+        bool isEmpty() const { return _s.empty(); }
+        bool reserve(unsigned int size) { _s.reserve(size); return true; }
+        bool concat(const char *s, unsigned int length) { _s.append(s, length); return true; }
+
+        char operator[](unsigned int i) const { return i < _s.size() ? _s[i] : '\0'; }
+        char charAt(unsigned int i) const { return (*this)[i]; }
+
+        bool equals(const String &s) const { return _s == s._s; }
+        bool startsWith(const String &s) const { return _s.compare(0, s._s.size(), s._s) == 0; }
+        bool endsWith(const String &s) const { return _s.size() >= s._s.size() && _s.compare(_s.size() - s._s.size(), s._s.size(), s._s) == 0; }
+        int indexOf(char c) const { size_t p = _s.find(c); return p == std::string::npos ? -1 : (int)p; }
+        int indexOf(char c, unsigned int from) const { size_t p = _s.find(c, from); return p == std::string::npos ? -1 : (int)p; }
+        int indexOf(const String &s) const { size_t p = _s.find(s._s); return p == std::string::npos ? -1 : (int)p; }
+        String substring(unsigned int from) const { return from < _s.size() ? String(_s.substr(from)) : String(); }
+        String substring(unsigned int from, unsigned int to) const { return from < _s.size() && from < to ? String(_s.substr(from, to - from)) : String(); }
+
+        long toInt() const { return atol(_s.c_str()); }
+        float toFloat() const { return atof(_s.c_str()); }
+
+        String &operator+=(const String &s) { _s += s._s; return *this; }
+        String &operator+=(const char *s) { _s += s; return *this; }
+        String &operator+=(char c) { _s += c; return *this; }
+
+        friend String operator+(const String &a, const String &b) { return String(a._s + b._s); }
+        friend String operator+(const String &a, const char *b) { return String(a._s + b); }
+        friend String operator+(const char *a, const String &b) { return String(a + b._s); }
+        friend String operator+(const String &a, char b) { return String(a._s + b); }
+        friend String operator+(const String &a, int b) { return a + String(b); }
+        friend String operator+(const String &a, long b) { return a + String(b); }
+        friend String operator+(const String &a, unsigned long b) { return a + String(b); }
+
+        bool operator==(const String &s) const { return _s == s._s; }
+        bool operator==(const char *s) const { return _s == s; }
+        bool operator!=(const String &s) const { return _s != s._s; }
+        bool operator!=(const char *s) const { return _s != s; }
+
+    private:
+        std::string _s;
+};
+
+class Print {
+    public:
+        virtual ~Print() {}
+        virtual size_t write(uint8_t c) = 0;
+        virtual size_t write(const uint8_t *buffer, size_t size) {
+            for (size_t i = 0; i < size; i++) write(buffer[i]);
+            return size;
+        }
+        size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+        virtual void flush() {}
+
+        size_t print(const String &s) { return write(s.c_str(), s.length()); }
+        size_t print(const char *s) { return write(s, strlen(s)); }
+        size_t print(char c) { return write((uint8_t)c); }
+        size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+            char buffer[256];
+            va_list args;
+            va_start(args, format);
+            int length = vsnprintf(buffer, sizeof(buffer), format, args);
+            va_end(args);
+            return write(buffer, length < (int)sizeof(buffer) ? length : sizeof(buffer) - 1);
+        }
+};
+
+class Stream : public Print {
+    public:
+        virtual int available() = 0;
+        virtual int read() = 0;
+        virtual int peek() = 0;
+
+        void setTimeout(unsigned long timeout) { _timeout = timeout; }
+
+        size_t readBytes(char *buffer, size_t length) {
+            size_t count = 0;
+            while (count < length) {
+                int c = timedRead();
+                if (c < 0) break;
+                buffer[count++] = (char)c;
+            }
+            return count;
+        }
+
+        String readStringUntil(char terminator) {
+            String s;
+            int c = timedRead();
+            while (c >= 0 && c != terminator) {
+                s += (char)c;
+                c = timedRead();
+            }
+            return s;
+        }
+
+    protected:
+        unsigned long _timeout = 1000;
+
+        int timedRead() {
+            unsigned long start = millis();
+            do {
+                int c = read();
+                if (c >= 0) return c;
+                delay(1);
+            } while (millis() - start < _timeout);
+            return -1;
+        }
+};
+
+typedef enum { UART_NO_ERROR, UART_BREAK_ERROR, UART_BUFFER_FULL_ERROR, UART_FIFO_OVF_ERROR, UART_FRAME_ERROR, UART_PARITY_ERROR } hardwareSerial_error_t;
+
+// The spa's port (SPA_SERIAL=Serial2) replays captured responses
+#include "ReplaySerial.h"
+#define Serial2 ReplaySerial::instance()
+
+#endif // ARDUINO_H
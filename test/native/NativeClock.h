@@ -0,0 +1,38 @@
+#ifndef NATIVECLOCK_H
+#define NATIVECLOCK_H
+
+#include <chrono>
+#include <thread>
+
+/// @brief Time for the native build.  millis(), micros() and delay() run speed times faster than
+/// real time, so a replay at the spa's baud rate and poll interval can be accelerated.
+class NativeClock {
+    public:
+        static NativeClock &instance() {
+            static NativeClock clock;
+            return clock;
+        }
+
+        /// @brief Set how many times faster than real time the clock runs.
+        void setSpeed(double speed) { _offset = micros(); _start = std::chrono::steady_clock::now(); _speed = speed; }
+        double speed() const { return _speed; }
+
+        unsigned long micros() const {
+            std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - _start;
+            return _offset + (unsigned long)(elapsed.count() * _speed);
+        }
+
+        /// @brief Real time to wait for an interval on this clock.
+        std::chrono::microseconds realTime(unsigned long ms) const {
+            return std::chrono::microseconds((long long)(ms * 1000.0 / _speed));
+        }
+
+        void sleep(unsigned long ms) const { std::this_thread::sleep_for(realTime(ms)); }
+
+    private:
+        std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+        unsigned long _offset = 0;
+        double _speed = 1;
+};
+
+#endif // NATIVECLOCK_H
@@ -0,0 +1,56 @@
+#ifndef PREFERENCES_H
+#define PREFERENCES_H
+
+// NVS held in memory for the life of the test program, so what one SpaInterface saves the next can
+// load, as after a reboot.  Call Preferences::clearAll() for a first boot.
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+
+class Preferences {
+    public:
+        bool begin(const char *name, bool readOnly = false) {
+            _namespace = name;
+            _readOnly = readOnly;
+            return true;
+        }
+        void end() {}
+
+        size_t putBytes(const char *key, const void *value, size_t length) {
+            if (_readOnly) return 0;
+            const uint8_t *bytes = (const uint8_t *)value;
+            store()[_namespace + "/" + key].assign(bytes, bytes + length);
+            return length;
+        }
+        size_t getBytes(const char *key, void *buffer, size_t length) {
+            auto entry = store().find(_namespace + "/" + key);
+            if (entry == store().end() || entry->second.size() > length) return 0;
+            memcpy(buffer, entry->second.data(), entry->second.size());
+            return entry->second.size();
+        }
+        size_t putString(const char *key, const String &value) {
+            return putBytes(key, value.c_str(), value.length() + 1) > 0 ? value.length() : 0;
+        }
+        String getString(const char *key, const String &defaultValue = String()) {
+            auto entry = store().find(_namespace + "/" + key);
+            if (entry == store().end()) return defaultValue;
+            return String((const char *)entry->second.data());
+        }
+        bool isKey(const char *key) { return store().count(_namespace + "/" + key) > 0; }
+        bool remove(const char *key) { return store().erase(_namespace + "/" + key) > 0; }
+
+        static void clearAll() { store().clear(); }
+
+    private:
+        std::string _namespace;
+        bool _readOnly = false;
+
+        static std::map<std::string, std::vector<uint8_t>> &store() {
+            static std::map<std::string, std::vector<uint8_t>> values;
+            return values;
+        }
+};
+
+#endif // PREFERENCES_H
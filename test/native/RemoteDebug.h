@@ -0,0 +1,42 @@
+#ifndef REMOTEDEBUG_H
+#define REMOTEDEBUG_H
+
+// The native build has no telnet debug, build with -D NATIVE_DEBUG to send it to stdout instead.
+
+#include <stdint.h>
+#include <stdio.h>
+
+class RemoteDebug {
+    public:
+        static const uint8_t PROFILER = 0;
+        static const uint8_t VERBOSE = 1;
+        static const uint8_t DEBUG = 2;
+        static const uint8_t INFO = 3;
+        static const uint8_t WARNING = 4;
+        static const uint8_t ERROR = 5;
+        static const uint8_t ANY = 6;
+
+#ifdef NATIVE_DEBUG
+        bool isActive(uint8_t level) { return true; }
+#else
+        bool isActive(uint8_t level) { return false; }
+#endif
+        void println(const char *line) { puts(line); }
+};
+
+#ifdef NATIVE_DEBUG
+#define debugV(fmt, ...) printf("(V) " fmt "\n", ##__VA_ARGS__)
+#define debugD(fmt, ...) printf("(D) " fmt "\n", ##__VA_ARGS__)
+#define debugI(fmt, ...) printf("(I) " fmt "\n", ##__VA_ARGS__)
+#define debugW(fmt, ...) printf("(W) " fmt "\n", ##__VA_ARGS__)
+#define debugE(fmt, ...) printf("(E) " fmt "\n", ##__VA_ARGS__)
+#else
+// Still checks the format and arguments, but compiled out
+#define debugV(fmt, ...) do { if (0) printf(fmt, ##__VA_ARGS__); } while (0)
+#define debugD(fmt, ...) debugV(fmt, ##__VA_ARGS__)
+#define debugI(fmt, ...) debugV(fmt, ##__VA_ARGS__)
+#define debugW(fmt, ...) debugV(fmt, ##__VA_ARGS__)
+#define debugE(fmt, ...) debugV(fmt, ##__VA_ARGS__)
+#endif
+
+#endif // REMOTEDEBUG_H
@@ -0,0 +1,245 @@
+#ifndef REPLAYSERIAL_H
+#define REPLAYSERIAL_H
+
+#include <Arduino.h>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <vector>
+
+/// @brief Stand in for the spa's serial port in the native build.
+///
+/// Answers each RF command with the next of a list of captured frames (going round again at the
+/// end), and other commands with commandReply.  Replies arrive a byte at a time at the baud rate
+/// passed to begin(), on the NativeClock, after replyLatency.
+///
+/// Like the UART driver, onReceive is called from a thread of its own each time fifoSize bytes
+/// have arrived and when the line goes quiet, and bytes that arrive when the receive buffer is full
+/// are dropped and reported to onReceiveError.
+class ReplaySerial : public Stream {
+    public:
+        static ReplaySerial &instance() {
+            // Never destroyed, the event thread may still be waiting when the test exits.
+            static ReplaySerial *serial = new ReplaySerial();
+            return *serial;
+        }
+
+        /// @brief Bytes received before onReceive is called, as the ESP32's default RX FIFO threshold.
+        static const int fifoSize = 120;
+
+        /// @brief Reply (without the CR LF) to a command other than RF.  By default the value after
+        /// the ':', which is what most of the Wxx commands return.
+        std::function<String(const String &)> commandReply = [](const String &cmd) {
+            int colon = cmd.indexOf(':');
+            return colon < 0 ? cmd : cmd.substring(colon + 1);
+        };
+
+        /// @brief Time (ms) from the end of a command to the first byte of its reply.
+        unsigned long replyLatency = 20;
+
+        void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1) { _baud = baud; }
+        size_t setRxBufferSize(size_t size) { _rxBufferSize = size; return size; }
+        bool setRxTimeout(uint8_t symbols) { _rxTimeout = symbols; return true; }
+
+        void onReceive(std::function<void(void)> function, bool onlyOnTimeout = false) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _onReceive = function;
+            _onlyOnTimeout = onlyOnTimeout;
+            startEvents();
+        }
+
+        void onReceiveError(std::function<void(hardwareSerial_error_t)> function) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _onReceiveError = function;
+            startEvents();
+        }
+        size_t setTxBufferSize(size_t size) { return size; }
+
+        /// @brief Add a raw RF response to the frames replayed.
+        void addFrame(const String &frame) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _frames.push_back(frame);
+        }
+
+        /// @brief Pass the next frame through corrupt before it is sent, to test recovery from a bad read.
+        void injectCorruption(std::function<String(const String &)> corrupt) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _corrupt = corrupt;
+        }
+
+        /// @brief The corruption passed to injectCorruption() hasn't been sent yet.
+        bool corruptionPending() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return (bool)_corrupt;
+        }
+
+        /// @brief Number of RF commands answered.
+        unsigned long framesSent() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _framesSent;
+        }
+
+        /// @brief Build the RF response held in the [Strings] section of a SpaNET app snapshot
+        /// (SpaNET Debug Files/*-Snapshot.txt).
+        /// @return empty if the file can't be read or has no registers
+        static String frameFromSnapshot(const char *path) {
+            std::ifstream file(path);
+            std::string line;
+            bool strings = false;
+            std::string frame;
+
+            while (std::getline(file, line)) {
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                if (line.empty()) continue;
+                if (line[0] == '[') {
+                    strings = line == "[Strings]";
+                    continue;
+                }
+                // eg R2=,R2,84,232,...,241:  and the last registers end :*
+                size_t equals = line.find('=');
+                if (!strings || equals == std::string::npos || equals + 1 >= line.size()) continue;
+                std::string value = line.substr(equals + 1);
+                while (!value.empty() && (value.back() == '*' || value.back() == ':')) value.pop_back();
+                frame += value + ",:\r\n";
+            }
+
+            return frame.empty() ? String() : String("RF:\r\n" + frame);
+        }
+
+        int available() override {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return arrived();
+        }
+
+        int read() override {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (arrived() == 0) return -1;
+            char c = _rx.front().first;
+            _rx.pop_front();
+            return (uint8_t)c;
+        }
+
+        int peek() override {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return arrived() == 0 ? -1 : (uint8_t)_rx.front().first;
+        }
+
+        size_t write(uint8_t c) override {
+            if (c != '\n') {
+                _line += (char)c;
+                return 1;
+            }
+
+            String cmd(_line);
+            _line = "";
+            if (cmd.isEmpty()) return 1; // wake up
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (cmd == "RF") {
+                if (!_frames.empty()) {
+                    String frame = _frames[_framesSent % _frames.size()];
+                    if (_corrupt) {
+                        frame = _corrupt(frame);
+                        _corrupt = nullptr;
+                    }
+                    send(frame);
+                    _framesSent++;
+                }
+            } else {
+                send(commandReply(cmd) + "\r\n");
+            }
+            return 1;
+        }
+        using Print::write;
+
+    private:
+        std::mutex _mutex;
+        unsigned long _baud = 38400;
+        std::vector<String> _frames;
+        unsigned long _framesSent = 0;
+        std::function<String(const String &)> _corrupt;
+        size_t _rxBufferSize = 256;
+        uint8_t _rxTimeout = 2;
+
+        std::function<void(void)> _onReceive;
+        bool _onlyOnTimeout = false;
+        std::function<void(hardwareSerial_error_t)> _onReceiveError;
+        /// @brief Calls due to onReceive (UART_NO_ERROR) and onReceiveError, by the time (us) they are due.
+        std::multimap<unsigned long, hardwareSerial_error_t> _events;
+        std::condition_variable _eventsChanged;
+        bool _eventsStarted = false;
+
+        void addEvent(unsigned long time, hardwareSerial_error_t error) {
+            _events.insert(std::make_pair(time, error));
+            _eventsChanged.notify_one();
+        }
+
+        void startEvents() {
+            if (_eventsStarted) return;
+            _eventsStarted = true;
+            std::thread([this]() { runEvents(); }).detach();
+        }
+
+        void runEvents() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (true) {
+                if (_events.empty()) {
+                    _eventsChanged.wait(lock);
+                    continue;
+                }
+                unsigned long now = micros();
+                auto event = _events.begin();
+                if (event->first > now) {
+                    _eventsChanged.wait_for(lock, std::chrono::microseconds((long long)((event->first - now) / NativeClock::instance().speed())));
+                    continue;
+                }
+                hardwareSerial_error_t error = event->second;
+                _events.erase(event);
+
+                std::function<void(void)> receive = _onReceive;
+                std::function<void(hardwareSerial_error_t)> receiveError = _onReceiveError;
+                lock.unlock();
+                if (error == UART_NO_ERROR) {
+                    if (receive) receive();
+                } else if (receiveError) {
+                    receiveError(error);
+                }
+                lock.lock();
+            }
+        }
+        std::string _line;
+        /// @brief Reply bytes and the time (us) each arrives.
+        std::deque<std::pair<char, unsigned long>> _rx;
+
+        void send(const String &reply) {
+            // 10 bits per byte on the wire
+            unsigned long start = micros() + replyLatency * 1000;
+            unsigned long time = start;
+            for (unsigned int i = 0; i < reply.length(); i++) {
+                time = start + (unsigned long)(i * 10000000.0 / _baud);
+                _rx.push_back(std::make_pair(reply[i], time));
+                if (!_onlyOnTimeout && (i + 1) % fifoSize == 0) addEvent(time, UART_NO_ERROR);
+            }
+            if (reply.length() > 0) addEvent(time + (unsigned long)(_rxTimeout * 10000000.0 / _baud), UART_NO_ERROR);
+        }
+
+        int arrived() {
+            unsigned long now = micros();
+            int count = 0;
+            for (auto &byte : _rx) {
+                if (byte.second > now) break;
+                count++;
+            }
+            if ((size_t)count > _rxBufferSize) {
+                // Nowhere for the latest bytes to go
+                _rx.erase(_rx.begin() + _rxBufferSize, _rx.begin() + count);
+                count = _rxBufferSize;
+                addEvent(now, UART_BUFFER_FULL_ERROR);
+            }
+            return count;
+        }
+};
+
+#endif // REPLAYSERIAL_H
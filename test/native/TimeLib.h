@@ -0,0 +1,45 @@
+#ifndef TIMELIB_H
+#define TIMELIB_H
+
+// The parts of the Time library used by the spa interface.
+
+#include <stdint.h>
+#include <time.h>
+
+typedef struct {
+    uint8_t Second;
+    uint8_t Minute;
+    uint8_t Hour;
+    uint8_t Wday;
+    uint8_t Day;
+    uint8_t Month;
+    uint8_t Year; // offset from 1970
+} tmElements_t;
+
+#define CalendarYrToTm(Y) ((Y) - 1970)
+
+inline time_t makeTime(const tmElements_t &tm) {
+    struct tm t = {};
+    t.tm_year = tm.Year + 70;
+    t.tm_mon = tm.Month - 1;
+    t.tm_mday = tm.Day;
+    t.tm_hour = tm.Hour;
+    t.tm_min = tm.Minute;
+    t.tm_sec = tm.Second;
+    return timegm(&t);
+}
+
+inline struct tm breakTime(time_t t) {
+    struct tm result;
+    gmtime_r(&t, &result);
+    return result;
+}
+
+inline int year(time_t t) { return breakTime(t).tm_year + 1900; }
+inline int month(time_t t) { return breakTime(t).tm_mon + 1; }
+inline int day(time_t t) { return breakTime(t).tm_mday; }
+inline int hour(time_t t) { return breakTime(t).tm_hour; }
+inline int minute(time_t t) { return breakTime(t).tm_min; }
+inline int second(time_t t) { return breakTime(t).tm_sec; }
+
+#endif // TIMELIB_H
@@ -0,0 +1,113 @@
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+// FreeRTOS on top of std::thread for the native build.  Only what the spa interface uses: one
+// task per xTaskCreatePinnedToCore, task notifications, queues, binary semaphores and critical
+// sections.  Timeouts are on the NativeClock.
+
+#include <stdint.h>
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "NativeClock.h"
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define portMAX_DELAY ((TickType_t)0xffffffff)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+#ifndef ARDUINO_RUNNING_CORE
+#define ARDUINO_RUNNING_CORE 1
+#endif
+
+/// @brief Wait on cv until ready() or ticks pass on the NativeClock.
+template <typename Predicate>
+inline bool nativeWait(std::unique_lock<std::mutex> &lock, std::condition_variable &cv, TickType_t ticks, Predicate ready) {
+    if (ticks == portMAX_DELAY) {
+        cv.wait(lock, ready);
+        return true;
+    }
+    return cv.wait_for(lock, NativeClock::instance().realTime(ticks), ready);
+}
+
+struct portMUX_TYPE {
+    std::recursive_mutex mutex;
+};
+#define portMUX_INITIALIZER_UNLOCKED {}
+#define portENTER_CRITICAL(mux) (mux)->mutex.lock()
+#define portEXIT_CRITICAL(mux) (mux)->mutex.unlock()
+
+struct NativeTask {
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t notifications = 0;
+
+    static NativeTask *&current() {
+        static thread_local NativeTask *task = nullptr;
+        return task;
+    }
+};
+typedef NativeTask *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stackDepth, void *parameters,
+                                          UBaseType_t priority, TaskHandle_t *created, BaseType_t core) {
+    NativeTask *task = new NativeTask();
+    if (created != nullptr) *created = task;
+    std::thread([function, parameters, task]() {
+        NativeTask::current() = task;
+        function(parameters);
+    }).detach();
+    return pdPASS;
+}
+
+/// @brief A thread that wasn't made by xTaskCreatePinnedToCore (the test itself) gets a handle the first time it asks.
+inline TaskHandle_t xTaskGetCurrentTaskHandle() {
+    if (NativeTask::current() == nullptr) NativeTask::current() = new NativeTask();
+    return NativeTask::current();
+}
+
+// There is no stack to measure on the host.
+inline UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    return 0;
+}
+
+inline void vTaskDelay(TickType_t ticks) {
+    NativeClock::instance().sleep(ticks);
+}
+
+inline BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    std::lock_guard<std::mutex> lock(task->mutex);
+    task->notifications++;
+    task->cv.notify_one();
+    return pdPASS;
+}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    NativeTask *task = NativeTask::current();
+    std::unique_lock<std::mutex> lock(task->mutex);
+    nativeWait(lock, task->cv, ticks, [task]() { return task->notifications > 0; });
+    uint32_t value = task->notifications;
+    if (value > 0) task->notifications = clearOnExit ? 0 : value - 1;
+    return value;
+}
+
+struct NativeQueue {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::vector<uint8_t>> items;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+};
+typedef NativeQueue *QueueHandle_t;
+
+#endif // FREERTOS_H
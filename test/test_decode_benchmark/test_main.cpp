@@ -0,0 +1,162 @@
+// Benchmark of decoding a captured RF response into the properties, as updateMeasures() does, with
+// the numeric parse before and after SpaField::parseNumber().
+//
+// Run on the board with: pio test -e esp32dev -f test_decode_benchmark
+
+#include <Arduino.h>
+#include <unity.h>
+#include "SpaFrame.h"
+#include "SpaProperties.h"
+
+static const char *capturedFrame =
+    "RF:\r\n"
+    ",R2,84,232,42,199,1,13,42,31,21,5,2024,366,9999,1,0,78,341,943,233,279654,3163,3223,0,2887,0,0,19720,2178,7704,241,:\r\n"
+    ",R3,40,1,255,4,4,SW V6 19 11 12,SV3,21110001,20000337,1,0,1,0,0,0,NA,3,0,439,In use,45,0,10,10,0,0,-1,:\r\n"
+    ",R4,NORM,0,0,0,4,0,20491,4,2,19488,1113025,1036,1326,0,8388608,0,0,11,0,98,-8,0,4,80,100,0,0,4,:\r\n"
+    ",R5,1,1,1,1,0,0,0,0,0,0,0,1,1,0,366,0,28,4,0,0,0,0,1,2,3,6,:\r\n"
+    ",R6,3,1,12,1,5,6,24,380,1,0,3840,5376,127,128,3840,5632,2048,39936,0,30,0,0,2,0,2,3,0,410,:\r\n"
+    ",R7,3072,0,1,4,1,0,2,22,9,2021,251,199,248,222,482,125,77,3,0,0,0,23,200,1,0,1,31,50,50,100,5,:\r\n"
+    ",R9,F1,13567,2581,6,96,215,9999,356,38,0,255,52584,:\r\n"
+    ",RA,F2,23429,2077,6,0,212,9999,255,31,0,255,340,:\r\n"
+    ",RB,F3,0,0,0,0,0,0,0,0,0,0,0,:\r\n"
+    ",RC,0,1,0,0,0,0,0,0,0,2,0,0,1,0,:\r\n"
+    ",RE,1,10,0,0,0,0,200,200,200,14,-4,1,1,0,0,3,1,0,53,0,0,240,0,0,-4,13,30,8,5,1,:\r\n"
+    ",RG,1,1,1,1,1,1,1-1-014,1-1-01,1-1-01,1-1-01,0-,0,0,0,3367,:\r\n";
+
+static const int iterations = 200;
+
+static const char *registerNames[SpaProperties::numRegisters] = {
+    "R2", "R3", "R4", "R5", "R6", "R7", "R9", "RA", "RB", "RC", "RE", "RG"
+};
+
+static SpaFrame frame;
+static int registerStart[SpaProperties::numRegisters];
+
+/// @brief The numeric parse used before SpaField::parseNumber(), a validating scan and then atol().
+static bool parseBefore(SpaField s, long &value) {
+    if (s.isEmpty()) {
+        return false;
+    }
+    for (int i = 0; i < s.length; i++) {
+        if (!isDigit(s[i]) && s[i] != '-' && s[i] != '.') {
+            return false;
+        }
+    }
+    value = s.toInt();
+    return true;
+}
+
+/// @brief Properties decoded from the frame, every row of fieldMap, as updateMeasures() does for a
+/// frame in which every register has changed.
+class DecodeBench : public SpaProperties {
+    public:
+        void decodeAfter() {
+            for (int i = 0; i < fieldMapSize; i++) {
+                const FieldDescriptor &field = fieldMap[i];
+                updateField(field, frame, registerStart[field.reg] + field.offset);
+            }
+        }
+
+        /// @brief The same, with the numeric fields parsed as they were before.
+        void decodeBefore() {
+            for (int i = 0; i < fieldMapSize; i++) {
+                const FieldDescriptor &field = fieldMap[i];
+                int index = registerStart[field.reg] + field.offset;
+                long number;
+                switch (field.type) {
+                    case FieldDescriptor::INT:
+                        if (parseBefore(frame.field(index), number)) updateValue(field, this->*field.member.i, (int)(number / field.scale));
+                        break;
+                    case FieldDescriptor::NUMBER_BOOL:
+                        if (parseBefore(frame.field(index), number)) updateValue(field, this->*field.member.b, number != 0);
+                        break;
+                    default:
+                        updateField(field, frame, index);
+                }
+            }
+        }
+};
+
+static DecodeBench before, after;
+
+static void loadFrame() {
+    frame.clear();
+    size_t length = 0;
+    for (const char *c = capturedFrame; *c != '\0'; c++) {
+        if (*c == ',') {
+            frame.addField(length);
+            length = 0;
+        } else {
+            frame.tail()[length++] = *c;
+        }
+    }
+
+    for (int r = 0; r < SpaProperties::numRegisters; r++) {
+        registerStart[r] = -1;
+        for (int f = 0; f < frame.fieldCount() && registerStart[r] < 0; f++) {
+            if (frame.field(f).equals(registerNames[r])) registerStart[r] = f;
+        }
+    }
+}
+
+static unsigned long timeDecode(DecodeBench &properties, void (DecodeBench::*decode)()) {
+    unsigned long start = micros();
+    for (int i = 0; i < iterations; i++) {
+        (properties.*decode)();
+    }
+    return micros() - start;
+}
+
+void test_registers_found() {
+    for (int r = 0; r < SpaProperties::numRegisters; r++) {
+        TEST_ASSERT_TRUE_MESSAGE(registerStart[r] >= 0, registerNames[r]);
+    }
+}
+
+void test_same_fields_accepted() {
+    for (int i = 0; i < SpaProperties::fieldMapSize; i++) {
+        const SpaProperties::FieldDescriptor &field = SpaProperties::fieldMap[i];
+        if (field.type != SpaProperties::FieldDescriptor::INT && field.type != SpaProperties::FieldDescriptor::NUMBER_BOOL) continue;
+
+        SpaField s = frame.field(registerStart[field.reg] + field.offset);
+        long valueBefore = 0, valueAfter = 0;
+        bool okBefore = parseBefore(s, valueBefore);
+        bool okAfter = s.parseNumber(valueAfter, field.scale);
+        TEST_ASSERT_EQUAL_MESSAGE(okBefore, okAfter, field.name);
+        if (okBefore) TEST_ASSERT_EQUAL_MESSAGE(valueBefore / field.scale, valueAfter, field.name);
+    }
+}
+
+void test_same_values() {
+    before.decodeBefore();
+    after.decodeAfter();
+    for (int i = 0; i < SpaProperties::fieldMapSize; i++) {
+        const SpaProperties::FieldDescriptor &field = SpaProperties::fieldMap[i];
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(before.fieldText(field).c_str(), after.fieldText(field).c_str(), field.name);
+    }
+}
+
+void test_decode_speed() {
+    unsigned long timeBefore = timeDecode(before, &DecodeBench::decodeBefore);
+    unsigned long timeAfter = timeDecode(after, &DecodeBench::decodeAfter);
+
+    char message[128];
+    snprintf(message, sizeof(message), "%i properties x %i frames: before %lu us, after %lu us (%lu us/frame)",
+        SpaProperties::fieldMapSize, iterations, timeBefore, timeAfter, timeAfter / iterations);
+    TEST_MESSAGE(message);
+}
+
+void setup() {
+    delay(2000); // Wait for the serial monitor to connect
+    loadFrame();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_registers_found);
+    RUN_TEST(test_same_fields_accepted);
+    RUN_TEST(test_same_values);
+    RUN_TEST(test_decode_speed);
+    UNITY_END();
+}
+
+void loop() {
+}
@@ -0,0 +1,591 @@
+// Replays the captured RF responses in "SpaNET Debug Files" through SpaInterface on the host, at
+// the spa's baud rate on an accelerated clock.
+//
+// Run with: pio test -e native
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <dirent.h>
+#include <unity.h>
+#include <ReplaySerial.h>
+#include <Preferences.h>
+#include "SpaInterface.h"
+
+static const char *snapshotDir = "SpaNET Debug Files";
+
+/// @brief How many times faster than real time the replay runs.
+static const double replaySpeed = 100;
+
+/// @brief Number of frames replayed for the throughput test.
+static const int throughputFrames = 50;
+
+RemoteDebug Debug;
+
+static SpaInterface *si;
+static std::vector<String> frames;
+static volatile int updates = 0;
+
+static void countUpdate() {
+    updates++;
+}
+
+/// @brief Run the network side until updates reaches count, or timeout (ms on the NativeClock).
+static bool waitForUpdates(int count, unsigned long timeout) {
+    unsigned long start = millis();
+    while (updates < count) {
+        if (millis() - start > timeout) return false;
+        si->loop();
+        delay(1);
+    }
+    return true;
+}
+
+static void loadSnapshots() {
+    DIR *dir = opendir(snapshotDir);
+    if (dir == nullptr) return;
+
+    while (struct dirent *entry = readdir(dir)) {
+        String name(entry->d_name);
+        if (!name.endsWith("-Snapshot.txt")) continue;
+
+        String frame = ReplaySerial::frameFromSnapshot((String(snapshotDir) + "/" + name).c_str());
+        if (!frame.isEmpty()) frames.push_back(frame);
+    }
+    closedir(dir);
+}
+
+void test_snapshots_convert() {
+    TEST_ASSERT_TRUE_MESSAGE(frames.size() > 0, "No snapshots found, run from the project directory");
+    for (const String &frame : frames) {
+        TEST_ASSERT_TRUE(frame.startsWith("RF:\r\n,R2,"));
+        TEST_ASSERT_TRUE(frame.indexOf("\r\n,RG,") > 0);
+        TEST_ASSERT_TRUE(frame.endsWith(",:\r\n"));
+    }
+}
+
+void test_first_frame_decodes() {
+    TEST_ASSERT_TRUE(waitForUpdates(1, 60000));
+    TEST_ASSERT_TRUE(si->isInitialised());
+    TEST_ASSERT_TRUE(si->getStatusResponse()[0] == 'R');
+
+    // Values from SpaNET-68-27-19-dd-40-6a-1716263001-Snapshot.txt, the first in the corpus
+    if (frames[0].indexOf(",R2,84,232,42,199,") > 0) {
+        TEST_ASSERT_EQUAL(84, si->getMainsCurrent());
+        TEST_ASSERT_EQUAL(232, si->getMainsVoltage());
+        TEST_ASSERT_EQUAL(366, si->getWTMP());
+        TEST_ASSERT_EQUAL(380, si->getSTMP());
+        TEST_ASSERT_EQUAL_STRING("SW V6 19 11 12", si->getSVER());
+        TEST_ASSERT_EQUAL_STRING("NORM", si->spaModeStrings[si->getMode()]);
+        TEST_ASSERT_EQUAL_STRING("In use", si->getStatus());
+    }
+}
+
+void test_replay_throughput() {
+    int start = updates;
+    unsigned long realStart = micros() / replaySpeed;
+    unsigned long loopMax = si->getLoopTimeMax();
+
+    TEST_ASSERT_TRUE(waitForUpdates(start + throughputFrames, (unsigned long)throughputFrames * 20000));
+
+    double realSeconds = (micros() / replaySpeed - realStart) / 1000000.0;
+    char message[200];
+    snprintf(message, sizeof(message), "%i frames in %.2f s real time, last read %lu ms over %i steps at 38400 baud, longest loop() %lu us (clock x%.0f)",
+        throughputFrames, realSeconds, si->getStatusReadDuration(), si->getStatusReadSteps(),
+        (unsigned long)(si->getLoopTimeMax() / replaySpeed), replaySpeed);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(si->getLoopTimeMax() >= loopMax);
+}
+
+/// @brief Send the next frame through corrupt, and wait for the update that follows it.
+/// @param framesSent set to the number of RF commands answered when that update arrived
+/// @return false if there was no update
+static bool updateAfterCorruption(std::function<String(const String &)> corrupt, unsigned long &framesSent) {
+    ReplaySerial &serial = ReplaySerial::instance();
+    serial.injectCorruption(corrupt);
+    while (serial.corruptionPending()) {
+        si->loop();
+        delay(1);
+    }
+
+    unsigned long sent = serial.framesSent();
+    bool updated = waitForUpdates(updates + 1, 60000);
+    // Nothing more can have been sent unless the corrupt frame was thrown away.
+    framesSent = serial.framesSent() - sent;
+    return updated;
+}
+
+void test_resync_noise_before_header() {
+    const LinkHealth &link = si->getLinkHealth();
+    uint32_t resync = link.resyncBytes();
+    unsigned long retries;
+
+    TEST_ASSERT_TRUE(updateAfterCorruption([](const String &frame) { return String("\x7f" "12,x") + frame; }, retries));
+    TEST_ASSERT_EQUAL(0, retries);
+    TEST_ASSERT_EQUAL(5, link.resyncBytes() - resync);
+}
+
+void test_resync_damaged_register() {
+    const LinkHealth &link = si->getLinkHealth();
+    uint32_t repaired = link.framesRepaired();
+    int current = si->getMainsCurrent();
+    unsigned long retries;
+
+    // Lose the mains current from R2, it keeps its value and the rest of the frame is still used.
+    TEST_ASSERT_TRUE(updateAfterCorruption([](const String &frame) {
+        int start = frame.indexOf(",R2,") + 4;
+        return frame.substring(0, start) + frame.substring(frame.indexOf(',', start));
+    }, retries));
+    TEST_ASSERT_EQUAL(0, retries);
+    TEST_ASSERT_EQUAL(1, link.framesRepaired() - repaired);
+    TEST_ASSERT_EQUAL(current, si->getMainsCurrent());
+}
+
+void test_time_to_valid_after_truncation() {
+    const LinkHealth &link = si->getLinkHealth();
+    unsigned long retries;
+
+    // Cut off half way, which can only be recovered by asking again.
+    TEST_ASSERT_TRUE(updateAfterCorruption([](const String &frame) { return frame.substring(0, frame.length() / 2); }, retries));
+    TEST_ASSERT_EQUAL(1, retries);
+
+    char message[100];
+    snprintf(message, sizeof(message), "Valid again %u ms after the start of the truncated read", link.lastRecoveryTime());
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(link.lastRecoveryTime() <= FAILEDREADFREQUENCY * 2);
+}
+
+void test_rx_overflow_counted() {
+    const LinkHealth &link = si->getLinkHealth();
+    ReplaySerial &serial = ReplaySerial::instance();
+    uint32_t overflows = link.rxOverflows();
+
+    // Smaller than the receive FIFO, so it fills before the bus task is woken.
+    serial.setRxBufferSize(64);
+    unsigned long start = millis();
+    while (link.rxOverflows() == overflows && millis() - start < 10000) {
+        si->loop();
+        delay(1);
+    }
+    serial.setRxBufferSize(SpaFrame::maxLength);
+
+    TEST_ASSERT_TRUE(link.rxOverflows() > overflows);
+}
+
+void test_layout_saved() {
+    const RegisterLayout &layout = si->getRegisterLayout();
+    TEST_ASSERT_TRUE(layout.isValid());
+    TEST_ASSERT_FALSE(layout.isStored());
+
+    // What the next boot would load
+    RegisterLayout stored(layout);
+    TEST_ASSERT_TRUE(stored.load());
+    TEST_ASSERT_TRUE(stored.isStored());
+    TEST_ASSERT_EQUAL_STRING(layout.firmware(), stored.firmware());
+    TEST_ASSERT_EQUAL_STRING(layout.model(), stored.model());
+    TEST_ASSERT_EQUAL_INT_ARRAY(layout.starts(), stored.starts(), SpaInterface::numRegisters);
+}
+
+void test_layout_drift_rejected() {
+    unsigned long mismatches = si->getLayoutMismatches();
+    int current = si->getMainsCurrent();
+    unsigned long retries;
+
+    // An extra field in R2 moves every register after it, which the bus task can't see.
+    TEST_ASSERT_TRUE(updateAfterCorruption([](const String &frame) {
+        int start = frame.indexOf(",R2,") + 4;
+        return frame.substring(0, start) + "999," + frame.substring(start);
+    }, retries));
+    TEST_ASSERT_EQUAL(1, retries);
+    TEST_ASSERT_EQUAL(1, si->getLayoutMismatches() - mismatches);
+    TEST_ASSERT_EQUAL(current, si->getMainsCurrent());
+}
+
+static int fineCurrent = -1, coarseCurrent = -1;
+
+/// @brief Change the mains current (the first field of R2) in a frame by step.
+static std::function<String(const String &)> addMainsCurrent(int step) {
+    return [step](const String &frame) {
+        int start = frame.indexOf(",R2,") + 4;
+        return frame.substring(0, start) + String(frame.substring(start).toInt() + step) + frame.substring(frame.indexOf(',', start));
+    };
+}
+
+void test_subscribers_filter() {
+    PropertySubscription<int> fine([](const int &value, void *) { fineCurrent = value; });
+    PropertySubscription<int> coarse([](const int &value, void *) { coarseCurrent = value; }, nullptr, 20);
+    TEST_ASSERT_TRUE(si->subscribe("MainsCurrent", fine));
+    TEST_ASSERT_TRUE(si->subscribe("MainsCurrent", coarse));
+    TEST_ASSERT_FALSE(si->subscribe("NoSuchProperty", fine));
+
+    // Both are told the value the first time the register is decoded.
+    int current = si->getMainsCurrent();
+    unsigned long retries;
+    TEST_ASSERT_TRUE(updateAfterCorruption(addMainsCurrent(10), retries));
+    TEST_ASSERT_EQUAL(current + 10, fineCurrent);
+    TEST_ASSERT_EQUAL(current + 10, coarseCurrent);
+
+    // Back by 1 A is inside the coarse subscriber's deadband.
+    TEST_ASSERT_TRUE(waitForUpdates(updates + 1, 60000));
+    TEST_ASSERT_EQUAL(current, fineCurrent);
+    TEST_ASSERT_EQUAL(current + 10, coarseCurrent);
+    TEST_ASSERT_EQUAL(1, coarse.suppressed());
+
+    si->unsubscribe("MainsCurrent", fine);
+    si->unsubscribe("MainsCurrent", coarse);
+}
+
+void test_deadband_suppresses_jitter() {
+    const PropertyDeadband *deadband = nullptr;
+    for (int i = 0; i < si->getDeadbandCount(); i++) {
+        if (strcmp(si->getDeadband(i).name(), "MainsCurrent") == 0) deadband = &si->getDeadband(i);
+    }
+    TEST_ASSERT_TRUE(deadband != nullptr);
+
+    PropertySubscription<int> watcher([](const int &value, void *) { fineCurrent = value; });
+    si->subscribe("MainsCurrent", watcher);
+    int current = si->getMainsCurrent();
+    unsigned long retries;
+    TEST_ASSERT_TRUE(updateAfterCorruption(addMainsCurrent(0), retries));
+    TEST_ASSERT_EQUAL(current, fineCurrent);
+
+    // 0.1 A is inside the default deadband, the value is still the latest but no one is told.
+    unsigned long suppressed = deadband->suppressed();
+    fineCurrent = -1;
+    TEST_ASSERT_TRUE(updateAfterCorruption(addMainsCurrent(1), retries));
+    TEST_ASSERT_EQUAL(current + 1, si->getMainsCurrent());
+    TEST_ASSERT_EQUAL(-1, fineCurrent);
+    TEST_ASSERT_EQUAL(1, deadband->suppressed() - suppressed);
+
+    si->unsubscribe("MainsCurrent", watcher);
+}
+
+void test_changed_since() {
+    int mainsCurrent = -1;
+    for (int i = 0; i < SpaProperties::fieldMapSize; i++) {
+        if (strcmp(SpaProperties::fieldMap[i].name, "MainsCurrent") == 0) mainsCurrent = i;
+    }
+
+    uint32_t generation = si->getGeneration();
+    unsigned long retries;
+    TEST_ASSERT_TRUE(updateAfterCorruption(addMainsCurrent(5), retries));
+    TEST_ASSERT_TRUE(si->getGeneration() > generation);
+
+    uint16_t rows[SpaProperties::fieldMapSize];
+    int count = si->changedSince(generation, rows, SpaProperties::fieldMapSize);
+    TEST_ASSERT_TRUE(count > 0);
+    TEST_ASSERT_TRUE(std::find(rows, rows + count, mainsCurrent) != rows + count);
+    TEST_ASSERT_EQUAL(0, si->changedSince(si->getGeneration(), rows, SpaProperties::fieldMapSize));
+
+    // Real time, the NativeClock is accelerated
+    const int queries = 10000;
+    auto start = std::chrono::steady_clock::now();
+    volatile int found = 0;
+    for (int i = 0; i < queries; i++) found += si->changedSince(generation, rows, SpaProperties::fieldMapSize);
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / queries;
+
+    char message[200];
+    snprintf(message, sizeof(message), "%i of %i properties changed in one frame, changedSince() takes %.0f ns (host), store is %u bytes",
+        count, SpaProperties::fieldMapSize, ns, (unsigned)sizeof(SpaProperties));
+    TEST_MESSAGE(message);
+}
+
+void test_readers_consistent() {
+    // A reader on another thread, as the web or MQTT side would be if decoding were on the other core.
+    // However slowly it reads, it must never see a frame land in the middle.
+    std::atomic<bool> stop(false);
+    std::atomic<int> reads(0), torn(0);
+    std::thread reader([&]() {
+        while (!stop) {
+            uint32_t before, after;
+            si->readConsistent([&]() {
+                before = si->getGeneration();
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                after = si->getGeneration();
+            });
+            if (before != after) torn++;
+            reads++;
+        }
+    });
+
+    unsigned long retries = si->getReadRetries(), framesSent;
+    for (int i = 0; i < 10; i++) TEST_ASSERT_TRUE(updateAfterCorruption(addMainsCurrent(i % 2 ? 5 : -5), framesSent));
+    stop = true;
+    reader.join();
+
+    char message[120];
+    snprintf(message, sizeof(message), "%i consistent reads over 10 frames, %lu run again", reads.load(), si->getReadRetries() - retries);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(reads > 0);
+    TEST_ASSERT_EQUAL(0, torn.load());
+}
+
+void test_fields_by_name() {
+    for (int i = 0; i < SpaProperties::fieldMapSize; i++) {
+        TEST_ASSERT_TRUE(SpaProperties::findField(SpaProperties::fieldMap[i].name) == &SpaProperties::fieldMap[i]);
+    }
+    TEST_ASSERT_TRUE(SpaProperties::findField("NoSuchProperty") == nullptr);
+    TEST_ASSERT_TRUE(SpaProperties::findField("") == nullptr);
+
+    TEST_ASSERT_EQUAL_STRING(String(si->getSTMP()).c_str(), si->fieldText(*SpaProperties::findField("STMP")).c_str());
+    TEST_ASSERT_EQUAL_STRING(si->getSVER(), si->fieldText(*SpaProperties::findField("SVER")).c_str());
+
+    // Nothing is queued for a name that isn't there, a property that can't be set, or a bad value.
+    TEST_ASSERT_TRUE(si->isSettable("STMP"));
+    TEST_ASSERT_FALSE(si->isSettable("MainsCurrent"));
+    TEST_ASSERT_FALSE(si->setField("NoSuchProperty", "1"));
+    TEST_ASSERT_FALSE(si->setField("MainsCurrent", "10"));
+    TEST_ASSERT_FALSE(si->setField("STMP", "warm"));
+    TEST_ASSERT_FALSE(si->setField("Mode", "HOLIDAY"));
+    TEST_ASSERT_FALSE(si->setField("Mode", "9"));
+    TEST_ASSERT_FALSE(si->setField("RB_TP_Light", "7"));
+    TEST_ASSERT_FALSE(si->setField("HELE", "yes"));
+    TEST_ASSERT_FALSE(si->setMode(4));
+    TEST_ASSERT_FALSE(si->setMode(-1));
+    TEST_ASSERT_FALSE(si->setHPMP(4));
+    TEST_ASSERT_EQUAL(0, si->getQueuedCommands());
+}
+
+static int modeNotifications = 0;
+
+/// @brief Change the mode (the first field of R4) in a frame to name.
+static std::function<String(const String &)> replaceMode(const char *name) {
+    return [name](const String &frame) {
+        int start = frame.indexOf(",R4,") + 4;
+        return frame.substring(0, start) + name + frame.substring(frame.indexOf(',', start));
+    };
+}
+
+void test_unknown_modes_kept() {
+    static PropertySubscription<int> mode([](const int &, void *) { modeNotifications++; });
+    TEST_ASSERT_TRUE(si->subscribe("Mode", mode));
+    unsigned long retries;
+
+    // A mode we have no name for is shown as the spa sent it, rather than leaving the last one showing.
+    TEST_ASSERT_TRUE(updateAfterCorruption([](const String &frame) {
+        String changed = replaceMode("HOLD")(frame);
+        // HPMP is field 26 of R7
+        int field = changed.indexOf(",R7,") + 1;
+        for (int i = 0; i < 26; i++) field = changed.indexOf(',', field) + 1;
+        return changed.substring(0, field) + "7" + changed.substring(changed.indexOf(',', field));
+    }, retries));
+    TEST_ASSERT_EQUAL_STRING("HOLD", si->getModeName().c_str());
+    TEST_ASSERT_EQUAL(7, si->getHPMP());
+    TEST_ASSERT_EQUAL_STRING("7", si->getHPMPName().c_str());
+
+    // Another unknown mode is the same value, but subscribers are still told, so they show the new text
+    int notifications = modeNotifications;
+    TEST_ASSERT_TRUE(updateAfterCorruption(replaceMode("VAC"), retries));
+    TEST_ASSERT_EQUAL_STRING("VAC", si->getModeName().c_str());
+    TEST_ASSERT_EQUAL(notifications + 1, modeNotifications);
+
+    TEST_ASSERT_TRUE(waitForUpdates(updates + 1, 60000));
+    TEST_ASSERT_EQUAL_STRING(SpaProperties::spaModeName(si->getMode()), si->getModeName().c_str());
+    TEST_ASSERT_EQUAL_STRING(SpaProperties::HPMPName(si->getHPMP()), si->getHPMPName().c_str());
+    si->unsubscribe("Mode", mode);
+}
+
+void test_wake_gap_recovers() {
+    CommandTiming timing("test");
+
+    // Learnt down from the conservative gap, one step per successesPerStep
+    for (int i = 0; i < 1 + 10 * CommandTiming::successesPerStep; i++) timing.success(20);
+    int learnt = timing.wakeGap();
+    TEST_ASSERT_TRUE(learnt < CommandTiming::conservativeWakeGap);
+
+    // A missing reply goes back to the conservative gap, then to just above the one that failed
+    timing.failure();
+    TEST_ASSERT_EQUAL(CommandTiming::conservativeWakeGap, timing.wakeGap());
+    for (int i = 0; i < CommandTiming::successesToRetryGap - 1; i++) timing.success(20);
+    TEST_ASSERT_EQUAL(learnt + CommandTiming::wakeGapStep, timing.wakeGap());
+
+    // After a long run of successes the gap that failed is tried again
+    for (int i = 0; i < CommandTiming::successesPerStep + 1; i++) timing.success(20);
+    TEST_ASSERT_EQUAL(learnt, timing.wakeGap());
+    TEST_ASSERT_EQUAL(1, timing.failures());
+}
+
+static PropertyHistory history;
+
+void test_history_tiers() {
+    const time_t start = 1700000000;
+    int values[PropertyHistory::numSeries] = { 0, 380, 36000, 240, 84 };
+    TEST_ASSERT_TRUE(history.begin());
+
+    // 30 minutes of WTMP 0.0, 0.1, ... 'C, with the 20th minute missing
+    for (int minute = 0; minute < 30; minute++) {
+        unsigned long ms = minute * 60000UL;
+        TEST_ASSERT_TRUE(history.due(ms));
+        values[PropertyHistory::WTMP] = minute;
+        history.record(ms, start + minute * 60, minute == 20 ? nullptr : values);
+        TEST_ASSERT_FALSE(history.due(ms + 1000));
+    }
+
+    TEST_ASSERT_EQUAL(30, history.count(0));
+    TEST_ASSERT_EQUAL(2, history.count(1));
+    TEST_ASSERT_EQUAL(0, history.count(2));
+    TEST_ASSERT_EQUAL(29, history.value(PropertyHistory::WTMP, 0, 0));
+    TEST_ASSERT_EQUAL(PropertyHistory::noValue, history.value(PropertyHistory::WTMP, 0, 9));
+    TEST_ASSERT_EQUAL(start + 29 * 60, history.time(0, 0));
+    TEST_ASSERT_EQUAL(start, history.time(0, 29));
+
+    // Each 15 minute point is the mean of its minutes, leaving out the missing one
+    TEST_ASSERT_EQUAL(7, history.value(PropertyHistory::WTMP, 1, 1));
+    TEST_ASSERT_EQUAL(22, history.value(PropertyHistory::WTMP, 1, 0));     // 310 / 14, rounded
+    TEST_ASSERT_EQUAL(start + 15 * 60, history.time(1, 0));
+
+    // Power is held * 10, stored in W so it fits
+    TEST_ASSERT_EQUAL(3600, history.value(PropertyHistory::POWER, 0, 0));
+
+    TEST_ASSERT_EQUAL(0, history.tierFor(start + 60));
+    TEST_ASSERT_EQUAL(PropertyHistory::numTiers - 1, history.tierFor(start - 3600));
+
+    // A full day of minutes wraps the first tier, the oldest are dropped
+    for (int minute = 30; minute < 30 + history.capacity(0); minute++) {
+        values[PropertyHistory::WTMP] = minute;
+        history.record(minute * 60000UL, start + minute * 60, values);
+    }
+    TEST_ASSERT_EQUAL(history.capacity(0), history.count(0));
+    TEST_ASSERT_EQUAL(29 + history.capacity(0), history.value(PropertyHistory::WTMP, 0, 0));
+    TEST_ASSERT_EQUAL(30, history.value(PropertyHistory::WTMP, 0, history.capacity(0) - 1));
+    TEST_ASSERT_TRUE(history.count(2) > 0);
+
+    char message[120];
+    snprintf(message, sizeof(message), "History %u bytes, %i/%i/%i points", (unsigned)history.bytes(),
+        history.capacity(0), history.capacity(1), history.capacity(2));
+    TEST_MESSAGE(message);
+}
+
+void test_history_gaps() {
+    PropertyHistory gaps;
+    const time_t start = 1700000000;
+    int values[PropertyHistory::numSeries] = { 0, 380, 36000, 240, 84 };
+
+    // Nothing is recorded until there is memory for it
+    gaps.record(0, start, values);
+    TEST_ASSERT_EQUAL(0, gaps.count(0));
+    TEST_ASSERT_TRUE(gaps.begin());
+
+    // Minutes 0 to 9, then nothing until 15, so 10 to 14 have no value and 9 keeps its time
+    for (int minute = 0; minute < 10; minute++) {
+        values[PropertyHistory::WTMP] = minute;
+        gaps.record(minute * 60000UL, start + minute * 60, values);
+    }
+    values[PropertyHistory::WTMP] = 15;
+    gaps.record(15 * 60000UL, start + 15 * 60, values);
+    TEST_ASSERT_EQUAL(16, gaps.count(0));
+    TEST_ASSERT_EQUAL(15, gaps.value(PropertyHistory::WTMP, 0, 0));
+    TEST_ASSERT_EQUAL(PropertyHistory::noValue, gaps.value(PropertyHistory::WTMP, 0, 1));
+    TEST_ASSERT_EQUAL(PropertyHistory::noValue, gaps.value(PropertyHistory::WTMP, 0, 5));
+    TEST_ASSERT_EQUAL(9, gaps.value(PropertyHistory::WTMP, 0, 6));
+    TEST_ASSERT_EQUAL(start + 9 * 60, gaps.time(0, 6));
+
+    // The first 15 minute point was closed at the gap, and is still the average of the minutes it had
+    TEST_ASSERT_EQUAL(1, gaps.count(1));
+    TEST_ASSERT_EQUAL(5, gaps.value(PropertyHistory::WTMP, 1, 0));     // 45 / 10, rounded
+    TEST_ASSERT_EQUAL(start, gaps.time(1, 0));
+
+    // The clock is put back 3 minutes: 13 to 15 are replaced by the new point
+    values[PropertyHistory::WTMP] = 16;
+    gaps.record(16 * 60000UL, start + 13 * 60, values);
+    TEST_ASSERT_EQUAL(14, gaps.count(0));
+    TEST_ASSERT_EQUAL(16, gaps.value(PropertyHistory::WTMP, 0, 0));
+    TEST_ASSERT_EQUAL(start + 13 * 60, gaps.time(0, 0));
+    TEST_ASSERT_EQUAL(9, gaps.value(PropertyHistory::WTMP, 0, 4));
+    TEST_ASSERT_EQUAL(start + 9 * 60, gaps.time(0, 4));
+
+    // Three days later, the finer tiers hold nothing from before, and the hourly points in between have no value
+    const time_t later = start + 3 * 24 * 3600;
+    gaps.record(17 * 60000UL, later, values);
+    TEST_ASSERT_EQUAL(gaps.capacity(0), gaps.count(0));
+    TEST_ASSERT_EQUAL(16, gaps.value(PropertyHistory::WTMP, 0, 0));
+    TEST_ASSERT_EQUAL(PropertyHistory::noValue, gaps.value(PropertyHistory::WTMP, 0, 1));
+    TEST_ASSERT_EQUAL(later, gaps.time(0, 0));
+    TEST_ASSERT_EQUAL(11, gaps.value(PropertyHistory::WTMP, 2, gaps.count(2) - 1));     // the 15 minute points 5 and 16
+    TEST_ASSERT_EQUAL(start, gaps.time(2, gaps.count(2) - 1));
+    TEST_ASSERT_EQUAL(PropertyHistory::noValue, gaps.value(PropertyHistory::WTMP, 2, 0));
+    TEST_ASSERT_TRUE(gaps.time(2, 0) > later - 2 * 3600 && gaps.time(2, 0) <= later);
+}
+
+static EnergyMeter energy;
+
+void test_energy_totals() {
+    Preferences::clearAll();
+    TEST_ASSERT_FALSE(energy.load());
+
+    const time_t monday = 1699833600;    // 00:00 13 Nov 2023
+    const time_t start = monday + 20 * 3600;
+
+    // Frames every 10 seconds from 20:00: an hour of the heater at 1000 W, half an hour of pumps at 200 W,
+    // 20 minutes unread, then 100 W until 01:00.  Saved after each, as processStatusFrame() does.
+    auto frame = [](int s, int power, EnergyMeter::Load load) {
+        energy.add(s * 1000UL, start + s, power, load);
+        energy.saveIfDue(s * 1000UL);
+    };
+    for (int s = 0; s < 3600; s += 10) frame(s, 10000, EnergyMeter::HEATER);
+    for (int s = 3600; s <= 5400; s += 10) frame(s, 2000, EnergyMeter::PUMPS);
+    for (int s = 6600; s <= 18000; s += 10) frame(s, 1000, EnergyMeter::OTHER);
+
+    TEST_ASSERT_EQUAL(2, energy.rollupCount(EnergyMeter::DAY));
+    const EnergyMeter::Rollup *yesterday = energy.rollup(EnergyMeter::DAY, 1);
+    TEST_ASSERT_EQUAL_UINT32(monday, yesterday->start);
+    TEST_ASSERT_EQUAL_UINT32(1000, yesterday->wh[EnergyMeter::HEATER]);
+    TEST_ASSERT_EQUAL_UINT32(100, yesterday->wh[EnergyMeter::PUMPS]);
+    TEST_ASSERT_EQUAL_UINT32(216, yesterday->wh[EnergyMeter::OTHER]);     // 7790 s before midnight
+    TEST_ASSERT_EQUAL_UINT32(monday + 86400, energy.rollup(EnergyMeter::DAY, 0)->start);
+    TEST_ASSERT_EQUAL_UINT32(100, energy.rollup(EnergyMeter::DAY, 0)->wh[EnergyMeter::OTHER]);
+    TEST_ASSERT_NULL(energy.rollup(EnergyMeter::DAY, 2));
+
+    TEST_ASSERT_EQUAL(1, energy.rollupCount(EnergyMeter::WEEK));
+    TEST_ASSERT_EQUAL_UINT32(monday, energy.rollup(EnergyMeter::WEEK, 0)->start);
+    TEST_ASSERT_EQUAL_UINT32(1416, energy.rollup(EnergyMeter::WEEK, 0)->total());
+    TEST_ASSERT_EQUAL_UINT32(1698796800, energy.rollup(EnergyMeter::MONTH, 0)->start);     // 1 Nov
+    TEST_ASSERT_EQUAL_UINT32(316, energy.lifetime(EnergyMeter::OTHER));
+
+    // Saved in batches, not every Wh
+    TEST_ASSERT_TRUE(energy.saves() > 0);
+    TEST_ASSERT_TRUE(energy.saves() <= 18000 / (ENERGY_SAVE_MINUTES * 60));
+
+    // What the next boot would load, up to the last save
+    EnergyMeter reloaded;
+    TEST_ASSERT_TRUE(reloaded.load());
+    TEST_ASSERT_EQUAL_UINT32(1000, reloaded.lifetime(EnergyMeter::HEATER));
+    TEST_ASSERT_EQUAL_MEMORY(yesterday, reloaded.rollup(EnergyMeter::DAY, 1), sizeof(EnergyMeter::Rollup));
+}
+
+int main(int argc, char **argv) {
+    loadSnapshots();
+
+    NativeClock::instance().setSpeed(replaySpeed);
+    for (const String &frame : frames) ReplaySerial::instance().addFrame(frame);
+
+    si = new SpaInterface();
+    si->setUpdateFrequency(1);
+    si->setUpdateCallback(countUpdate);
+    si->begin();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_snapshots_convert);
+    RUN_TEST(test_wake_gap_recovers);
+    RUN_TEST(test_history_tiers);
+    RUN_TEST(test_history_gaps);
+    RUN_TEST(test_energy_totals);
+    if (!frames.empty()) {
+        RUN_TEST(test_first_frame_decodes);
+        RUN_TEST(test_replay_throughput);
+        RUN_TEST(test_layout_saved);
+        RUN_TEST(test_layout_drift_rejected);
+        RUN_TEST(test_subscribers_filter);
+        RUN_TEST(test_deadband_suppresses_jitter);
+        RUN_TEST(test_changed_since);
+        RUN_TEST(test_readers_consistent);
+        RUN_TEST(test_fields_by_name);
+        RUN_TEST(test_unknown_modes_kept);
+        RUN_TEST(test_resync_noise_before_header);
+        RUN_TEST(test_resync_damaged_register);
+        RUN_TEST(test_time_to_valid_after_truncation);
+        RUN_TEST(test_rx_overflow_counted);
+    }
+    return UNITY_END();
+}